@@ -55,10 +55,60 @@ void Mixer::DoState(PointerWrap& p)
     mixer.DoState(p);
 }
 
+const Mixer::SincFilters& Mixer::GetSincFilters()
+{
+  static const SincFilters filters = [] {
+    // Leave some room below the Nyquist frequency of the input for the transition band.
+    constexpr double CUTOFF = 0.9;
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double HALF_WIDTH = SINC_TAPS / 2;
+
+    SincFilters result;
+    for (u32 phase = 0; phase <= SINC_PHASES; ++phase)
+    {
+      std::array<double, SINC_TAPS> taps;
+      double sum = 0.0;
+      for (u32 i = 0; i < SINC_TAPS; ++i)
+      {
+        // The distance of this tap from the position of the output sample.
+        const double x = static_cast<double>(i) - RESAMPLER_HISTORY -
+                         static_cast<double>(phase) / SINC_PHASES;
+        const double sinc = x == 0.0 ? 1.0 : std::sin(PI * CUTOFF * x) / (PI * CUTOFF * x);
+        const double blackman =
+            0.42 + 0.5 * std::cos(PI * x / HALF_WIDTH) + 0.08 * std::cos(2 * PI * x / HALF_WIDTH);
+        taps[i] = sinc * blackman;
+        sum += taps[i];
+      }
+
+      // Normalize the filter to a gain of exactly 1 in 1.15 fixed point, so that constant signals
+      // come out unchanged.
+      s32 fixed_sum = 0;
+      u32 largest = 0;
+      for (u32 i = 0; i < SINC_TAPS; ++i)
+      {
+        result[phase][i] = static_cast<s16>(std::lround(taps[i] / sum * 32768.0));
+        fixed_sum += result[phase][i];
+        if (result[phase][i] > result[phase][largest])
+          largest = i;
+      }
+      result[phase][largest] += static_cast<s16>(32768 - fixed_sum);
+    }
+    return result;
+  }();
+
+  return filters;
+}
+
+u32 Mixer::GetResamplerLookahead(AudioCommon::ResamplingMethod method)
+{
+  if (method == AudioCommon::ResamplingMethod::WindowedSinc)
+    return SINC_TAPS - 1 - RESAMPLER_HISTORY;
+  return 1;
+}
+
 // Executed from sound stream thread
-unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
-                                   bool consider_framelimit, float emulationspeed,
-                                   int timing_variance)
+unsigned int Mixer::MixerFifo::Mix(s32* samples, unsigned int numSamples, bool consider_framelimit,
+                                   float emulationspeed, int timing_variance)
 {
   unsigned int currentSample = 0;
 
@@ -105,46 +155,78 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
     return m_little_endian ? m_buffer[index] : Common::swap16(m_buffer[index]);
   };
 
-  // TODO: consider a higher-quality resampling algorithm.
-  for (; currentSample < numSamples * 2 && ((indexW - indexR) & INDEX_MASK) > 2; currentSample += 2)
+  const AudioCommon::ResamplingMethod method = m_mixer->m_config_resampling;
+  const u32 lookahead = GetResamplerLookahead(method);
+
+  // Byteswap and split up the samples that can get read this time in one go, so that the
+  // resampling loops below work on plain arrays. The first channel in the FIFO is the left one.
+  const u32 available = ((indexW - indexR) & INDEX_MASK) / 2;
+  const u64 max_advance = (m_frac + static_cast<u64>(numSamples) * ratio) >> 16;
+  const u32 num_frames = static_cast<u32>(std::min<u64>(available, max_advance + lookahead + 1));
+  s16* const left = m_mixer->m_resample_buffer[0].data();
+  s16* const right = m_mixer->m_resample_buffer[1].data();
+  const u32 first_index = indexR - RESAMPLER_HISTORY * 2;
+  for (u32 i = 0; i < RESAMPLER_HISTORY + num_frames; ++i)
+  {
+    left[i] = read_buffer((first_index + i * 2) & INDEX_MASK);
+    right[i] = read_buffer((first_index + i * 2 + 1) & INDEX_MASK);
+  }
+
+  // The number of samples the read position has moved forward by.
+  u32 position = 0;
+  if (method == AudioCommon::ResamplingMethod::WindowedSinc)
+  {
+    const SincFilters& filters = GetSincFilters();
+    for (; currentSample < numSamples * 2 && available - position > lookahead; currentSample += 2)
+    {
+      const std::array<s16, SINC_TAPS>& filter = filters[(m_frac * SINC_PHASES + 0x8000) >> 16];
+
+      s32 sampleL = 0;
+      s32 sampleR = 0;
+      for (u32 i = 0; i < SINC_TAPS; ++i)
+      {
+        sampleL += filter[i] * left[position + i];
+        sampleR += filter[i] * right[position + i];
+      }
+      samples[currentSample + 1] += (((sampleL + 0x4000) >> 15) * lvolume) >> 8;
+      samples[currentSample] += (((sampleR + 0x4000) >> 15) * rvolume) >> 8;
+
+      m_frac += ratio;
+      position += m_frac >> 16;
+      m_frac &= 0xffff;
+    }
+  }
+  else
   {
-    u32 indexR2 = indexR + 2;  // next sample
-
-    s16 l1 = read_buffer(indexR & INDEX_MASK);   // current
-    s16 l2 = read_buffer(indexR2 & INDEX_MASK);  // next
-    int sampleL = ((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16;
-    sampleL = (sampleL * lvolume) >> 8;
-    sampleL += samples[currentSample + 1];
-    samples[currentSample + 1] = std::clamp(sampleL, -32767, 32767);
-
-    s16 r1 = read_buffer((indexR + 1) & INDEX_MASK);   // current
-    s16 r2 = read_buffer((indexR2 + 1) & INDEX_MASK);  // next
-    int sampleR = ((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16;
-    sampleR = (sampleR * rvolume) >> 8;
-    sampleR += samples[currentSample];
-    samples[currentSample] = std::clamp(sampleR, -32767, 32767);
-
-    m_frac += ratio;
-    indexR += 2 * (u16)(m_frac >> 16);
-    m_frac &= 0xffff;
+    for (; currentSample < numSamples * 2 && available - position > lookahead; currentSample += 2)
+    {
+      s16 l1 = left[RESAMPLER_HISTORY + position];      // current
+      s16 l2 = left[RESAMPLER_HISTORY + position + 1];  // next
+      int sampleL = ((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16;
+      samples[currentSample + 1] += (sampleL * lvolume) >> 8;
+
+      s16 r1 = right[RESAMPLER_HISTORY + position];      // current
+      s16 r2 = right[RESAMPLER_HISTORY + position + 1];  // next
+      int sampleR = ((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16;
+      samples[currentSample] += (sampleR * rvolume) >> 8;
+
+      m_frac += ratio;
+      position += m_frac >> 16;
+      m_frac &= 0xffff;
+    }
   }
+  indexR += position * 2;
 
   // Actual number of samples written to the buffer without padding.
   unsigned int actual_sample_count = currentSample / 2;
 
   // Padding
-  short s[2];
-  s[0] = read_buffer((indexR - 1) & INDEX_MASK);
-  s[1] = read_buffer((indexR - 2) & INDEX_MASK);
-  s[0] = (s[0] * rvolume) >> 8;
-  s[1] = (s[1] * lvolume) >> 8;
+  const s32 padding_right = (s16(read_buffer((indexR - 1) & INDEX_MASK)) * rvolume) >> 8;
+  const s32 padding_left = (s16(read_buffer((indexR - 2) & INDEX_MASK)) * lvolume) >> 8;
   for (; currentSample < numSamples * 2; currentSample += 2)
   {
-    int sampleR = std::clamp(s[0] + samples[currentSample + 0], -32767, 32767);
-    int sampleL = std::clamp(s[1] + samples[currentSample + 1], -32767, 32767);
-
-    samples[currentSample + 0] = sampleR;
-    samples[currentSample + 1] = sampleL;
+    samples[currentSample + 0] += padding_right;
+    samples[currentSample + 1] += padding_left;
   }
 
   // Flush cached variable
@@ -153,33 +235,46 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   return actual_sample_count;
 }
 
+void Mixer::MixFifos(short* samples, unsigned int num_samples, bool consider_framelimit)
+{
+  const float emulation_speed = m_config_emulation_speed;
+  const int timing_variance = m_config_timing_variance;
+  while (num_samples > 0)
+  {
+    const unsigned int count = std::min(num_samples, MAX_SAMPLES);
+    s32* const mix = m_mix_buffer.data();
+    std::fill_n(mix, count * 2, 0);
+
+    m_dma_mixer.Mix(mix, count, consider_framelimit, emulation_speed, timing_variance);
+    m_streaming_mixer.Mix(mix, count, consider_framelimit, emulation_speed, timing_variance);
+    m_wiimote_speaker_mixer.Mix(mix, count, consider_framelimit, emulation_speed,
+                                timing_variance);
+    for (auto& mixer : m_gba_mixers)
+      mixer.Mix(mix, count, consider_framelimit, emulation_speed, timing_variance);
+
+    for (unsigned int i = 0; i < count * 2; ++i)
+      samples[i] = static_cast<short>(std::clamp(mix[i], -32767, 32767));
+
+    samples += count * 2;
+    num_samples -= count;
+  }
+}
+
 unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
 {
   if (!samples)
     return 0;
 
-  memset(samples, 0, num_samples * 2 * sizeof(short));
+  const auto start_time = std::chrono::steady_clock::now();
 
-  const float emulation_speed = m_config_emulation_speed;
-  const int timing_variance = m_config_timing_variance;
   if (m_config_audio_stretch)
   {
+    memset(samples, 0, num_samples * 2 * sizeof(short));
+
     unsigned int available_samples =
         std::min(m_dma_mixer.AvailableSamples(), m_streaming_mixer.AvailableSamples());
 
-    m_scratch_buffer.fill(0);
-
-    m_dma_mixer.Mix(m_scratch_buffer.data(), available_samples, false, emulation_speed,
-                    timing_variance);
-    m_streaming_mixer.Mix(m_scratch_buffer.data(), available_samples, false, emulation_speed,
-                          timing_variance);
-    m_wiimote_speaker_mixer.Mix(m_scratch_buffer.data(), available_samples, false, emulation_speed,
-                                timing_variance);
-    for (auto& mixer : m_gba_mixers)
-    {
-      mixer.Mix(m_scratch_buffer.data(), available_samples, false, emulation_speed,
-                timing_variance);
-    }
+    MixFifos(m_scratch_buffer.data(), available_samples, false);
 
     if (!m_is_stretching)
     {
@@ -191,17 +286,44 @@ unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
   }
   else
   {
-    m_dma_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
-    m_streaming_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
-    m_wiimote_speaker_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
-    for (auto& mixer : m_gba_mixers)
-      mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
+    MixFifos(samples, num_samples, true);
     m_is_stretching = false;
   }
 
+  UpdateMixTimeStatistics(std::chrono::steady_clock::now() - start_time, num_samples);
+
   return num_samples;
 }
 
+void Mixer::UpdateMixTimeStatistics(std::chrono::steady_clock::duration mix_time,
+                                    unsigned int num_samples)
+{
+  const std::chrono::duration<float> budget(MIX_TIME_BUDGET * num_samples / m_sampleRate);
+
+  ++m_mix_calls;
+  if (mix_time > budget)
+    ++m_mix_calls_over_budget;
+  m_mix_time_worst = std::max(m_mix_time_worst, mix_time);
+
+  m_mixed_samples += num_samples;
+  if (m_mixed_samples < MIX_TIME_REPORT_INTERVAL.count() * m_sampleRate)
+    return;
+
+  if (m_mix_calls_over_budget != 0)
+  {
+    WARN_LOG_FMT(AUDIO,
+                 "{} of {} mixes took longer than {}% of the duration of the audio they produced. "
+                 "The slowest took {} us.",
+                 m_mix_calls_over_budget, m_mix_calls, MIX_TIME_BUDGET * 100,
+                 std::chrono::duration_cast<std::chrono::microseconds>(m_mix_time_worst).count());
+  }
+
+  m_mix_time_worst = {};
+  m_mixed_samples = 0;
+  m_mix_calls = 0;
+  m_mix_calls_over_budget = 0;
+}
+
 unsigned int Mixer::MixSurround(float* samples, unsigned int num_samples)
 {
   if (!num_samples)
@@ -235,8 +357,12 @@ void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_sample
 
   // Check if we have enough free space
   // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW
-  if (num_samples * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) >= MAX_SAMPLES * 2)
+  // The samples the resampler looks back at must not get overwritten either.
+  if (num_samples * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) + RESAMPLER_HISTORY * 2 >=
+      MAX_SAMPLES * 2)
+  {
     return;
+  }
 
   // AyuanX: Actual re-sampling work has been moved to sound thread
   // to alleviate the workload on main thread
@@ -412,6 +538,7 @@ void Mixer::RefreshConfig()
   m_config_emulation_speed = Config::Get(Config::MAIN_EMULATION_SPEED);
   m_config_timing_variance = Config::Get(Config::MAIN_TIMING_VARIANCE);
   m_config_audio_stretch = Config::Get(Config::MAIN_AUDIO_STRETCH);
+  m_config_resampling = Config::Get(Config::MAIN_AUDIO_RESAMPLING);
 }
 
 void Mixer::MixerFifo::DoState(PointerWrap& p)
@@ -444,9 +571,11 @@ std::pair<s32, s32> Mixer::MixerFifo::GetVolume() const
 
 unsigned int Mixer::MixerFifo::AvailableSamples() const
 {
+  // Mixer::MixerFifo::Mix always keeps the samples the resampler looks ahead at in the buffer.
+  const u32 lookahead = GetResamplerLookahead(m_mixer->m_config_resampling);
   unsigned int samples_in_fifo = ((m_indexW.load() - m_indexR.load()) & INDEX_MASK) / 2;
-  if (samples_in_fifo <= 1)
-    return 0;  // Mixer::MixerFifo::Mix always keeps one sample in the buffer.
-  return (samples_in_fifo - 1) * static_cast<u64>(m_mixer->m_sampleRate) *
+  if (samples_in_fifo <= lookahead)
+    return 0;
+  return (samples_in_fifo - lookahead) * static_cast<u64>(m_mixer->m_sampleRate) *
          m_input_sample_rate_divisor / FIXED_SAMPLE_RATE_DIVIDEND;
 }
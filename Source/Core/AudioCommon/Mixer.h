@@ -5,8 +5,10 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 
 #include "AudioCommon/AudioStretcher.h"
+#include "AudioCommon/Enums.h"
 #include "AudioCommon/SurroundDecoder.h"
 #include "AudioCommon/WaveFile.h"
 #include "Common/CommonTypes.h"
@@ -63,6 +65,20 @@ private:
 
   const unsigned int SURROUND_CHANNELS = 6;
 
+  // The windowed-sinc resampler looks at SINC_TAPS input samples around each output sample, and
+  // picks its filter from SINC_PHASES precalculated ones based on the fractional position.
+  static constexpr u32 SINC_TAPS = 16;
+  static constexpr u32 SINC_PHASES = 256;
+  // The number of samples before the current one that the resampler reads. PushSamples keeps them
+  // from getting overwritten.
+  static constexpr u32 RESAMPLER_HISTORY = SINC_TAPS / 2 - 1;
+  using SincFilters = std::array<std::array<s16, SINC_TAPS>, SINC_PHASES + 1>;
+
+  // Mix() should take at most this fraction of the duration of the audio it produces.
+  static constexpr float MIX_TIME_BUDGET = 0.25f;
+  // How much audio to mix between reports of how often Mix() went over its budget.
+  static constexpr std::chrono::seconds MIX_TIME_REPORT_INTERVAL{10};
+
   class MixerFifo final
   {
   public:
@@ -73,7 +89,8 @@ private:
     }
     void DoState(PointerWrap& p);
     void PushSamples(const short* samples, unsigned int num_samples);
-    unsigned int Mix(short* samples, unsigned int numSamples, bool consider_framelimit,
+    // Resamples and adds the FIFO's samples to the given stereo samples, with volume applied.
+    unsigned int Mix(s32* samples, unsigned int numSamples, bool consider_framelimit,
                      float emulationspeed, int timing_variance);
     void SetInputSampleRateDivisor(unsigned int rate_divisor);
     unsigned int GetInputSampleRateDivisor() const;
@@ -95,6 +112,15 @@ private:
     u32 m_frac = 0;
   };
 
+  static const SincFilters& GetSincFilters();
+  // The number of samples after the current one that the resampler reads.
+  static u32 GetResamplerLookahead(AudioCommon::ResamplingMethod method);
+
+  // Mixes all FIFOs into samples, at most MAX_SAMPLES at a time.
+  void MixFifos(short* samples, unsigned int num_samples, bool consider_framelimit);
+  void UpdateMixTimeStatistics(std::chrono::steady_clock::duration mix_time,
+                               unsigned int num_samples);
+
   void RefreshConfig();
 
   MixerFifo m_dma_mixer{this, FIXED_SAMPLE_RATE_DIVIDEND / 32000, false};
@@ -110,6 +136,16 @@ private:
   AudioCommon::AudioStretcher m_stretcher;
   AudioCommon::SurroundDecoder m_surround_decoder;
   std::array<short, MAX_SAMPLES * 2> m_scratch_buffer{};
+  // All FIFOs are summed up in here before the result is clamped once.
+  std::array<s32, MAX_SAMPLES * 2> m_mix_buffer{};
+  // The FIFO samples that are being resampled, byteswapped and split up by channel.
+  std::array<std::array<s16, RESAMPLER_HISTORY + MAX_SAMPLES + SINC_TAPS>, 2> m_resample_buffer{};
+
+  // Only accessed by the audio thread.
+  std::chrono::steady_clock::duration m_mix_time_worst{};
+  u64 m_mixed_samples = 0;
+  u32 m_mix_calls = 0;
+  u32 m_mix_calls_over_budget = 0;
 
   WaveFileWriter m_wave_writer_dtk;
   WaveFileWriter m_wave_writer_dsp;
@@ -123,6 +159,7 @@ private:
   float m_config_emulation_speed;
   int m_config_timing_variance;
   bool m_config_audio_stretch;
+  AudioCommon::ResamplingMethod m_config_resampling;
 
   size_t m_config_changed_callback_id;
 };
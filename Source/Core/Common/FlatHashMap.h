@@ -0,0 +1,166 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// A hash map for integer keys which keeps all entries in a single array and resolves collisions
+// with linear probing, so that it doesn't allocate per element and a lookup usually touches a
+// single cache line. Erasing shifts the following entries back instead of leaving tombstones.
+//
+// Any insertion or erasure may move the other values, so don't hold on to pointers or references
+// into the map across them.
+template <typename Key, typename Value>
+class FlatHashMap final
+{
+  static_assert(std::is_integral_v<Key>, "FlatHashMap only supports integer keys");
+
+public:
+  Value* Find(Key key)
+  {
+    const size_t index = FindIndex(key);
+    return index != NOT_FOUND ? &m_entries[index].value : nullptr;
+  }
+
+  const Value* Find(Key key) const
+  {
+    const size_t index = FindIndex(key);
+    return index != NOT_FOUND ? &m_entries[index].value : nullptr;
+  }
+
+  // Returns the value for the key, inserting a default constructed value if there is none.
+  Value& operator[](Key key)
+  {
+    if ((m_size + 1) * 2 > m_entries.size())
+      Grow();
+
+    const size_t mask = m_entries.size() - 1;
+    for (size_t index = HomeIndex(key);; index = (index + 1) & mask)
+    {
+      Entry& entry = m_entries[index];
+      if (!entry.used)
+      {
+        entry.key = key;
+        entry.used = true;
+        ++m_size;
+        return entry.value;
+      }
+      if (entry.key == key)
+        return entry.value;
+    }
+  }
+
+  bool Erase(Key key)
+  {
+    size_t hole = FindIndex(key);
+    if (hole == NOT_FOUND)
+      return false;
+
+    // Move back every following entry that would otherwise become unreachable from its home slot.
+    const size_t mask = m_entries.size() - 1;
+    for (size_t index = (hole + 1) & mask; m_entries[index].used; index = (index + 1) & mask)
+    {
+      const size_t home = HomeIndex(m_entries[index].key);
+      if (((index - home) & mask) >= ((index - hole) & mask))
+      {
+        m_entries[hole].key = m_entries[index].key;
+        m_entries[hole].value = std::move(m_entries[index].value);
+        hole = index;
+      }
+    }
+
+    m_entries[hole].used = false;
+    m_entries[hole].value = Value{};
+    --m_size;
+    return true;
+  }
+
+  void Clear()
+  {
+    m_entries.clear();
+    m_shift = 64;
+    m_size = 0;
+  }
+
+  size_t Size() const { return m_size; }
+  bool IsEmpty() const { return m_size == 0; }
+
+  // Calls function(key, value) for every entry. The map must not be modified while doing so.
+  template <typename Function>
+  void ForEach(Function function)
+  {
+    for (Entry& entry : m_entries)
+    {
+      if (entry.used)
+        function(entry.key, entry.value);
+    }
+  }
+
+private:
+  static constexpr size_t NOT_FOUND = ~size_t{0};
+  static constexpr size_t MIN_CAPACITY = 16;
+
+  struct Entry
+  {
+    Key key{};
+    bool used = false;
+    Value value{};
+  };
+
+  // Fibonacci hashing, which spreads the mostly aligned addresses this map tends to be used with
+  // across the whole table.
+  size_t HomeIndex(Key key) const
+  {
+    return static_cast<size_t>((static_cast<u64>(key) * UINT64_C(0x9E3779B97F4A7C15)) >> m_shift);
+  }
+
+  size_t FindIndex(Key key) const
+  {
+    if (m_size == 0)
+      return NOT_FOUND;
+
+    const size_t mask = m_entries.size() - 1;
+    for (size_t index = HomeIndex(key); m_entries[index].used; index = (index + 1) & mask)
+    {
+      if (m_entries[index].key == key)
+        return index;
+    }
+    return NOT_FOUND;
+  }
+
+  void Grow()
+  {
+    std::vector<Entry> old_entries(std::max(MIN_CAPACITY, m_entries.size() * 2));
+    std::swap(old_entries, m_entries);
+
+    m_shift = 64;
+    for (size_t capacity = m_entries.size(); capacity > 1; capacity /= 2)
+      --m_shift;
+
+    const size_t mask = m_entries.size() - 1;
+    for (Entry& old_entry : old_entries)
+    {
+      if (!old_entry.used)
+        continue;
+
+      size_t index = HomeIndex(old_entry.key);
+      while (m_entries[index].used)
+        index = (index + 1) & mask;
+      m_entries[index] = std::move(old_entry);
+    }
+  }
+
+  std::vector<Entry> m_entries;
+  u32 m_shift = 64;
+  size_t m_size = 0;
+};
+}  // namespace Common
@@ -13,6 +13,7 @@
 #include "Common/Intrinsics.h"
 
 #ifdef _M_ARM_64
+#include <arm_neon.h>
 #ifdef _MSC_VER
 #include <intrin.h>
 #else
@@ -506,14 +507,263 @@ static u64 GetMurmurHash3(const u8* src, u32 len, u32 samples)
 }
 #endif
 
+// The full hash works like the bulk loop of XXH3: the input is consumed in 64 byte stripes, each of
+// which is split into eight 64-bit lanes. Each lane is mixed with a key and multiplied by itself
+// (the low half by the high half) into its own accumulator, while its plain value goes into the
+// neighboring accumulator so that no input bits are lost. Every block of 16 stripes, the
+// accumulators get scrambled. All of this maps directly onto SIMD instructions.
+constexpr size_t HASH_LANES = StreamingHash64::STRIPE_SIZE / sizeof(u64);
+constexpr u32 STRIPES_PER_BLOCK = 16;
+constexpr u32 SCRAMBLE_PRIME = 0x9E3779B1;
+constexpr u64 PRIME64_1 = 0x9E3779B185EBCA87;
+constexpr u64 PRIME64_2 = 0xC2B2AE3D27D4EB4F;
+constexpr u64 PRIME64_3 = 0x165667B19E3779F9;
+
+alignas(32) constexpr u64 ACCUMULATE_KEY[HASH_LANES] = {
+    0x66C79EF0CFAF5A67, 0xE046DA30643BB97D, 0xF56224FE937A07C1, 0xE4D8076676BB9169,
+    0xEEC64DFCE966937D, 0x7310D3BEB4AE42D7, 0xC342EE9581DF40AF, 0x45AD05F9BF946B23,
+};
+alignas(32) constexpr u64 SCRAMBLE_KEY[HASH_LANES] = {
+    0x78491AF25C031F6B, 0x2F1CD021A0F447C5, 0xD59BF9DE098BE25B, 0x2B9D30D21EA07395,
+    0x9993D1182C42B213, 0x6E85ED0AAA821245, 0x5101EB5897A02B1F, 0x18ADE443D8151FD9,
+};
+
+void AccumulateStripesGeneric(u64* acc, const u8* data, size_t stripes, u32* stripes_in_block)
+{
+  for (size_t stripe = 0; stripe < stripes; ++stripe, data += StreamingHash64::STRIPE_SIZE)
+  {
+    for (size_t i = 0; i < HASH_LANES; ++i)
+    {
+      u64 value;
+      std::memcpy(&value, data + i * sizeof(u64), sizeof(u64));
+      const u64 keyed = value ^ ACCUMULATE_KEY[i];
+      acc[i ^ 1] += value;
+      acc[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+    }
+
+    if (++*stripes_in_block == STRIPES_PER_BLOCK)
+    {
+      *stripes_in_block = 0;
+      for (size_t i = 0; i < HASH_LANES; ++i)
+        acc[i] = ((acc[i] ^ (acc[i] >> 47)) ^ SCRAMBLE_KEY[i]) * SCRAMBLE_PRIME;
+    }
+  }
+}
+
+#if defined(_M_X86_64)
+
+void AccumulateStripesSSE2(u64* acc, const u8* data, size_t stripes, u32* stripes_in_block)
+{
+  __m128i a[HASH_LANES / 2];
+  for (size_t j = 0; j < HASH_LANES / 2; ++j)
+    a[j] = _mm_load_si128(reinterpret_cast<const __m128i*>(acc) + j);
+
+  for (size_t stripe = 0; stripe < stripes; ++stripe, data += StreamingHash64::STRIPE_SIZE)
+  {
+    for (size_t j = 0; j < HASH_LANES / 2; ++j)
+    {
+      const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data) + j);
+      const __m128i keyed = _mm_xor_si128(
+          value, _mm_load_si128(reinterpret_cast<const __m128i*>(ACCUMULATE_KEY) + j));
+      const __m128i product =
+          _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+      a[j] = _mm_add_epi64(a[j], _mm_add_epi64(product, swapped));
+    }
+
+    if (++*stripes_in_block == STRIPES_PER_BLOCK)
+    {
+      *stripes_in_block = 0;
+      const __m128i prime = _mm_set1_epi32(SCRAMBLE_PRIME);
+      for (size_t j = 0; j < HASH_LANES / 2; ++j)
+      {
+        __m128i x = _mm_xor_si128(a[j], _mm_srli_epi64(a[j], 47));
+        x = _mm_xor_si128(x, _mm_load_si128(reinterpret_cast<const __m128i*>(SCRAMBLE_KEY) + j));
+        const __m128i low = _mm_mul_epu32(x, prime);
+        const __m128i high = _mm_mul_epu32(_mm_srli_epi64(x, 32), prime);
+        a[j] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+      }
+    }
+  }
+
+  for (size_t j = 0; j < HASH_LANES / 2; ++j)
+    _mm_store_si128(reinterpret_cast<__m128i*>(acc) + j, a[j]);
+}
+
+FUNCTION_TARGET_AVX2
+void AccumulateStripesAVX2(u64* acc, const u8* data, size_t stripes, u32* stripes_in_block)
+{
+  __m256i a[HASH_LANES / 4];
+  for (size_t j = 0; j < HASH_LANES / 4; ++j)
+    a[j] = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc) + j);
+
+  for (size_t stripe = 0; stripe < stripes; ++stripe, data += StreamingHash64::STRIPE_SIZE)
+  {
+    for (size_t j = 0; j < HASH_LANES / 4; ++j)
+    {
+      const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data) + j);
+      const __m256i keyed = _mm256_xor_si256(
+          value, _mm256_load_si256(reinterpret_cast<const __m256i*>(ACCUMULATE_KEY) + j));
+      const __m256i product =
+          _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+      a[j] = _mm256_add_epi64(a[j], _mm256_add_epi64(product, swapped));
+    }
+
+    if (++*stripes_in_block == STRIPES_PER_BLOCK)
+    {
+      *stripes_in_block = 0;
+      const __m256i prime = _mm256_set1_epi32(SCRAMBLE_PRIME);
+      for (size_t j = 0; j < HASH_LANES / 4; ++j)
+      {
+        __m256i x = _mm256_xor_si256(a[j], _mm256_srli_epi64(a[j], 47));
+        x = _mm256_xor_si256(
+            x, _mm256_load_si256(reinterpret_cast<const __m256i*>(SCRAMBLE_KEY) + j));
+        const __m256i low = _mm256_mul_epu32(x, prime);
+        const __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), prime);
+        a[j] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+      }
+    }
+  }
+
+  for (size_t j = 0; j < HASH_LANES / 4; ++j)
+    _mm256_store_si256(reinterpret_cast<__m256i*>(acc) + j, a[j]);
+}
+
+#elif defined(_M_ARM_64)
+
+void AccumulateStripesNEON(u64* acc, const u8* data, size_t stripes, u32* stripes_in_block)
+{
+  uint64x2_t a[HASH_LANES / 2];
+  for (size_t j = 0; j < HASH_LANES / 2; ++j)
+    a[j] = vld1q_u64(acc + j * 2);
+
+  for (size_t stripe = 0; stripe < stripes; ++stripe, data += StreamingHash64::STRIPE_SIZE)
+  {
+    for (size_t j = 0; j < HASH_LANES / 2; ++j)
+    {
+      const uint64x2_t value = vreinterpretq_u64_u8(vld1q_u8(data + j * 16));
+      const uint64x2_t keyed = veorq_u64(value, vld1q_u64(ACCUMULATE_KEY + j * 2));
+      const uint64x2_t product = vmull_u32(vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+      const uint64x2_t swapped = vextq_u64(value, value, 1);
+      a[j] = vaddq_u64(a[j], vaddq_u64(product, swapped));
+    }
+
+    if (++*stripes_in_block == STRIPES_PER_BLOCK)
+    {
+      *stripes_in_block = 0;
+      const uint32x2_t prime = vdup_n_u32(SCRAMBLE_PRIME);
+      for (size_t j = 0; j < HASH_LANES / 2; ++j)
+      {
+        uint64x2_t x = veorq_u64(a[j], vshrq_n_u64(a[j], 47));
+        x = veorq_u64(x, vld1q_u64(SCRAMBLE_KEY + j * 2));
+        const uint64x2_t low = vmull_u32(vmovn_u64(x), prime);
+        const uint64x2_t high = vmull_u32(vshrn_n_u64(x, 32), prime);
+        a[j] = vaddq_u64(low, vshlq_n_u64(high, 32));
+      }
+    }
+  }
+
+  for (size_t j = 0; j < HASH_LANES / 2; ++j)
+    vst1q_u64(acc + j * 2, a[j]);
+}
+
+#endif
+
+static AccumulateStripesFunction s_accumulate_stripes = &AccumulateStripesGeneric;
+
+static u64 Avalanche64(u64 h)
+{
+  h ^= h >> 33;
+  h *= PRIME64_2;
+  h ^= h >> 29;
+  h *= PRIME64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+StreamingHash64::StreamingHash64() : StreamingHash64(s_accumulate_stripes)
+{
+}
+
+StreamingHash64::StreamingHash64(AccumulateStripesFunction accumulate_stripes)
+    : m_accumulate_stripes(accumulate_stripes)
+{
+  // Arbitrary, but nonzero so that zeroes in the input still change the accumulators.
+  for (size_t i = 0; i < HASH_LANES; ++i)
+    m_accumulators[i] = PRIME64_1 * (i + 1);
+}
+
+void StreamingHash64::Update(const u8* data, size_t length)
+{
+  m_length += length;
+
+  if (m_buffered != 0)
+  {
+    const size_t count = std::min(length, STRIPE_SIZE - m_buffered);
+    std::memcpy(m_buffer.data() + m_buffered, data, count);
+    m_buffered += count;
+    data += count;
+    length -= count;
+
+    if (m_buffered < STRIPE_SIZE)
+      return;
+
+    m_accumulate_stripes(m_accumulators.data(), m_buffer.data(), 1, &m_stripes_in_block);
+    m_buffered = 0;
+  }
+
+  const size_t stripes = length / STRIPE_SIZE;
+  m_accumulate_stripes(m_accumulators.data(), data, stripes, &m_stripes_in_block);
+  data += stripes * STRIPE_SIZE;
+  length -= stripes * STRIPE_SIZE;
+
+  std::memcpy(m_buffer.data(), data, length);
+  m_buffered = length;
+}
+
+u64 StreamingHash64::Digest() const
+{
+  alignas(32) std::array<u64, HASH_LANES> acc = m_accumulators;
+  if (m_buffered != 0)
+  {
+    // The length is mixed in below, so padding with zeroes doesn't cause collisions.
+    std::array<u8, STRIPE_SIZE> last_stripe{};
+    std::memcpy(last_stripe.data(), m_buffer.data(), m_buffered);
+    u32 stripes_in_block = m_stripes_in_block;
+    m_accumulate_stripes(acc.data(), last_stripe.data(), 1, &stripes_in_block);
+  }
+
+  u64 hash = m_length * PRIME64_1;
+  for (size_t i = 0; i < HASH_LANES; ++i)
+    hash = (hash ^ Avalanche64(acc[i] ^ SCRAMBLE_KEY[i])) * PRIME64_2 + PRIME64_3;
+  return Avalanche64(hash);
+}
+
+u64 GetFullHash64(const u8* src, size_t len)
+{
+  StreamingHash64 hash;
+  hash.Update(src, len);
+  return hash.Digest();
+}
+
 u64 GetHash64(const u8* src, u32 len, u32 samples)
 {
+  if (samples == 0)
+    return GetFullHash64(src, len);
+
   return ptrHashFunction(src, len, samples);
 }
 
 // sets the hash function used for the texture cache
 void SetHash64Function()
 {
+#if defined(_M_X86_64)
+  s_accumulate_stripes = cpu_info.bAVX2 ? &AccumulateStripesAVX2 : &AccumulateStripesSSE2;
+#elif defined(_M_ARM_64)
+  s_accumulate_stripes = &AccumulateStripesNEON;
+#endif
+
 #if defined(_M_X86_64) || defined(_M_X86)
   if (cpu_info.bSSE4_2)  // sse crc32 version
   {
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <string_view>
 
@@ -16,6 +17,48 @@ u32 HashEctor(const u8* ptr, size_t length);         // JUNK. DO NOT USE FOR NEW
 u64 GetHash64(const u8* src, u32 len, u32 samples);
 void SetHash64Function();
 
+// The inner loop of StreamingHash64, which processes whole stripes. SetHash64Function picks the
+// fastest one the CPU supports.
+using AccumulateStripesFunction = void (*)(u64* acc, const u8* data, size_t stripes,
+                                           u32* stripes_in_block);
+void AccumulateStripesGeneric(u64* acc, const u8* data, size_t stripes, u32* stripes_in_block);
+#if defined(_M_X86_64)
+void AccumulateStripesSSE2(u64* acc, const u8* data, size_t stripes, u32* stripes_in_block);
+void AccumulateStripesAVX2(u64* acc, const u8* data, size_t stripes, u32* stripes_in_block);
+#elif defined(_M_ARM_64)
+void AccumulateStripesNEON(u64* acc, const u8* data, size_t stripes, u32* stripes_in_block);
+#endif
+
+// Hashes every byte of its input, fast enough to keep up with memory bandwidth. The input can be
+// passed in pieces (like the rows of a texture with padding between them), which gives the same
+// result as passing all of it at once. GetHash64 uses this when asked not to sample.
+//
+// The portable implementation is used until SetHash64Function picks the best one for the CPU.
+// The results don't depend on which implementation is used, but they do depend on the host's
+// endianness, so they must not be stored.
+class StreamingHash64 final
+{
+public:
+  static constexpr size_t STRIPE_SIZE = 64;
+
+  StreamingHash64();
+  // Uses the given implementation instead of the one SetHash64Function picked.
+  explicit StreamingHash64(AccumulateStripesFunction accumulate_stripes);
+
+  void Update(const u8* data, size_t length);
+  u64 Digest() const;
+
+private:
+  AccumulateStripesFunction m_accumulate_stripes;
+  alignas(32) std::array<u64, STRIPE_SIZE / sizeof(u64)> m_accumulators;
+  std::array<u8, STRIPE_SIZE> m_buffer{};
+  size_t m_buffered = 0;
+  u32 m_stripes_in_block = 0;
+  u64 m_length = 0;
+};
+
+u64 GetFullHash64(const u8* src, size_t len);
+
 u32 ComputeCRC32(std::string_view data);
 u32 ComputeCRC32(const u8* ptr, u32 length);
 u32 StartCRC32();
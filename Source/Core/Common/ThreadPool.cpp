@@ -0,0 +1,149 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "Common/Thread.h"
+
+namespace Common
+{
+ThreadPool::ThreadPool(size_t num_threads, std::string name) : m_name(std::move(name))
+{
+  if (num_threads == 0)
+    num_threads = GetDefaultThreadCount();
+
+  m_threads.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i)
+    m_threads.emplace_back(&ThreadPool::ThreadLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard lk(m_lock);
+    m_shutdown = true;
+  }
+  m_wakeup.notify_all();
+
+  for (std::thread& thread : m_threads)
+    thread.join();
+}
+
+size_t ThreadPool::GetDefaultThreadCount()
+{
+  return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+  {
+    std::lock_guard lk(m_lock);
+    m_tasks.push_back(std::move(task));
+    ++m_pending;
+  }
+  m_wakeup.notify_one();
+}
+
+void ThreadPool::SubmitUrgent(std::function<void()> task)
+{
+  {
+    std::lock_guard lk(m_lock);
+    m_tasks.push_front(std::move(task));
+    ++m_pending;
+  }
+  m_wakeup.notify_one();
+}
+
+void ThreadPool::Cancel()
+{
+  {
+    std::lock_guard lk(m_lock);
+    m_pending -= m_tasks.size();
+    m_tasks.clear();
+  }
+  m_done.notify_all();
+}
+
+void ThreadPool::WaitForCompletion()
+{
+  std::unique_lock lk(m_lock);
+  m_done.wait(lk, [this] { return m_pending == 0; });
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& function)
+{
+  if (count == 0)
+    return;
+
+  // The shared state outlives this call, since helper tasks that only get to run after all
+  // indices have been claimed may still be sitting in the queue when we return.
+  struct State
+  {
+    std::atomic<size_t> next_index = 0;
+    std::atomic<size_t> remaining = 0;
+    std::mutex finished_lock;
+    std::condition_variable finished;
+  };
+  const auto state = std::make_shared<State>();
+  state->remaining = count;
+
+  const auto run = [state, count, &function] {
+    size_t processed = 0;
+    for (size_t i = state->next_index++; i < count; i = state->next_index++)
+    {
+      function(i);
+      ++processed;
+    }
+
+    if (processed != 0 && state->remaining.fetch_sub(processed) == processed)
+    {
+      std::lock_guard lk(state->finished_lock);
+      state->finished.notify_all();
+    }
+  };
+
+  // The calling thread takes part too, so one less helper than there are indices is enough.
+  const size_t helpers = std::min(m_threads.size(), count - 1);
+  for (size_t i = 0; i < helpers; ++i)
+    SubmitUrgent(run);
+
+  run();
+
+  std::unique_lock lk(state->finished_lock);
+  state->finished.wait(lk, [&] { return state->remaining.load() == 0; });
+}
+
+void ThreadPool::ThreadLoop()
+{
+  Common::SetCurrentThreadName(m_name.c_str());
+
+  while (true)
+  {
+    std::function<void()> task;
+    {
+      std::unique_lock lk(m_lock);
+      m_wakeup.wait(lk, [this] { return m_shutdown || !m_tasks.empty(); });
+      if (m_tasks.empty())
+        return;
+
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+
+    task();
+
+    bool all_done;
+    {
+      std::lock_guard lk(m_lock);
+      all_done = --m_pending == 0;
+    }
+    if (all_done)
+      m_done.notify_all();
+  }
+}
+}  // namespace Common
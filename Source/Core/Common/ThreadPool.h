@@ -0,0 +1,64 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// A fixed-size pool of worker threads that execute queued tasks.
+// * Submit(): queues a task to be run on one of the worker threads.
+// * WaitForCompletion(): blocks until every task submitted so far has finished.
+// * ParallelFor(): runs a function for every index in a range, splitting the work between
+//                  the workers and the calling thread, and returns once all indices are done.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Common
+{
+class ThreadPool final
+{
+public:
+  // A thread count of 0 uses one worker per hardware thread.
+  explicit ThreadPool(size_t num_threads = 0, std::string name = "ThreadPool");
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;
+
+  void Submit(std::function<void()> task);
+
+  // Like Submit, but the task is placed in front of all tasks that are still queued.
+  void SubmitUrgent(std::function<void()> task);
+
+  // Drops all tasks that haven't been started yet. Tasks that are running will finish.
+  void Cancel();
+
+  void WaitForCompletion();
+
+  void ParallelFor(size_t count, const std::function<void(size_t)>& function);
+
+  size_t GetThreadCount() const { return m_threads.size(); }
+
+  static size_t GetDefaultThreadCount();
+
+private:
+  void ThreadLoop();
+
+  std::string m_name;
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_lock;
+  std::condition_variable m_wakeup;
+  std::condition_variable m_done;
+  std::deque<std::function<void()>> m_tasks;
+  size_t m_pending = 0;
+  bool m_shutdown = false;
+};
+}  // namespace Common
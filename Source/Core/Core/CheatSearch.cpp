@@ -3,7 +3,10 @@
 
 #include "Core/CheatSearch.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -15,6 +18,8 @@
 #include "Common/Align.h"
 #include "Common/BitUtils.h"
 #include "Common/StringUtil.h"
+#include "Common/Swap.h"
+#include "Common/ThreadPool.h"
 
 #include "Core/Core.h"
 #include "Core/HW/Memmap.h"
@@ -187,11 +192,203 @@ TryReadValueFromEmulatedMemory(u32 addr, PowerPC::RequestedAddressSpace space)
 }
 }  // namespace
 
+namespace
+{
+// Values are read and compared in blocks, so that the compiler can vectorize the byteswaps and the
+// comparisons of a block.
+constexpr u32 SCAN_BLOCK_SIZE = 64;
+
+// How many bytes of memory a single task of a new search scans at most.
+constexpr u32 SCAN_CHUNK_SIZE = 0x40000;
+
+// Returns where the page containing the given address lies in host memory, or nullptr if it isn't
+// in MEM1 or MEM2. Anything else, like the locked L1 cache, is left to the MMU read functions.
+const u8* GetHostPage(u32 address, PowerPC::RequestedAddressSpace space, bool* translated)
+{
+  u32 page = address & ~static_cast<u32>(PowerPC::HW_PAGE_MASK);
+
+  *translated = space == PowerPC::RequestedAddressSpace::Virtual ||
+                (space == PowerPC::RequestedAddressSpace::Effective && MSR.DR);
+  if (*translated)
+  {
+    const std::optional<u32> translated_page = PowerPC::GetTranslatedAddress(page);
+    if (!translated_page)
+      return nullptr;
+    page = *translated_page;
+  }
+
+  if (Memory::m_pRAM && (page >> 28) == 0x0 && page < Memory::GetRamSizeReal())
+    return &Memory::m_pRAM[page];
+  if (Memory::m_pEXRAM && (page >> 28) == 0x1 && (page & 0x0FFFFFFF) < Memory::GetExRamSizeReal())
+    return &Memory::m_pEXRAM[page & 0x0FFFFFFF];
+  return nullptr;
+}
+
+// Remembers the last page that was looked up, since searches read many values from each page.
+class HostPageLookup
+{
+public:
+  explicit HostPageLookup(PowerPC::RequestedAddressSpace space) : m_space(space) {}
+
+  const u8* GetPointer(u32 address, bool* translated)
+  {
+    const u32 page = address & ~static_cast<u32>(PowerPC::HW_PAGE_MASK);
+    if (!m_valid || page != m_page)
+    {
+      m_host_page = GetHostPage(page, m_space, &m_translated);
+      m_page = page;
+      m_valid = true;
+    }
+
+    *translated = m_translated;
+    if (!m_host_page)
+      return nullptr;
+    return m_host_page + (address & PowerPC::HW_PAGE_MASK);
+  }
+
+private:
+  PowerPC::RequestedAddressSpace m_space;
+  u32 m_page = 0;
+  const u8* m_host_page = nullptr;
+  bool m_translated = false;
+  bool m_valid = false;
+};
+
 template <typename T>
+T ReadFromHost(const u8* ptr)
+{
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return Common::FromBigEndian(value);
+}
+
+Cheats::SearchResultValueState GetValueState(bool translated)
+{
+  return translated ? Cheats::SearchResultValueState::ValueFromVirtualMemory :
+                      Cheats::SearchResultValueState::ValueFromPhysicalMemory;
+}
+
+// A run of consecutive values of a search range. If host is set, every value of the run lies in
+// MEM1 or MEM2 as a whole and can be read from there directly. Runs are kept small enough to be
+// spread over the worker threads.
+struct ScanSpan
+{
+  u32 address;
+  u32 count;
+  const u8* host;
+  bool translated;
+};
+
+// Splits the values of a range into runs that can be read from host memory and runs that have to
+// go through the MMU, like unmapped pages or values that cross into another page.
+void AppendScanSpans(std::vector<ScanSpan>* spans, u32 start_address, u64 count, u32 step,
+                     u32 data_size, PowerPC::RequestedAddressSpace space)
+{
+  const auto append = [spans, step](u64 address, u64 value_count, const u8* host,
+                                    bool translated) {
+    if (!spans->empty())
+    {
+      ScanSpan& last = spans->back();
+      const u64 offset = address - last.address;
+      const bool host_contiguous = last.host && host && last.host + offset == host;
+      if ((host_contiguous || (!last.host && !host)) && last.translated == translated &&
+          last.address + u64(last.count) * step == address &&
+          last.count + value_count <= SCAN_CHUNK_SIZE / step)
+      {
+        last.count += static_cast<u32>(value_count);
+        return;
+      }
+    }
+    spans->push_back({static_cast<u32>(address), static_cast<u32>(value_count), host, translated});
+  };
+
+  u64 address = start_address;
+  while (count > 0)
+  {
+    const u64 page_end = (address | PowerPC::HW_PAGE_MASK) + 1;
+
+    bool translated;
+    const u8* host = GetHostPage(static_cast<u32>(address), space, &translated);
+    if (host)
+      host += address & PowerPC::HW_PAGE_MASK;
+
+    // The values that lie completely within this page.
+    u64 in_page = address + data_size <= page_end ? (page_end - data_size - address) / step + 1 : 0;
+    in_page = std::min(in_page, count);
+    if (in_page > 0)
+    {
+      append(address, in_page, host, translated);
+      address += in_page * step;
+      count -= in_page;
+    }
+
+    // The values that cross into the next page.
+    while (count > 0 && address < page_end)
+    {
+      append(address, 1, nullptr, translated);
+      address += step;
+      --count;
+    }
+  }
+}
+
+template <typename T, typename Validator>
+void ScanHostSpan(const ScanSpan& span, u32 step, const Validator& validator,
+                  std::vector<Cheats::SearchResult<T>>* results)
+{
+  const Cheats::SearchResultValueState value_state = GetValueState(span.translated);
+
+  std::array<T, SCAN_BLOCK_SIZE> values;
+  std::array<bool, SCAN_BLOCK_SIZE> matches;
+  for (u32 i = 0; i < span.count; i += SCAN_BLOCK_SIZE)
+  {
+    const u32 block_size = std::min(SCAN_BLOCK_SIZE, span.count - i);
+    const u8* const block = span.host + i * step;
+    for (u32 j = 0; j < block_size; ++j)
+      values[j] = ReadFromHost<T>(block + j * step);
+    for (u32 j = 0; j < block_size; ++j)
+      matches[j] = validator(values[j]);
+
+    for (u32 j = 0; j < block_size; ++j)
+    {
+      if (!matches[j])
+        continue;
+
+      auto& r = results->emplace_back();
+      r.m_value = values[j];
+      r.m_value_state = value_state;
+      r.m_address = span.address + (i + j) * step;
+    }
+  }
+}
+
+template <typename T, typename Validator>
+void ScanMMUSpan(const ScanSpan& span, u32 step, PowerPC::RequestedAddressSpace space,
+                 const Validator& validator, std::vector<Cheats::SearchResult<T>>* results)
+{
+  for (u32 i = 0; i < span.count; ++i)
+  {
+    const u32 addr = span.address + i * step;
+    const auto current_value = TryReadValueFromEmulatedMemory<T>(addr, space);
+    if (!current_value)
+      continue;
+
+    if (validator(current_value->value))
+    {
+      auto& r = results->emplace_back();
+      r.m_value = current_value->value;
+      r.m_value_state = GetValueState(current_value->translated);
+      r.m_address = addr;
+    }
+  }
+}
+
+// The validator is a template parameter so that searches with a known comparison can inline it.
+template <typename T, typename Validator>
 Common::Result<Cheats::SearchErrorCode, std::vector<Cheats::SearchResult<T>>>
-Cheats::NewSearch(const std::vector<Cheats::MemoryRange>& memory_ranges,
-                  PowerPC::RequestedAddressSpace address_space, bool aligned,
-                  const std::function<bool(const T& value)>& validator)
+NewSearchImpl(const std::vector<Cheats::MemoryRange>& memory_ranges,
+              PowerPC::RequestedAddressSpace address_space, bool aligned,
+              const Validator& validator)
 {
   const u32 data_size = sizeof(T);
   std::vector<Cheats::SearchResult<T>> results;
@@ -210,12 +407,14 @@ Cheats::NewSearch(const std::vector<Cheats::MemoryRange>& memory_ranges,
       return;
     }
 
+    const u32 increment_per_loop = aligned ? data_size : 1;
+
+    std::vector<ScanSpan> spans;
     for (const Cheats::MemoryRange& range : memory_ranges)
     {
       if (range.m_length < data_size)
         continue;
 
-      const u32 increment_per_loop = aligned ? data_size : 1;
       const u32 start_address = aligned ? Common::AlignUp(range.m_start, data_size) : range.m_start;
       const u64 aligned_length = range.m_length - (start_address - range.m_start);
 
@@ -223,29 +422,57 @@ Cheats::NewSearch(const std::vector<Cheats::MemoryRange>& memory_ranges,
         continue;
 
       const u64 length = aligned_length - (data_size - 1);
-      for (u64 i = 0; i < length; i += increment_per_loop)
-      {
-        const u32 addr = start_address + i;
-        const auto current_value = TryReadValueFromEmulatedMemory<T>(addr, address_space);
-        if (!current_value)
-          continue;
-
-        if (validator(current_value->value))
-        {
-          auto& r = results.emplace_back();
-          r.m_value = current_value->value;
-          r.m_value_state = current_value->translated ?
-                                Cheats::SearchResultValueState::ValueFromVirtualMemory :
-                                Cheats::SearchResultValueState::ValueFromPhysicalMemory;
-          r.m_address = addr;
-        }
-      }
+      const u64 count = (length + increment_per_loop - 1) / increment_per_loop;
+      AppendScanSpans(&spans, start_address, count, increment_per_loop, data_size, address_space);
     }
+
+    // Memory can only be read through the MMU on the CPU thread, but everything in MEM1 and MEM2
+    // can be scanned by the worker threads while the CPU thread is held here.
+    std::vector<std::vector<Cheats::SearchResult<T>>> span_results(spans.size());
+    std::vector<size_t> host_spans;
+    for (size_t i = 0; i < spans.size(); ++i)
+    {
+      if (spans[i].host)
+        host_spans.push_back(i);
+      else
+        ScanMMUSpan(spans[i], increment_per_loop, address_space, validator, &span_results[i]);
+    }
+
+    if (host_spans.size() > 1)
+    {
+      Common::ThreadPool thread_pool(0, "CheatSearch");
+      thread_pool.ParallelFor(host_spans.size(), [&](size_t i) {
+        const size_t span = host_spans[i];
+        ScanHostSpan(spans[span], increment_per_loop, validator, &span_results[span]);
+      });
+    }
+    else if (host_spans.size() == 1)
+    {
+      const size_t span = host_spans[0];
+      ScanHostSpan(spans[span], increment_per_loop, validator, &span_results[span]);
+    }
+
+    size_t result_count = 0;
+    for (const auto& r : span_results)
+      result_count += r.size();
+    results.reserve(result_count);
+    for (const auto& r : span_results)
+      results.insert(results.end(), r.begin(), r.end());
   });
   if (error_code == Cheats::SearchErrorCode::Success)
     return results;
   return error_code;
 }
+}  // namespace
+
+template <typename T>
+Common::Result<Cheats::SearchErrorCode, std::vector<Cheats::SearchResult<T>>>
+Cheats::NewSearch(const std::vector<Cheats::MemoryRange>& memory_ranges,
+                  PowerPC::RequestedAddressSpace address_space, bool aligned,
+                  const std::function<bool(const T& value)>& validator)
+{
+  return NewSearchImpl<T>(memory_ranges, address_space, aligned, validator);
+}
 
 template <typename T>
 Common::Result<Cheats::SearchErrorCode, std::vector<Cheats::SearchResult<T>>>
@@ -269,10 +496,23 @@ Cheats::NextSearch(const std::vector<Cheats::SearchResult<T>>& previous_results,
       return;
     }
 
+    HostPageLookup page_lookup(address_space);
+    results.reserve(previous_results.size());
     for (const auto& previous_result : previous_results)
     {
       const u32 addr = previous_result.m_address;
-      const auto current_value = TryReadValueFromEmulatedMemory<T>(addr, address_space);
+
+      // Values that lie within a page of MEM1 or MEM2 are read directly instead of through the MMU.
+      std::optional<PowerPC::ReadResult<T>> current_value;
+      if ((addr & PowerPC::HW_PAGE_MASK) + sizeof(T) <= PowerPC::HW_PAGE_SIZE)
+      {
+        bool translated;
+        if (const u8* host = page_lookup.GetPointer(addr, &translated))
+          current_value.emplace(translated, ReadFromHost<T>(host));
+      }
+      if (!current_value)
+        current_value = TryReadValueFromEmulatedMemory<T>(addr, address_space);
+
       if (!current_value)
       {
         auto& r = results.emplace_back();
@@ -288,9 +528,7 @@ Cheats::NextSearch(const std::vector<Cheats::SearchResult<T>>& previous_results,
       {
         auto& r = results.emplace_back();
         r.m_value = current_value->value;
-        r.m_value_state = current_value->translated ?
-                              Cheats::SearchResultValueState::ValueFromVirtualMemory :
-                              Cheats::SearchResultValueState::ValueFromPhysicalMemory;
+        r.m_value_state = GetValueState(current_value->translated);
         r.m_address = addr;
       }
     }
@@ -399,6 +637,31 @@ MakeCompareFunctionForSpecificValue(Cheats::CompareType op, const T& old_value)
   }
 }
 
+// Calls the given function with the comparison as a function object, so that new searches can
+// inline it into their scan loops.
+template <typename T, typename Function>
+static auto VisitCompareFunction(Cheats::CompareType op, Function&& function)
+{
+  switch (op)
+  {
+  case Cheats::CompareType::Equal:
+    return function(std::equal_to<T>());
+  case Cheats::CompareType::NotEqual:
+    return function(std::not_equal_to<T>());
+  case Cheats::CompareType::Less:
+    return function(std::less<T>());
+  case Cheats::CompareType::LessOrEqual:
+    return function(std::less_equal<T>());
+  case Cheats::CompareType::Greater:
+    return function(std::greater<T>());
+  case Cheats::CompareType::GreaterOrEqual:
+    return function(std::greater_equal<T>());
+  default:
+    assert(0);
+    return function(std::equal_to<T>());
+  }
+}
+
 template <typename T>
 static std::function<bool(const T& old_value, const T& new_value)>
 MakeCompareFunctionForLastValue(Cheats::CompareType op)
@@ -433,16 +696,20 @@ Cheats::SearchErrorCode Cheats::CheatSearchSession<T>::RunSearch()
     if (!m_value)
       return Cheats::SearchErrorCode::InvalidParameters;
 
-    auto func = MakeCompareFunctionForSpecificValue<T>(m_compare_type, *m_value);
     if (m_first_search_done)
     {
+      auto func = MakeCompareFunctionForSpecificValue<T>(m_compare_type, *m_value);
       result = Cheats::NextSearch<T>(
           m_search_results, m_address_space,
           [&func](const T& new_value, const T& old_value) { return func(new_value); });
     }
     else
     {
-      result = Cheats::NewSearch<T>(m_memory_ranges, m_address_space, m_aligned, func);
+      const T value = *m_value;
+      result = VisitCompareFunction<T>(m_compare_type, [&](auto compare) {
+        return NewSearchImpl<T>(m_memory_ranges, m_address_space, m_aligned,
+                                [compare, value](const T& v) { return compare(v, value); });
+      });
     }
   }
   else if (m_filter_type == FilterType::CompareAgainstLastValue)
@@ -462,8 +729,8 @@ Cheats::SearchErrorCode Cheats::CheatSearchSession<T>::RunSearch()
     }
     else
     {
-      result = Cheats::NewSearch<T>(m_memory_ranges, m_address_space, m_aligned,
-                                    [](const T& v) { return true; });
+      result = NewSearchImpl<T>(m_memory_ranges, m_address_space, m_aligned,
+                                [](const T& v) { return true; });
     }
   }
 
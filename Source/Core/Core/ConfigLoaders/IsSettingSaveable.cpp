@@ -62,6 +62,7 @@ bool IsSettingSaveable(const Config::Location& config_location)
       &Config::MAIN_DPL2_DECODER.GetLocation(),
       &Config::MAIN_DPL2_QUALITY.GetLocation(),
       &Config::MAIN_AUDIO_LATENCY.GetLocation(),
+      &Config::MAIN_AUDIO_RESAMPLING.GetLocation(),
       &Config::MAIN_AUDIO_STRETCH.GetLocation(),
       &Config::MAIN_AUDIO_STRETCH_LATENCY.GetLocation(),
       &Config::MAIN_OVERCLOCK.GetLocation(),
@@ -71,6 +72,10 @@ bool IsSettingSaveable(const Config::Location& config_location)
       &Config::MAIN_MEM2_SIZE.GetLocation(),
       &Config::MAIN_GFX_BACKEND.GetLocation(),
       &Config::MAIN_ENABLE_SAVESTATES.GetLocation(),
+      &Config::MAIN_STATE_COMPRESSION_LEVEL.GetLocation(),
+      &Config::MAIN_REWIND_ENABLE.GetLocation(),
+      &Config::MAIN_REWIND_FRAME_INTERVAL.GetLocation(),
+      &Config::MAIN_REWIND_MEMORY_MB.GetLocation(),
       &Config::MAIN_FALLBACK_REGION.GetLocation(),
       &Config::MAIN_REAL_WII_REMOTE_REPEAT_REPORTS.GetLocation(),
       &Config::MAIN_DSP_HLE.GetLocation(),
@@ -86,6 +91,9 @@ bool IsSettingSaveable(const Config::Location& config_location)
       &Config::MAIN_CUSTOM_RTC_ENABLE.GetLocation(),
       &Config::MAIN_CUSTOM_RTC_VALUE.GetLocation(),
       &Config::MAIN_JIT_FOLLOW_BRANCH.GetLocation(),
+      &Config::MAIN_JIT_PERSISTENT_CACHE.GetLocation(),
+      &Config::MAIN_JIT_TIERED_COMPILATION.GetLocation(),
+      &Config::MAIN_JIT_COMPILE_BUDGET.GetLocation(),
       &Config::MAIN_FLOAT_EXCEPTIONS.GetLocation(),
       &Config::MAIN_DIVIDE_BY_ZERO_EXCEPTIONS.GetLocation(),
       &Config::MAIN_LOW_DCBZ_HACK.GetLocation(),
@@ -47,6 +47,7 @@
 #include "Core/IOS/ES/ES.h"
 #include "Core/IOS/ES/Formats.h"
 #include "Core/PatchEngine.h"
+#include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/TitleDatabase.h"
@@ -199,6 +200,7 @@ void SConfig::OnNewTitleLoad()
   HLE::Reload();
   PatchEngine::Reload();
   HiresTexture::Update();
+  JitInterface::OnNewTitleLoad();
 }
 
 void SConfig::LoadDefaults()
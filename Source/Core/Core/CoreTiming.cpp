@@ -4,6 +4,8 @@
 #include "Core/CoreTiming.h"
 
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -12,6 +14,7 @@
 #include <fmt/format.h>
 
 #include "Common/Assert.h"
+#include "Common/BitSet.h"
 #include "Common/ChunkFile.h"
 #include "Common/Logging/Log.h"
 #include "Common/SPSCQueue.h"
@@ -25,6 +28,8 @@
 
 namespace CoreTiming
 {
+constexpr u32 INVALID_SLOT = UINT32_MAX;
+
 struct EventType
 {
   TimedCallback callback;
@@ -40,25 +45,342 @@ struct Event
 };
 
 // Sort by time, unless the times are the same, in which case sort by the order added to the queue
-static bool operator>(const Event& left, const Event& right)
-{
-  return std::tie(left.time, left.fifo_order) > std::tie(right.time, right.fifo_order);
-}
 static bool operator<(const Event& left, const Event& right)
 {
   return std::tie(left.time, left.fifo_order) < std::tie(right.time, right.fifo_order);
 }
 
+// A hierarchical timing wheel. Events live in a slot pool and are linked into one bucket each,
+// so scheduling and removing an event is O(1) and never moves other events around.
+//
+// Level 0 has WHEEL_BUCKETS buckets of 2^WHEEL_GRANULARITY_BITS cycles each, and every further
+// level has buckets that are WHEEL_BUCKETS times wider. An event goes into the lowest level
+// whose bucket range (relative to m_base) contains it, which means every event in level N is
+// due before every event in level N+1, and within a level the bucket index gives the order.
+// Once level 0 runs empty, the earliest bucket of the next non-empty level is moved down
+// ("cascaded"). Events too far into the future for the top level wait in an overflow list.
+//
+// Events within a bucket are unordered, the earliest one is found by comparing (time,
+// fifo_order), so the order in which events run is exactly the same as with a sorted queue.
+class EventQueue final
+{
+public:
+  EventQueue() { m_buckets.fill(INVALID_SLOT); }
+
+  u32 Insert(const Event& event);
+  void Remove(u32 slot);
+  void RemoveAllOfType(const EventType* type);
+  void Clear();
+
+  // Returns nullptr if the queue is empty.
+  const Event* Peek();
+  Event Pop();
+
+  bool IsEmpty() const { return m_size == 0; }
+  bool IsPending(EventHandle handle) const;
+  u32 GetGeneration(u32 slot) const { return m_slots[slot].generation; }
+
+  std::vector<Event> GetSortedEvents() const;
+
+  // Applies a function to the time of every event and re-sorts the events into the wheel.
+  template <typename Function>
+  void AdjustTimes(Function function);
+
+private:
+  static constexpr u32 WHEEL_LEVELS = 4;
+  static constexpr u32 WHEEL_BUCKET_BITS = 6;
+  static constexpr u32 WHEEL_BUCKETS = 1 << WHEEL_BUCKET_BITS;
+  static constexpr u32 WHEEL_GRANULARITY_BITS = 10;
+  static constexpr u32 OVERFLOW_BUCKET = WHEEL_LEVELS * WHEEL_BUCKETS;
+  static constexpr u32 NO_BUCKET = OVERFLOW_BUCKET + 1;
+
+  struct Slot
+  {
+    Event event{};
+    u32 generation = 0;
+    u32 bucket = NO_BUCKET;
+    // Links within the bucket, or within the free list for unused slots.
+    u32 prev = INVALID_SLOT;
+    u32 next = INVALID_SLOT;
+    // Links within the list of pending events of the same type.
+    u32 type_prev = INVALID_SLOT;
+    u32 type_next = INVALID_SLOT;
+  };
+
+  static constexpr u32 LevelShift(u32 level)
+  {
+    return WHEEL_GRANULARITY_BITS + level * WHEEL_BUCKET_BITS;
+  }
+
+  // Maps times to unsigned keys with the same ordering, so that bits can be compared.
+  static u64 ToKey(s64 time) { return static_cast<u64>(time) ^ (UINT64_C(1) << 63); }
+  static s64 FromKey(u64 key) { return static_cast<s64>(key ^ (UINT64_C(1) << 63)); }
+
+  u32 GetBucket(s64 time) const;
+  void LinkToBucket(u32 slot);
+  void UnlinkFromBucket(u32 slot);
+  void Cascade();
+  u32 FindEarliest();
+
+  std::vector<Slot> m_slots;
+  u32 m_free_slots = INVALID_SLOT;
+  size_t m_size = 0;
+
+  std::array<u32, OVERFLOW_BUCKET + 1> m_buckets{};
+  std::array<u64, WHEEL_LEVELS> m_occupied{};
+  // First pending event of each type, so that removing events by type doesn't have to search
+  // the queue. This deliberately doesn't live in EventType, since RemoveEvent can get called
+  // with types that have already been unregistered.
+  std::unordered_map<const EventType*, u32> m_first_of_type;
+  // Result of the last FindEarliest() call, as long as no events have been removed since.
+  u32 m_earliest = INVALID_SLOT;
+  // Every event is due at or after m_base, except for events that were scheduled into the past,
+  // which are kept in the level 0 bucket of m_base.
+  s64 m_base = 0;
+};
+
+u32 EventQueue::GetBucket(s64 time) const
+{
+  if (time <= m_base)
+    return (ToKey(m_base) >> LevelShift(0)) % WHEEL_BUCKETS;
+
+  const u64 key = ToKey(time);
+  const u64 differing_bits = key ^ ToKey(m_base);
+  for (u32 level = 0; level < WHEEL_LEVELS; ++level)
+  {
+    if ((differing_bits >> LevelShift(level + 1)) == 0)
+      return level * WHEEL_BUCKETS + (key >> LevelShift(level)) % WHEEL_BUCKETS;
+  }
+  return OVERFLOW_BUCKET;
+}
+
+void EventQueue::LinkToBucket(u32 slot)
+{
+  Slot& s = m_slots[slot];
+  s.bucket = GetBucket(s.event.time);
+  s.prev = INVALID_SLOT;
+  s.next = m_buckets[s.bucket];
+  if (s.next != INVALID_SLOT)
+    m_slots[s.next].prev = slot;
+  m_buckets[s.bucket] = slot;
+
+  if (s.bucket != OVERFLOW_BUCKET)
+    m_occupied[s.bucket / WHEEL_BUCKETS] |= UINT64_C(1) << (s.bucket % WHEEL_BUCKETS);
+}
+
+void EventQueue::UnlinkFromBucket(u32 slot)
+{
+  Slot& s = m_slots[slot];
+  if (s.prev != INVALID_SLOT)
+    m_slots[s.prev].next = s.next;
+  else
+    m_buckets[s.bucket] = s.next;
+  if (s.next != INVALID_SLOT)
+    m_slots[s.next].prev = s.prev;
+
+  if (s.bucket != OVERFLOW_BUCKET && m_buckets[s.bucket] == INVALID_SLOT)
+    m_occupied[s.bucket / WHEEL_BUCKETS] &= ~(UINT64_C(1) << (s.bucket % WHEEL_BUCKETS));
+}
+
+u32 EventQueue::Insert(const Event& event)
+{
+  // Keep the wheel close to the events it holds, since m_base only moves forward otherwise.
+  if (m_size == 0)
+    m_base = event.time;
+
+  u32 slot = m_free_slots;
+  if (slot != INVALID_SLOT)
+  {
+    m_free_slots = m_slots[slot].next;
+  }
+  else
+  {
+    slot = static_cast<u32>(m_slots.size());
+    m_slots.emplace_back();
+  }
+
+  Slot& s = m_slots[slot];
+  s.event = event;
+  LinkToBucket(slot);
+
+  if (m_earliest != INVALID_SLOT && event < m_slots[m_earliest].event)
+    m_earliest = slot;
+
+  const auto type_iter = m_first_of_type.try_emplace(event.type, INVALID_SLOT).first;
+  s.type_prev = INVALID_SLOT;
+  s.type_next = type_iter->second;
+  if (s.type_next != INVALID_SLOT)
+    m_slots[s.type_next].type_prev = slot;
+  type_iter->second = slot;
+
+  ++m_size;
+  return slot;
+}
+
+void EventQueue::Remove(u32 slot)
+{
+  if (slot == m_earliest)
+    m_earliest = INVALID_SLOT;
+
+  UnlinkFromBucket(slot);
+
+  Slot& s = m_slots[slot];
+  if (s.type_prev != INVALID_SLOT)
+    m_slots[s.type_prev].type_next = s.type_next;
+  else
+    m_first_of_type[s.event.type] = s.type_next;
+  if (s.type_next != INVALID_SLOT)
+    m_slots[s.type_next].type_prev = s.type_prev;
+
+  ++s.generation;
+  s.bucket = NO_BUCKET;
+  s.next = m_free_slots;
+  m_free_slots = slot;
+  --m_size;
+}
+
+void EventQueue::RemoveAllOfType(const EventType* type)
+{
+  const auto iter = m_first_of_type.find(type);
+  if (iter == m_first_of_type.end())
+    return;
+
+  while (iter->second != INVALID_SLOT)
+    Remove(iter->second);
+}
+
+void EventQueue::Clear()
+{
+  for (u32 slot = 0; slot < m_slots.size(); ++slot)
+  {
+    if (m_slots[slot].bucket != NO_BUCKET)
+      Remove(slot);
+  }
+  m_first_of_type.clear();
+}
+
+bool EventQueue::IsPending(EventHandle handle) const
+{
+  return handle.slot < m_slots.size() && m_slots[handle.slot].bucket != NO_BUCKET &&
+         m_slots[handle.slot].generation == handle.generation;
+}
+
+void EventQueue::Cascade()
+{
+  while (m_occupied[0] == 0 && m_size != 0)
+  {
+    u32 bucket = OVERFLOW_BUCKET;
+    for (u32 level = 1; level < WHEEL_LEVELS; ++level)
+    {
+      if (m_occupied[level] != 0)
+      {
+        const u32 index = Common::LeastSignificantSetBit(m_occupied[level]);
+        bucket = level * WHEEL_BUCKETS + index;
+
+        // Move the wheel forward to the start of that bucket. All lower levels are empty.
+        const u64 mask = (UINT64_C(1) << LevelShift(level + 1)) - 1;
+        m_base = FromKey((ToKey(m_base) & ~mask) | (u64{index} << LevelShift(level)));
+        break;
+      }
+    }
+
+    if (bucket == OVERFLOW_BUCKET)
+    {
+      m_base = std::numeric_limits<s64>::max();
+      for (u32 slot = m_buckets[bucket]; slot != INVALID_SLOT; slot = m_slots[slot].next)
+        m_base = std::min(m_base, m_slots[slot].event.time);
+    }
+
+    // Every event in the bucket now lands in a lower level (or stays in the overflow list).
+    u32 slot = m_buckets[bucket];
+    m_buckets[bucket] = INVALID_SLOT;
+    if (bucket != OVERFLOW_BUCKET)
+      m_occupied[bucket / WHEEL_BUCKETS] &= ~(UINT64_C(1) << (bucket % WHEEL_BUCKETS));
+    while (slot != INVALID_SLOT)
+    {
+      const u32 next = m_slots[slot].next;
+      LinkToBucket(slot);
+      slot = next;
+    }
+  }
+}
+
+u32 EventQueue::FindEarliest()
+{
+  if (m_earliest != INVALID_SLOT || m_size == 0)
+    return m_earliest;
+
+  Cascade();
+
+  const u32 bucket = Common::LeastSignificantSetBit(m_occupied[0]);
+  u32 earliest = m_buckets[bucket];
+  for (u32 slot = m_slots[earliest].next; slot != INVALID_SLOT; slot = m_slots[slot].next)
+  {
+    if (m_slots[slot].event < m_slots[earliest].event)
+      earliest = slot;
+  }
+  m_earliest = earliest;
+  return earliest;
+}
+
+const Event* EventQueue::Peek()
+{
+  const u32 slot = FindEarliest();
+  return slot != INVALID_SLOT ? &m_slots[slot].event : nullptr;
+}
+
+Event EventQueue::Pop()
+{
+  const u32 slot = FindEarliest();
+  const Event event = m_slots[slot].event;
+  Remove(slot);
+  return event;
+}
+
+std::vector<Event> EventQueue::GetSortedEvents() const
+{
+  std::vector<Event> events;
+  events.reserve(m_size);
+  for (const Slot& slot : m_slots)
+  {
+    if (slot.bucket != NO_BUCKET)
+      events.push_back(slot.event);
+  }
+  std::sort(events.begin(), events.end());
+  return events;
+}
+
+template <typename Function>
+void EventQueue::AdjustTimes(Function function)
+{
+  m_buckets.fill(INVALID_SLOT);
+  m_occupied.fill(0);
+  m_earliest = INVALID_SLOT;
+
+  s64 base = std::numeric_limits<s64>::max();
+  for (Slot& slot : m_slots)
+  {
+    if (slot.bucket != NO_BUCKET)
+    {
+      slot.event.time = function(slot.event.time);
+      base = std::min(base, slot.event.time);
+    }
+  }
+  m_base = base;
+
+  for (u32 slot = 0; slot < m_slots.size(); ++slot)
+  {
+    if (m_slots[slot].bucket != NO_BUCKET)
+      LinkToBucket(slot);
+  }
+}
+
 // unordered_map stores each element separately as a linked list node so pointers to elements
 // remain stable regardless of rehashes/resizing.
 static std::unordered_map<std::string, EventType> s_event_types;
 
 // STATE_TO_SAVE
-// The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-// We don't use std::priority_queue because we need to be able to serialize, unserialize and
-// erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't accomodated
-// by the standard adaptor class.
-static std::vector<Event> s_event_queue;
+static EventQueue s_event_queue;
 static u64 s_event_fifo_id;
 static std::mutex s_ts_write_lock;
 static Common::SPSCQueue<Event, false> s_ts_queue;
@@ -120,7 +442,7 @@ EventType* RegisterEvent(const std::string& name, TimedCallback callback)
 
 void UnregisterAllEvents()
 {
-  ASSERT_MSG(POWERPC, s_event_queue.empty(), "Cannot unregister events with events pending");
+  ASSERT_MSG(POWERPC, s_event_queue.IsEmpty(), "Cannot unregister events with events pending");
   s_event_types.clear();
 }
 
@@ -181,7 +503,14 @@ void DoState(PointerWrap& p)
   p.DoMarker("CoreTimingData");
 
   MoveEvents();
-  p.DoEachElement(s_event_queue, [](PointerWrap& pw, Event& ev) {
+
+  // The events are stored as a plain list, in the same format as before the queue was a timing
+  // wheel. Their order in the list doesn't matter, since fifo_order is saved along with them.
+  std::vector<Event> events;
+  if (!p.IsReadMode())
+    events = s_event_queue.GetSortedEvents();
+
+  p.DoEachElement(events, [](PointerWrap& pw, Event& ev) {
     pw.Do(ev.time);
     pw.Do(ev.fifo_order);
 
@@ -214,11 +543,12 @@ void DoState(PointerWrap& p)
   });
   p.DoMarker("CoreTimingEvents");
 
-  // When loading from a save state, we must assume the Event order is random and meaningless.
-  // The exact layout of the heap in memory is implementation defined, therefore it is platform
-  // and library version specific.
   if (p.IsReadMode())
-    std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+  {
+    s_event_queue.Clear();
+    for (const Event& ev : events)
+      s_event_queue.Insert(ev);
+  }
 }
 
 // This should only be called from the CPU thread. If you are calling
@@ -241,10 +571,11 @@ u64 GetIdleTicks()
 
 void ClearPendingEvents()
 {
-  s_event_queue.clear();
+  s_event_queue.Clear();
 }
 
-void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata, FromThread from)
+EventHandle ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
+                          FromThread from)
 {
   ASSERT_MSG(POWERPC, event_type, "Event type is nullptr, will crash now.");
 
@@ -269,8 +600,8 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
     if (!s_is_global_timer_sane)
       ForceExceptionCheck(cycles_into_future);
 
-    s_event_queue.emplace_back(Event{timeout, s_event_fifo_id++, userdata, event_type});
-    std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    const u32 slot = s_event_queue.Insert(Event{timeout, s_event_fifo_id++, userdata, event_type});
+    return EventHandle{slot, s_event_queue.GetGeneration(slot)};
   }
   else
   {
@@ -284,20 +615,19 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
 
     std::lock_guard lk(s_ts_write_lock);
     s_ts_queue.Push(Event{g.global_timer + cycles_into_future, 0, userdata, event_type});
+    return EventHandle{};
   }
 }
 
 void RemoveEvent(EventType* event_type)
 {
-  auto itr = std::remove_if(s_event_queue.begin(), s_event_queue.end(),
-                            [&](const Event& e) { return e.type == event_type; });
+  s_event_queue.RemoveAllOfType(event_type);
+}
 
-  // Removing random items breaks the invariant so we have to re-establish it.
-  if (itr != s_event_queue.end())
-  {
-    s_event_queue.erase(itr, s_event_queue.end());
-    std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-  }
+void RemoveEvent(EventHandle handle)
+{
+  if (s_event_queue.IsPending(handle))
+    s_event_queue.Remove(handle.slot);
 }
 
 void RemoveAllEvents(EventType* event_type)
@@ -323,8 +653,7 @@ void MoveEvents()
   for (Event ev; s_ts_queue.Pop(ev);)
   {
     ev.fifo_order = s_event_fifo_id++;
-    s_event_queue.emplace_back(std::move(ev));
-    std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    s_event_queue.Insert(ev);
   }
 }
 
@@ -340,21 +669,20 @@ void Advance()
 
   s_is_global_timer_sane = true;
 
-  while (!s_event_queue.empty() && s_event_queue.front().time <= g.global_timer)
+  for (const Event* next = s_event_queue.Peek(); next && next->time <= g.global_timer;
+       next = s_event_queue.Peek())
   {
-    Event evt = std::move(s_event_queue.front());
-    std::pop_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-    s_event_queue.pop_back();
+    const Event evt = s_event_queue.Pop();
     evt.type->callback(evt.userdata, g.global_timer - evt.time);
   }
 
   s_is_global_timer_sane = false;
 
   // Still events left (scheduled in the future)
-  if (!s_event_queue.empty())
+  if (const Event* next = s_event_queue.Peek())
   {
-    g.slice_length = static_cast<int>(
-        std::min<s64>(s_event_queue.front().time - g.global_timer, MAX_SLICE_LENGTH));
+    g.slice_length =
+        static_cast<int>(std::min<s64>(next->time - g.global_timer, MAX_SLICE_LENGTH));
   }
 
   PowerPC::ppcState.downcount = CyclesToDowncount(g.slice_length);
@@ -368,9 +696,7 @@ void Advance()
 
 void LogPendingEvents()
 {
-  auto clone = s_event_queue;
-  std::sort(clone.begin(), clone.end());
-  for (const Event& ev : clone)
+  for (const Event& ev : s_event_queue.GetSortedEvents())
   {
     INFO_LOG_FMT(POWERPC, "PENDING: Now: {} Pending: {} Type: {}", g.global_timer, ev.time,
                  *ev.type->name);
@@ -380,11 +706,10 @@ void LogPendingEvents()
 // Should only be called from the CPU thread after the PPC clock has changed
 void AdjustEventQueueTimes(u32 new_ppc_clock, u32 old_ppc_clock)
 {
-  for (Event& ev : s_event_queue)
-  {
-    const s64 ticks = (ev.time - g.global_timer) * new_ppc_clock / old_ppc_clock;
-    ev.time = g.global_timer + ticks;
-  }
+  s_event_queue.AdjustTimes([&](s64 time) {
+    const s64 ticks = (time - g.global_timer) * new_ppc_clock / old_ppc_clock;
+    return g.global_timer + ticks;
+  });
 }
 
 void Idle()
@@ -407,9 +732,7 @@ std::string GetScheduledEventsSummary()
   std::string text = "Scheduled events\n";
   text.reserve(1000);
 
-  auto clone = s_event_queue;
-  std::sort(clone.begin(), clone.end());
-  for (const Event& ev : clone)
+  for (const Event& ev : s_event_queue.GetSortedEvents())
   {
     text += fmt::format("{} : {} {:016x}\n", *ev.type->name, ev.time, ev.userdata);
   }
@@ -52,6 +52,15 @@ void DoState(PointerWrap& p);
 
 struct EventType;
 
+// Identifies a single scheduled event, so that it can be removed without affecting other events
+// of the same type. A handle stays safe to use after its event has run or has been removed;
+// removing it again simply does nothing.
+struct EventHandle
+{
+  u32 slot = UINT32_MAX;
+  u32 generation = 0;
+};
+
 // Returns the event_type identifier. if name is not unique, an existing event_type will be
 // discarded.
 EventType* RegisterEvent(const std::string& name, TimedCallback callback);
@@ -70,11 +79,14 @@ enum class FromThread
 // After the first Advance, the slice lengths and the downcount will be reduced whenever an event
 // is scheduled earlier than the current values (when scheduled from the CPU Thread only).
 // Scheduling from a callback will not update the downcount until the Advance() completes.
-void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata = 0,
-                   FromThread from = FromThread::CPU);
+// Events scheduled from outside the CPU thread get an empty handle, since they only enter the
+// queue during the next Advance().
+EventHandle ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata = 0,
+                          FromThread from = FromThread::CPU);
 
 // We only permit one event of each type in the queue at a time.
 void RemoveEvent(EventType* event_type);
+void RemoveEvent(EventHandle handle);
 void RemoveAllEvents(EventType* event_type);
 
 // Advance must be called at the beginning of dispatcher loops, not the end. Advance() ends
@@ -6,9 +6,16 @@
 #include <algorithm>
 #include <cstring>
 #include <memory>
+#include <random>
 #include <string>
 #include <vector>
 
+#include <fmt/format.h>
+#include <zstd.h>
+
+#include "Common/Assert.h"
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
 #include "Common/IOFile.h"
 #include "Common/MsgHandler.h"
 #include "Core/Config/MainSettings.h"
@@ -17,13 +24,18 @@
 enum
 {
   FILE_ID = 0x0d01f1f0,
-  VERSION_NUMBER = 5,
-  MIN_LOADER_VERSION = 1,
-  // This value is only used if the DFF file was created with overridden RAM sizes.
-  // If the MIN_LOADER_VERSION ever exceeds this, it's alright to remove it.
-  MIN_LOADER_VERSION_FOR_RAM_OVERRIDE = 5,
+  VERSION_NUMBER = 6,
+  // Frames are compressed since version 6, which older versions have no way of reading.
+  MIN_LOADER_VERSION = 6,
 };
 
+// Recording compresses frames on the video thread, so favor speed over size.
+constexpr int COMPRESSION_LEVEL = 1;
+
+// Enough to play back a few frames ahead of the current one while the analyzer looks at another.
+constexpr size_t MAX_CACHED_FRAMES = 8;
+constexpr u32 READ_AHEAD_FRAMES = 4;
+
 #pragma pack(push, 1)
 
 struct FileHeader
@@ -60,7 +72,12 @@ struct FileFrameInfo
   u32 fifoEnd;
   u64 memoryUpdatesOffset;
   u32 numMemoryUpdates;
-  u8 reserved[32];
+  // Added in version 6, which stores each frame as a single compressed block at fifoDataOffset.
+  // The block holds the FIFO data, the memory update list and the memory update data, and the
+  // offsets of the memory updates are relative to the start of the block.
+  u32 compressedSize;
+  u32 uncompressedSize;
+  u8 reserved[24];
 };
 static_assert(sizeof(FileFrameInfo) == 64, "FileFrameInfo should be 64 bytes");
 
@@ -79,7 +96,13 @@ static_assert(sizeof(FileMemoryUpdate) == 24, "FileMemoryUpdate should be 24 byt
 
 FifoDataFile::FifoDataFile() = default;
 
-FifoDataFile::~FifoDataFile() = default;
+FifoDataFile::~FifoDataFile()
+{
+  m_ReadAheadThread.Cancel();
+  m_FrameFile.Close();
+  if (!m_TemporaryFilename.empty())
+    File::Delete(m_TemporaryFilename);
+}
 
 bool FifoDataFile::ShouldGenerateFakeVIUpdates() const
 {
@@ -101,9 +124,99 @@ bool FifoDataFile::GetIsWii() const
   return GetFlag(FLAG_IS_WII);
 }
 
-void FifoDataFile::AddFrame(const FifoFrameInfo& frameInfo)
+bool FifoDataFile::AddFrame(const FifoFrameInfo& frameInfo)
 {
-  m_Frames.push_back(frameInfo);
+  std::lock_guard lk(m_FrameFileMutex);
+
+  // The error has been shown already. Leaving out frames would break the recording, so the frames
+  // that were written before are all that is kept.
+  if (m_AddFrameFailed)
+    return false;
+
+  if (!m_FrameFile.IsOpen())
+  {
+    // Another recording, possibly in another instance of Dolphin, may be using the cache at the
+    // same time, so every recording gets a file of its own.
+    std::random_device random_device;
+    std::string filename;
+    do
+    {
+      filename = fmt::format("{}FifoRecording-{:08x}{:08x}.tmp", File::GetUserPath(D_CACHE_IDX),
+                             random_device(), random_device());
+    } while (File::Exists(filename));
+    File::CreateFullPath(filename);
+    if (!m_FrameFile.Open(filename, "w+b"))
+    {
+      PanicAlertFmtT("Failed to create the temporary file {0} for the FIFO log.", filename);
+      m_AddFrameFailed = true;
+      return false;
+    }
+    m_TemporaryFilename = filename;
+    m_CompressedFrames = true;
+  }
+
+  // Frames can only be added to a recording, not to a loaded file.
+  ASSERT(!m_TemporaryFilename.empty());
+
+  FrameEntry entry;
+  const std::vector<u8> block = CompressFrame(frameInfo, &entry);
+
+  m_FrameFile.Seek(0, File::SeekOrigin::End);
+  entry.dataOffset = m_FrameFile.Tell();
+  if (!m_FrameFile.WriteBytes(block.data(), block.size()))
+  {
+    PanicAlertFmtT("Failed to write to the temporary file {0} for the FIFO log.",
+                   m_TemporaryFilename);
+    m_FrameFile.ClearError();
+    m_AddFrameFailed = true;
+    return false;
+  }
+
+  m_FrameIndex.push_back(entry);
+  return true;
+}
+
+u64 FifoDataFile::GetFifoDataSize() const
+{
+  u64 size = 0;
+  for (const FrameEntry& entry : m_FrameIndex)
+    size += entry.fifoDataSize;
+  return size;
+}
+
+u64 FifoDataFile::GetMemoryUpdateDataSize() const
+{
+  u64 size = 0;
+  if (!m_CompressedFrames)
+  {
+    // Files older than version 6 don't store the block sizes, but reading the memory update lists
+    // is still much cheaper than reading the data they describe.
+    std::lock_guard lk(m_FrameFileMutex);
+    std::vector<FileMemoryUpdate> updates;
+    for (const FrameEntry& entry : m_FrameIndex)
+    {
+      updates.resize(entry.numMemoryUpdates);
+      m_FrameFile.Seek(entry.memoryUpdatesOffset, File::SeekOrigin::Begin);
+      if (!m_FrameFile.ReadArray(updates.data(), updates.size()))
+      {
+        m_FrameFile.ClearError();
+        continue;
+      }
+      for (const FileMemoryUpdate& update : updates)
+        size += update.dataSize;
+    }
+    return size;
+  }
+
+  for (const FrameEntry& entry : m_FrameIndex)
+  {
+    // The FIFO data and the memory update list come before the memory update data in a block.
+    const u64 data_offset =
+        entry.fifoDataSize + u64{entry.numMemoryUpdates} * sizeof(FileMemoryUpdate);
+    if (entry.uncompressedSize > data_offset)
+      size += entry.uncompressedSize - data_offset;
+  }
+  return size;
 }
 
 bool FifoDataFile::Save(const std::string& filename)
@@ -115,10 +228,6 @@ bool FifoDataFile::Save(const std::string& filename)
   // Add space for header
   PadFile(sizeof(FileHeader), file);
 
-  // Add space for frame list
-  u64 frameListOffset = file.Tell();
-  PadFile(m_Frames.size() * sizeof(FileFrameInfo), file);
-
   u64 bpMemOffset = file.Tell();
   file.WriteArray(m_BPMem);
 
@@ -134,15 +243,38 @@ bool FifoDataFile::Save(const std::string& filename)
   u64 texMemOffset = file.Tell();
   file.WriteArray(m_TexMem);
 
+  // Write frames one at a time. Compressed frames are copied as they are.
+  std::vector<FileFrameInfo> frameList(m_FrameIndex.size());
+  for (u32 i = 0; i < m_FrameIndex.size(); ++i)
+  {
+    FrameEntry entry = m_FrameIndex[i];
+    const std::vector<u8> block =
+        m_CompressedFrames ? ReadCompressedFrame(i) : CompressFrame(*ReadFrame(i), &entry);
+    if (block.size() != entry.compressedSize)
+      return false;
+
+    FileFrameInfo& dstFrame = frameList[i];
+    dstFrame.fifoDataOffset = file.Tell();
+    dstFrame.fifoDataSize = entry.fifoDataSize;
+    dstFrame.fifoStart = entry.fifoStart;
+    dstFrame.fifoEnd = entry.fifoEnd;
+    dstFrame.memoryUpdatesOffset = entry.memoryUpdatesOffset;
+    dstFrame.numMemoryUpdates = entry.numMemoryUpdates;
+    dstFrame.compressedSize = entry.compressedSize;
+    dstFrame.uncompressedSize = entry.uncompressedSize;
+
+    file.WriteBytes(block.data(), block.size());
+  }
+
+  // Write frames list
+  u64 frameListOffset = file.Tell();
+  file.WriteArray(frameList.data(), frameList.size());
+
   // Write header
-  FileHeader header;
+  FileHeader header{};
   header.fileId = FILE_ID;
   header.file_version = VERSION_NUMBER;
-  // Maintain backwards compatability so long as the RAM sizes aren't overridden.
-  if (Config::Get(Config::MAIN_RAM_OVERRIDE_ENABLE))
-    header.min_loader_version = MIN_LOADER_VERSION_FOR_RAM_OVERRIDE;
-  else
-    header.min_loader_version = MIN_LOADER_VERSION;
+  header.min_loader_version = MIN_LOADER_VERSION;
 
   header.bpMemOffset = bpMemOffset;
   header.bpMemSize = BP_MEM_SIZE;
@@ -160,7 +292,7 @@ bool FifoDataFile::Save(const std::string& filename)
   header.texMemSize = TEX_MEM_SIZE;
 
   header.frameListOffset = frameListOffset;
-  header.frameCount = (u32)m_Frames.size();
+  header.frameCount = static_cast<u32>(m_FrameIndex.size());
 
   header.flags = m_Flags;
 
@@ -170,36 +302,11 @@ bool FifoDataFile::Save(const std::string& filename)
   file.Seek(0, File::SeekOrigin::Begin);
   file.WriteBytes(&header, sizeof(FileHeader));
 
-  // Write frames list
-  for (unsigned int i = 0; i < m_Frames.size(); ++i)
-  {
-    const FifoFrameInfo& srcFrame = m_Frames[i];
-
-    // Write FIFO data
-    file.Seek(0, File::SeekOrigin::End);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcFrame.fifoData.data(), srcFrame.fifoData.size());
-
-    u64 memoryUpdatesOffset = WriteMemoryUpdates(srcFrame.memoryUpdates, file);
-
-    FileFrameInfo dstFrame;
-    dstFrame.fifoDataSize = static_cast<u32>(srcFrame.fifoData.size());
-    dstFrame.fifoDataOffset = dataOffset;
-    dstFrame.fifoStart = srcFrame.fifoStart;
-    dstFrame.fifoEnd = srcFrame.fifoEnd;
-    dstFrame.memoryUpdatesOffset = memoryUpdatesOffset;
-    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame.memoryUpdates.size());
-
-    // Write frame info
-    u64 frameOffset = frameListOffset + (i * sizeof(FileFrameInfo));
-    file.Seek(frameOffset, File::SeekOrigin::Begin);
-    file.WriteBytes(&dstFrame, sizeof(FileFrameInfo));
-  }
-
+  const bool good = file.IsGood();
   if (!file.Close())
     return false;
 
-  return true;
+  return good;
 }
 
 std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bool flagsOnly)
@@ -315,32 +422,35 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
   dataFile->m_ram_size_real = header.mem1_size;
   dataFile->m_exram_size_real = header.mem2_size;
 
-  // Read frames
-  for (u32 i = 0; i < header.frameCount; ++i)
+  // Read the frame list. The frames themselves are only read when they are needed.
+  std::vector<FileFrameInfo> frameList(header.frameCount);
+  file.Seek(header.frameListOffset, File::SeekOrigin::Begin);
+  if (!file.ReadArray(frameList.data(), frameList.size()))
+    return panic_failed_to_read();
+
+  dataFile->m_CompressedFrames = dataFile->m_Version >= 6;
+  dataFile->m_FrameIndex.reserve(frameList.size());
+  for (const FileFrameInfo& srcFrame : frameList)
   {
-    u64 frameOffset = header.frameListOffset + (i * sizeof(FileFrameInfo));
-    file.Seek(frameOffset, File::SeekOrigin::Begin);
-    FileFrameInfo srcFrame;
-    if (!file.ReadBytes(&srcFrame, sizeof(FileFrameInfo)))
-      return panic_failed_to_read();
-
-    FifoFrameInfo dstFrame;
-    dstFrame.fifoData.resize(srcFrame.fifoDataSize);
+    FrameEntry& dstFrame = dataFile->m_FrameIndex.emplace_back();
+    dstFrame.dataOffset = srcFrame.fifoDataOffset;
+    dstFrame.fifoDataSize = srcFrame.fifoDataSize;
     dstFrame.fifoStart = srcFrame.fifoStart;
     dstFrame.fifoEnd = srcFrame.fifoEnd;
-
-    file.Seek(srcFrame.fifoDataOffset, File::SeekOrigin::Begin);
-    file.ReadBytes(dstFrame.fifoData.data(), srcFrame.fifoDataSize);
-
-    ReadMemoryUpdates(srcFrame.memoryUpdatesOffset, srcFrame.numMemoryUpdates,
-                      dstFrame.memoryUpdates, file);
-
-    if (!file.IsGood())
-      return panic_failed_to_read();
-
-    dataFile->AddFrame(dstFrame);
+    dstFrame.memoryUpdatesOffset = srcFrame.memoryUpdatesOffset;
+    dstFrame.numMemoryUpdates = srcFrame.numMemoryUpdates;
+    if (dataFile->m_CompressedFrames)
+    {
+      dstFrame.compressedSize = srcFrame.compressedSize;
+      dstFrame.uncompressedSize = srcFrame.uncompressedSize;
+    }
   }
 
+  dataFile->m_FrameFile = std::move(file);
+  dataFile->m_ReadAheadEnabled = true;
+  dataFile->m_ReadAheadThread.Reset(
+      [data_file = dataFile.get()](u32 frame) { data_file->ReadAhead(frame); });
+
   return dataFile;
 }
 
@@ -363,35 +473,228 @@ bool FifoDataFile::GetFlag(u32 flag) const
   return !!(m_Flags & flag);
 }
 
-u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates,
-                                     File::IOFile& file)
+std::vector<u8> FifoDataFile::SerializeFrame(const FifoFrameInfo& frame)
 {
-  // Add space for memory update list
-  u64 updateListOffset = file.Tell();
-  PadFile(memUpdates.size() * sizeof(FileMemoryUpdate), file);
+  const size_t updateListOffset = frame.fifoData.size();
+  size_t dataOffset = updateListOffset + frame.memoryUpdates.size() * sizeof(FileMemoryUpdate);
 
-  for (unsigned int i = 0; i < memUpdates.size(); ++i)
-  {
-    const MemoryUpdate& srcUpdate = memUpdates[i];
+  size_t size = dataOffset;
+  for (const MemoryUpdate& update : frame.memoryUpdates)
+    size += update.data.size();
+
+  std::vector<u8> block(size);
+  std::copy(frame.fifoData.begin(), frame.fifoData.end(), block.begin());
 
-    // Write memory
-    file.Seek(0, File::SeekOrigin::End);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcUpdate.data.data(), srcUpdate.data.size());
+  for (size_t i = 0; i < frame.memoryUpdates.size(); ++i)
+  {
+    const MemoryUpdate& srcUpdate = frame.memoryUpdates[i];
 
-    FileMemoryUpdate dstUpdate;
+    FileMemoryUpdate dstUpdate{};
     dstUpdate.address = srcUpdate.address;
     dstUpdate.dataOffset = dataOffset;
     dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
     dstUpdate.fifoPosition = srcUpdate.fifoPosition;
     dstUpdate.type = srcUpdate.type;
+    std::memcpy(&block[updateListOffset + i * sizeof(FileMemoryUpdate)], &dstUpdate,
+                sizeof(FileMemoryUpdate));
 
-    u64 updateOffset = updateListOffset + (i * sizeof(FileMemoryUpdate));
-    file.Seek(updateOffset, File::SeekOrigin::Begin);
-    file.WriteBytes(&dstUpdate, sizeof(FileMemoryUpdate));
+    std::copy(srcUpdate.data.begin(), srcUpdate.data.end(), block.begin() + dataOffset);
+    dataOffset += srcUpdate.data.size();
+  }
+
+  return block;
+}
+
+std::vector<u8> FifoDataFile::CompressFrame(const FifoFrameInfo& frame, FrameEntry* entry)
+{
+  const std::vector<u8> block = SerializeFrame(frame);
+
+  std::vector<u8> compressed(ZSTD_compressBound(block.size()));
+  const size_t compressedSize = ZSTD_compress(compressed.data(), compressed.size(), block.data(),
+                                              block.size(), COMPRESSION_LEVEL);
+  // This can only fail for a too small output buffer.
+  ASSERT(!ZSTD_isError(compressedSize));
+  compressed.resize(compressedSize);
+
+  entry->fifoDataSize = static_cast<u32>(frame.fifoData.size());
+  entry->fifoStart = frame.fifoStart;
+  entry->fifoEnd = frame.fifoEnd;
+  entry->memoryUpdatesOffset = frame.fifoData.size();
+  entry->numMemoryUpdates = static_cast<u32>(frame.memoryUpdates.size());
+  entry->compressedSize = static_cast<u32>(compressed.size());
+  entry->uncompressedSize = static_cast<u32>(block.size());
+  return compressed;
+}
+
+std::vector<u8> FifoDataFile::ReadCompressedFrame(u32 frame) const
+{
+  const FrameEntry& entry = m_FrameIndex[frame];
+  std::vector<u8> compressed(entry.compressedSize);
+
+  std::lock_guard lk(m_FrameFileMutex);
+  m_FrameFile.Seek(entry.dataOffset, File::SeekOrigin::Begin);
+  if (!m_FrameFile.ReadBytes(compressed.data(), compressed.size()))
+  {
+    m_FrameFile.ClearError();
+    return {};
   }
+  return compressed;
+}
 
-  return updateListOffset;
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::ReadFrame(u32 frame) const
+{
+  const FrameEntry& entry = m_FrameIndex[frame];
+
+  auto frameInfo = std::make_shared<FifoFrameInfo>();
+  frameInfo->fifoStart = entry.fifoStart;
+  frameInfo->fifoEnd = entry.fifoEnd;
+
+  // Playing back a broken frame as an empty one beats crashing on it.
+  const auto fail = [frame, &frameInfo] {
+    PanicAlertFmtT("Failed to read frame {0} of the DFF file.", frame);
+    frameInfo->fifoData.clear();
+    frameInfo->memoryUpdates.clear();
+    return frameInfo;
+  };
+
+  if (!m_CompressedFrames)
+  {
+    std::lock_guard lk(m_FrameFileMutex);
+
+    frameInfo->fifoData.resize(entry.fifoDataSize);
+    m_FrameFile.Seek(entry.dataOffset, File::SeekOrigin::Begin);
+    m_FrameFile.ReadBytes(frameInfo->fifoData.data(), entry.fifoDataSize);
+
+    ReadMemoryUpdates(entry.memoryUpdatesOffset, entry.numMemoryUpdates,
+                      frameInfo->memoryUpdates, m_FrameFile);
+
+    if (!m_FrameFile.IsGood())
+    {
+      m_FrameFile.ClearError();
+      return fail();
+    }
+    return frameInfo;
+  }
+
+  const std::vector<u8> compressed = ReadCompressedFrame(frame);
+  std::vector<u8> block(entry.uncompressedSize);
+  const size_t size =
+      ZSTD_decompress(block.data(), block.size(), compressed.data(), compressed.size());
+  if (ZSTD_isError(size) || size != block.size() || entry.fifoDataSize > size ||
+      entry.memoryUpdatesOffset > size ||
+      u64{entry.numMemoryUpdates} * sizeof(FileMemoryUpdate) > size - entry.memoryUpdatesOffset)
+  {
+    return fail();
+  }
+
+  frameInfo->fifoData.assign(block.begin(), block.begin() + entry.fifoDataSize);
+
+  frameInfo->memoryUpdates.resize(entry.numMemoryUpdates);
+  for (u32 i = 0; i < entry.numMemoryUpdates; ++i)
+  {
+    FileMemoryUpdate srcUpdate;
+    std::memcpy(&srcUpdate, &block[entry.memoryUpdatesOffset + i * sizeof(FileMemoryUpdate)],
+                sizeof(FileMemoryUpdate));
+    if (srcUpdate.dataOffset > size || srcUpdate.dataSize > size - srcUpdate.dataOffset)
+      return fail();
+
+    MemoryUpdate& dstUpdate = frameInfo->memoryUpdates[i];
+    dstUpdate.address = srcUpdate.address;
+    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+    dstUpdate.type = static_cast<MemoryUpdate::Type>(srcUpdate.type);
+    dstUpdate.data.assign(block.begin() + srcUpdate.dataOffset,
+                          block.begin() + srcUpdate.dataOffset + srcUpdate.dataSize);
+  }
+
+  return frameInfo;
+}
+
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::GetFrame(u32 frame) const
+{
+  std::shared_ptr<const FifoFrameInfo> frameInfo = FindCachedFrame(frame);
+  if (!frameInfo)
+  {
+    {
+      std::unique_lock lk(m_FrameCacheMutex);
+      m_ReadAheadDone.wait(lk, [this, frame] {
+        return std::find(m_PendingReadAheads.begin(), m_PendingReadAheads.end(), frame) ==
+               m_PendingReadAheads.end();
+      });
+    }
+
+    // The frame that was read ahead may have been pushed out of the cache again already.
+    frameInfo = FindCachedFrame(frame);
+    if (!frameInfo)
+    {
+      frameInfo = ReadFrame(frame);
+      CacheFrame(frame, frameInfo);
+    }
+  }
+
+  if (m_ReadAheadEnabled)
+  {
+    std::lock_guard lk(m_FrameCacheMutex);
+
+    const u32 end = static_cast<u32>(
+        std::min<u64>(u64{frame} + 1 + READ_AHEAD_FRAMES, m_FrameIndex.size()));
+    for (u32 i = frame + 1; i < end; ++i)
+    {
+      const bool cached = std::any_of(m_FrameCache.begin(), m_FrameCache.end(),
+                                      [i](const auto& item) { return item.first == i; });
+      const bool pending = std::find(m_PendingReadAheads.begin(), m_PendingReadAheads.end(), i) !=
+                           m_PendingReadAheads.end();
+      if (cached || pending)
+        continue;
+
+      m_PendingReadAheads.push_back(i);
+      m_ReadAheadThread.EmplaceItem(i);
+    }
+  }
+
+  return frameInfo;
+}
+
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::FindCachedFrame(u32 frame) const
+{
+  std::lock_guard lk(m_FrameCacheMutex);
+
+  const auto it = std::find_if(m_FrameCache.begin(), m_FrameCache.end(),
+                               [frame](const auto& item) { return item.first == frame; });
+  if (it == m_FrameCache.end())
+    return nullptr;
+
+  // Move it to the back, making it the most recently used frame.
+  std::rotate(it, it + 1, m_FrameCache.end());
+  return m_FrameCache.back().second;
+}
+
+void FifoDataFile::CacheFrame(u32 frame, std::shared_ptr<const FifoFrameInfo> frameInfo) const
+{
+  std::lock_guard lk(m_FrameCacheMutex);
+
+  // Another thread might have read the same frame in the meantime.
+  if (std::any_of(m_FrameCache.begin(), m_FrameCache.end(),
+                  [frame](const auto& item) { return item.first == frame; }))
+  {
+    return;
+  }
+
+  if (m_FrameCache.size() == MAX_CACHED_FRAMES)
+    m_FrameCache.erase(m_FrameCache.begin());
+  m_FrameCache.emplace_back(frame, std::move(frameInfo));
+}
+
+void FifoDataFile::ReadAhead(u32 frame) const
+{
+  if (!FindCachedFrame(frame))
+    CacheFrame(frame, ReadFrame(frame));
+
+  {
+    std::lock_guard lk(m_FrameCacheMutex);
+    m_PendingReadAheads.erase(
+        std::find(m_PendingReadAheads.begin(), m_PendingReadAheads.end(), frame));
+  }
+  m_ReadAheadDone.notify_all();
 }
 
 void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
@@ -4,18 +4,18 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "Common/WorkQueueThread.h"
 #include "VideoCommon/XFMemory.h"
 
-namespace File
-{
-class IOFile;
-}
-
 struct MemoryUpdate
 {
   enum Type
@@ -72,9 +72,19 @@ public:
   u32 GetRamSizeReal() { return m_ram_size_real; }
   u32 GetExRamSizeReal() { return m_exram_size_real; }
 
-  void AddFrame(const FifoFrameInfo& frameInfo);
-  const FifoFrameInfo& GetFrame(u32 frame) const { return m_Frames[frame]; }
-  u32 GetFrameCount() const { return static_cast<u32>(m_Frames.size()); }
+  // Compresses the frame and appends it to a temporary file right away, so that a recording only
+  // ever holds on to the frame being recorded. Returns false if the frame couldn't be written, in
+  // which case no further frames are accepted either.
+  bool AddFrame(const FifoFrameInfo& frameInfo);
+  // Frames are read from the file when they are first needed, and the frames following a frame
+  // are read ahead in the background. Only a few frames are kept in memory at a time. A frame that
+  // is being read ahead is waited for rather than read a second time.
+  std::shared_ptr<const FifoFrameInfo> GetFrame(u32 frame) const;
+  u32 GetFrameCount() const { return static_cast<u32>(m_FrameIndex.size()); }
+  // The total size of the FIFO data and of the memory update data of all frames. Neither has to
+  // read the frames themselves.
+  u64 GetFifoDataSize() const;
+  u64 GetMemoryUpdateDataSize() const;
   bool Save(const std::string& filename);
 
   static std::unique_ptr<FifoDataFile> Load(const std::string& filename, bool flagsOnly);
@@ -85,15 +95,36 @@ private:
     FLAG_IS_WII = 1
   };
 
+  // Where a frame is stored in m_FrameFile. For compressed frames, dataOffset is the offset of the
+  // compressed block, and memoryUpdatesOffset is relative to the start of the uncompressed block.
+  struct FrameEntry
+  {
+    u64 dataOffset = 0;
+    u32 fifoDataSize = 0;
+    u32 fifoStart = 0;
+    u32 fifoEnd = 0;
+    u64 memoryUpdatesOffset = 0;
+    u32 numMemoryUpdates = 0;
+    u32 compressedSize = 0;
+    u32 uncompressedSize = 0;
+  };
+
   void PadFile(size_t numBytes, File::IOFile& file);
 
   void SetFlag(u32 flag, bool set);
   bool GetFlag(u32 flag) const;
 
-  u64 WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
+  static std::vector<u8> SerializeFrame(const FifoFrameInfo& frame);
+  static std::vector<u8> CompressFrame(const FifoFrameInfo& frame, FrameEntry* entry);
+  std::vector<u8> ReadCompressedFrame(u32 frame) const;
+  std::shared_ptr<const FifoFrameInfo> ReadFrame(u32 frame) const;
   static void ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
                                 std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
 
+  std::shared_ptr<const FifoFrameInfo> FindCachedFrame(u32 frame) const;
+  void CacheFrame(u32 frame, std::shared_ptr<const FifoFrameInfo> frame_info) const;
+  void ReadAhead(u32 frame) const;
+
   std::array<u32, BP_MEM_SIZE> m_BPMem{};
   std::array<u32, CP_MEM_SIZE> m_CPMem{};
   std::array<u32, XF_MEM_SIZE> m_XFMem{};
@@ -105,5 +136,21 @@ private:
   u32 m_Flags = 0;
   u32 m_Version = 0;
 
-  std::vector<FifoFrameInfo> m_Frames;
+  // The loaded file, or the temporary file frames are added to while recording.
+  mutable File::IOFile m_FrameFile;
+  mutable std::mutex m_FrameFileMutex;
+  std::string m_TemporaryFilename;
+  bool m_AddFrameFailed = false;
+  bool m_CompressedFrames = false;
+  std::vector<FrameEntry> m_FrameIndex;
+
+  // The most recently used frames, least recently used first.
+  mutable std::vector<std::pair<u32, std::shared_ptr<const FifoFrameInfo>>> m_FrameCache;
+  mutable std::vector<u32> m_PendingReadAheads;
+  mutable std::mutex m_FrameCacheMutex;
+  mutable std::condition_variable m_ReadAheadDone;
+  bool m_ReadAheadEnabled = false;
+
+  // Declared last so that it is stopped before anything it uses is destroyed.
+  mutable Common::WorkQueueThread<u32> m_ReadAheadThread;
 };
@@ -10,6 +10,7 @@
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/MsgHandler.h"
+#include "Common/Thread.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -36,7 +37,8 @@ namespace
 class FifoPlaybackAnalyzer : public OpcodeDecoder::Callback
 {
 public:
-  static void AnalyzeFrames(FifoDataFile* file, std::vector<AnalyzedFrameInfo>& frame_info);
+  // Frames have to be analyzed in order, since the CP state carries over from one to the next.
+  void AnalyzeFrame(const FifoFrameInfo& frame, AnalyzedFrameInfo& analyzed);
 
   explicit FifoPlaybackAnalyzer(const u32* cpmem) : m_cpmem(cpmem) {}
 
@@ -66,58 +68,47 @@ public:
   CPState m_cpmem;
 };
 
-void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file,
-                                         std::vector<AnalyzedFrameInfo>& frame_info)
+void FifoPlaybackAnalyzer::AnalyzeFrame(const FifoFrameInfo& frame, AnalyzedFrameInfo& analyzed)
 {
-  FifoPlaybackAnalyzer analyzer(file->GetCPMem());
-  frame_info.clear();
-  frame_info.resize(file->GetFrameCount());
+  u32 offset = 0;
 
-  for (u32 frame_no = 0; frame_no < file->GetFrameCount(); frame_no++)
-  {
-    const FifoFrameInfo& frame = file->GetFrame(frame_no);
-    AnalyzedFrameInfo& analyzed = frame_info[frame_no];
-
-    u32 offset = 0;
+  u32 part_start = 0;
+  CPState cpmem;
 
-    u32 part_start = 0;
-    CPState cpmem;
+  while (offset < frame.fifoData.size())
+  {
+    const u32 cmd_size = OpcodeDecoder::RunCommand(&frame.fifoData[offset],
+                                                   u32(frame.fifoData.size()) - offset, *this);
 
-    while (offset < frame.fifoData.size())
+    if (m_start_of_primitives)
     {
-      const u32 cmd_size = OpcodeDecoder::RunCommand(&frame.fifoData[offset],
-                                                     u32(frame.fifoData.size()) - offset, analyzer);
-
-      if (analyzer.m_start_of_primitives)
-      {
-        // Start of primitive data for an object
-        analyzed.AddPart(FramePartType::Commands, part_start, offset, analyzer.m_cpmem);
-        part_start = offset;
-        // Copy cpmem now, because end_of_primitives isn't triggered until the first opcode after
-        // primitive data, and the first opcode might update cpmem
-        std::memcpy(&cpmem, &analyzer.m_cpmem, sizeof(CPState));
-      }
-      if (analyzer.m_end_of_primitives)
-      {
-        // End of primitive data for an object, and thus end of the object
-        analyzed.AddPart(FramePartType::PrimitiveData, part_start, offset, cpmem);
-        part_start = offset;
-      }
+      // Start of primitive data for an object
+      analyzed.AddPart(FramePartType::Commands, part_start, offset, m_cpmem);
+      part_start = offset;
+      // Copy cpmem now, because end_of_primitives isn't triggered until the first opcode after
+      // primitive data, and the first opcode might update cpmem
+      std::memcpy(&cpmem, &m_cpmem, sizeof(CPState));
+    }
+    if (m_end_of_primitives)
+    {
+      // End of primitive data for an object, and thus end of the object
+      analyzed.AddPart(FramePartType::PrimitiveData, part_start, offset, cpmem);
+      part_start = offset;
+    }
 
-      offset += cmd_size;
+    offset += cmd_size;
 
-      if (analyzer.m_efb_copy)
-      {
-        // We increase the offset beforehand, so that the trigger EFB copy command is included.
-        analyzed.AddPart(FramePartType::EFBCopy, part_start, offset, analyzer.m_cpmem);
-        part_start = offset;
-      }
+    if (m_efb_copy)
+    {
+      // We increase the offset beforehand, so that the trigger EFB copy command is included.
+      analyzed.AddPart(FramePartType::EFBCopy, part_start, offset, m_cpmem);
+      part_start = offset;
     }
-
-    // The frame should end with an EFB copy, so part_start should have been updated to the end.
-    ASSERT(part_start == frame.fifoData.size());
-    ASSERT(offset == frame.fifoData.size());
   }
+
+  // The frame should end with an EFB copy, so part_start should have been updated to the end.
+  ASSERT(part_start == frame.fifoData.size());
+  ASSERT(offset == frame.fifoData.size());
 }
 
 void FifoPlaybackAnalyzer::OnBP(u8 command, u32 value)
@@ -172,6 +163,7 @@ FifoPlayer::FifoPlayer()
 FifoPlayer::~FifoPlayer()
 {
   Config::RemoveConfigChangedCallback(m_config_changed_callback_id);
+  StopAnalysis();
 }
 
 bool FifoPlayer::Open(const std::string& filename)
@@ -180,27 +172,80 @@ bool FifoPlayer::Open(const std::string& filename)
 
   m_File = FifoDataFile::Load(filename, false);
 
-  if (m_File)
+  if (!m_File)
   {
-    FifoPlaybackAnalyzer::AnalyzeFrames(m_File.get(), m_FrameInfo);
-
-    m_FrameRangeEnd = m_File->GetFrameCount() - 1;
+    if (m_FileLoadedCb)
+      m_FileLoadedCb();
+    return false;
   }
 
-  if (m_FileLoadedCb)
-    m_FileLoadedCb();
+  m_FrameRangeEnd = m_File->GetFrameCount() - 1;
 
-  return (m_File != nullptr);
+  // Analyzing the frames means reading all of them, so it happens in the background and playback
+  // only waits for the frames it gets to. The file counts as loaded once they have all been
+  // analyzed, since that is when the object counts are known.
+  m_FrameInfo.resize(m_File->GetFrameCount());
+  m_AnalysisThread = std::thread(&FifoPlayer::AnalyzeFrames, this);
+
+  return true;
 }
 
 void FifoPlayer::Close()
 {
+  StopAnalysis();
   m_File.reset();
+  m_FrameInfo.clear();
 
   m_FrameRangeStart = 0;
   m_FrameRangeEnd = 0;
 }
 
+void FifoPlayer::AnalyzeFrames()
+{
+  Common::SetCurrentThreadName("FIFO player analysis");
+
+  FifoPlaybackAnalyzer analyzer(m_File->GetCPMem());
+  for (u32 frame = 0; frame < m_FrameInfo.size(); ++frame)
+  {
+    if (m_StopAnalysis.IsSet())
+      return;
+
+    analyzer.AnalyzeFrame(*m_File->GetFrame(frame), m_FrameInfo[frame]);
+
+    {
+      std::lock_guard lk(m_AnalysisMutex);
+      m_AnalyzedFrameCount = frame + 1;
+    }
+    m_FrameAnalyzed.notify_all();
+  }
+
+  if (m_FileLoadedCb)
+    m_FileLoadedCb();
+}
+
+void FifoPlayer::StopAnalysis()
+{
+  if (!m_AnalysisThread.joinable())
+    return;
+
+  m_StopAnalysis.Set();
+  m_AnalysisThread.join();
+  m_StopAnalysis.Clear();
+  m_AnalyzedFrameCount = 0;
+}
+
+void FifoPlayer::WaitForAnalysis(u32 frame_count) const
+{
+  std::unique_lock lk(m_AnalysisMutex);
+  m_FrameAnalyzed.wait(lk, [this, frame_count] { return m_AnalyzedFrameCount >= frame_count; });
+}
+
+const AnalyzedFrameInfo& FifoPlayer::GetAnalyzedFrameInfo(u32 frame) const
+{
+  WaitForAnalysis(frame + 1);
+  return m_FrameInfo[frame];
+}
+
 bool FifoPlayer::IsPlaying() const
 {
   return GetFile() != nullptr && Core::IsRunning();
@@ -287,7 +332,7 @@ CPU::State FifoPlayer::AdvanceFrame()
   if (m_EarlyMemoryUpdates && m_CurrentFrame == m_FrameRangeStart)
     WriteAllMemoryUpdates();
 
-  WriteFrame(m_File->GetFrame(m_CurrentFrame), m_FrameInfo[m_CurrentFrame]);
+  WriteFrame(*m_File->GetFrame(m_CurrentFrame), GetAnalyzedFrameInfo(m_CurrentFrame));
 
   ++m_CurrentFrame;
   return CPU::State::Running;
@@ -330,6 +375,8 @@ bool FifoPlayer::IsRunningWithFakeVideoInterfaceUpdates() const
 
 u32 FifoPlayer::GetMaxObjectCount() const
 {
+  WaitForAnalysis(static_cast<u32>(m_FrameInfo.size()));
+
   u32 result = 0;
   for (auto& frame : m_FrameInfo)
   {
@@ -344,7 +391,7 @@ u32 FifoPlayer::GetFrameObjectCount(u32 frame) const
 {
   if (frame < m_FrameInfo.size())
   {
-    return m_FrameInfo[frame].part_type_counts[FramePartType::PrimitiveData];
+    return GetAnalyzedFrameInfo(frame).part_type_counts[FramePartType::PrimitiveData];
   }
 
   return 0;
@@ -478,8 +525,8 @@ void FifoPlayer::WriteAllMemoryUpdates()
 
   for (u32 frameNum = 0; frameNum < m_File->GetFrameCount(); ++frameNum)
   {
-    const FifoFrameInfo& frame = m_File->GetFrame(frameNum);
-    for (auto& update : frame.memoryUpdates)
+    const std::shared_ptr<const FifoFrameInfo> frame = m_File->GetFrame(frameNum);
+    for (auto& update : frame->memoryUpdates)
     {
       WriteMemory(update);
     }
@@ -537,16 +584,16 @@ void FifoPlayer::SetupFifo()
   WriteCP(CommandProcessor::CTRL_REGISTER, 0);   // disable read, BP, interrupts
   WriteCP(CommandProcessor::CLEAR_REGISTER, 7);  // clear overflow, underflow, metrics
 
-  const FifoFrameInfo& frame = m_File->GetFrame(m_CurrentFrame);
+  const std::shared_ptr<const FifoFrameInfo> frame = m_File->GetFrame(m_CurrentFrame);
 
   // Set fifo bounds
-  WriteCP(CommandProcessor::FIFO_BASE_LO, frame.fifoStart);
-  WriteCP(CommandProcessor::FIFO_BASE_HI, frame.fifoStart >> 16);
-  WriteCP(CommandProcessor::FIFO_END_LO, frame.fifoEnd);
-  WriteCP(CommandProcessor::FIFO_END_HI, frame.fifoEnd >> 16);
+  WriteCP(CommandProcessor::FIFO_BASE_LO, frame->fifoStart);
+  WriteCP(CommandProcessor::FIFO_BASE_HI, frame->fifoStart >> 16);
+  WriteCP(CommandProcessor::FIFO_END_LO, frame->fifoEnd);
+  WriteCP(CommandProcessor::FIFO_END_HI, frame->fifoEnd >> 16);
 
   // Set watermarks, high at 75%, low at 0%
-  u32 hi_watermark = (frame.fifoEnd - frame.fifoStart) * 3 / 4;
+  u32 hi_watermark = (frame->fifoEnd - frame->fifoStart) * 3 / 4;
   WriteCP(CommandProcessor::FIFO_HI_WATERMARK_LO, hi_watermark);
   WriteCP(CommandProcessor::FIFO_HI_WATERMARK_HI, hi_watermark >> 16);
   WriteCP(CommandProcessor::FIFO_LO_WATERMARK_LO, 0);
@@ -555,19 +602,19 @@ void FifoPlayer::SetupFifo()
   // Set R/W pointers to fifo start
   WriteCP(CommandProcessor::FIFO_RW_DISTANCE_LO, 0);
   WriteCP(CommandProcessor::FIFO_RW_DISTANCE_HI, 0);
-  WriteCP(CommandProcessor::FIFO_WRITE_POINTER_LO, frame.fifoStart);
-  WriteCP(CommandProcessor::FIFO_WRITE_POINTER_HI, frame.fifoStart >> 16);
-  WriteCP(CommandProcessor::FIFO_READ_POINTER_LO, frame.fifoStart);
-  WriteCP(CommandProcessor::FIFO_READ_POINTER_HI, frame.fifoStart >> 16);
+  WriteCP(CommandProcessor::FIFO_WRITE_POINTER_LO, frame->fifoStart);
+  WriteCP(CommandProcessor::FIFO_WRITE_POINTER_HI, frame->fifoStart >> 16);
+  WriteCP(CommandProcessor::FIFO_READ_POINTER_LO, frame->fifoStart);
+  WriteCP(CommandProcessor::FIFO_READ_POINTER_HI, frame->fifoStart >> 16);
 
   // Set fifo bounds
-  WritePI(ProcessorInterface::PI_FIFO_BASE, frame.fifoStart);
-  WritePI(ProcessorInterface::PI_FIFO_END, frame.fifoEnd);
+  WritePI(ProcessorInterface::PI_FIFO_BASE, frame->fifoStart);
+  WritePI(ProcessorInterface::PI_FIFO_END, frame->fifoEnd);
 
   // Set write pointer
-  WritePI(ProcessorInterface::PI_FIFO_WPTR, frame.fifoStart);
+  WritePI(ProcessorInterface::PI_FIFO_WPTR, frame->fifoStart);
   FlushWGP();
-  WritePI(ProcessorInterface::PI_FIFO_WPTR, frame.fifoStart);
+  WritePI(ProcessorInterface::PI_FIFO_WPTR, frame->fifoStart);
 
   WriteCP(CommandProcessor::CTRL_REGISTER, 17);  // enable read & GP link
 }
@@ -3,13 +3,17 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "Common/Assert.h"
+#include "Common/Flag.h"
 #include "Core/FifoPlayer/FifoDataFile.h"
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "VideoCommon/CPMemory.h"
@@ -109,7 +113,8 @@ public:
   u32 GetFrameObjectCount(u32 frame) const;
   u32 GetCurrentFrameObjectCount() const;
   u32 GetCurrentFrameNum() const { return m_CurrentFrame; }
-  const AnalyzedFrameInfo& GetAnalyzedFrameInfo(u32 frame) const { return m_FrameInfo[frame]; }
+  // Waits until the frame has been analyzed.
+  const AnalyzedFrameInfo& GetAnalyzedFrameInfo(u32 frame) const;
   // Frame range
   u32 GetFrameRangeStart() const { return m_FrameRangeStart; }
   void SetFrameRangeStart(u32 start);
@@ -136,6 +141,10 @@ private:
 
   CPU::State AdvanceFrame();
 
+  void AnalyzeFrames();
+  void StopAnalysis();
+  void WaitForAnalysis(u32 frame_count) const;
+
   void WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo& info);
   void WriteFramePart(const FramePart& part, u32* next_mem_update, const FifoFrameInfo& frame);
 
@@ -193,5 +202,11 @@ private:
 
   std::unique_ptr<FifoDataFile> m_File;
 
+  // Filled in order by m_AnalysisThread. Only the first m_AnalyzedFrameCount entries are complete.
   std::vector<AnalyzedFrameInfo> m_FrameInfo;
+  std::thread m_AnalysisThread;
+  Common::Flag m_StopAnalysis;
+  mutable std::mutex m_AnalysisMutex;
+  mutable std::condition_variable m_FrameAnalyzed;
+  u32 m_AnalyzedFrameCount = 0;
 };
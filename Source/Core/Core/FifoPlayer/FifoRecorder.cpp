@@ -253,9 +253,11 @@ void FifoRecorder::WriteGPCommand(const u8* data, u32 size)
     {
       std::lock_guard lk(m_mutex);
 
-      // Copy frame to file
-      // The file will be responsible for freeing the memory allocated for each frame's fifoData
-      m_File->AddFrame(m_CurrentFrame);
+      // Write frame to file
+      // The file compresses it and writes it to disk, so only the current frame stays in memory
+      // If that fails, end the recording with the frames that could be written
+      if (!m_File->AddFrame(m_CurrentFrame))
+        m_RequestedRecordingEnd = true;
 
       if (m_FinishedCb && m_RequestedRecordingEnd)
         m_FinishedCb();
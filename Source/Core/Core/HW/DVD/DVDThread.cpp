@@ -3,6 +3,9 @@
 
 #include "Core/HW/DVD/DVDThread.h"
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -11,6 +14,7 @@
 #include <utility>
 #include <vector>
 
+#include "Common/Align.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
@@ -67,6 +71,8 @@ static void StopDVDThread();
 static void DVDThread();
 static void WaitUntilIdle();
 
+static void ClearReadAheadCache();
+
 static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offset, u32 length,
                               const DiscIO::Partition& partition,
                               DVDInterface::ReplyType reply_type, s64 ticks_until_completion);
@@ -87,6 +93,31 @@ static std::map<u64, ReadResult> s_result_map;
 
 static std::unique_ptr<DiscIO::Volume> s_disc;
 
+// When a game reads the disc sequentially, the DVD thread keeps reading ahead whenever it has no
+// requests to serve, so that games which stream data don't have to wait for every chunk of a
+// compressed or encrypted disc image to be decoded. This only changes how long reads take in real
+// time. The results are still delivered by FinishRead at the emulated completion time.
+//
+// Volumes aren't thread-safe, so reading ahead happens on the DVD thread one chunk at a time, and
+// the variables below are only used by the DVD thread (or while it is stopped).
+constexpr u64 READ_AHEAD_CHUNK_SIZE = 0x40000;
+constexpr u64 READ_AHEAD_CHUNKS = 8;
+constexpr size_t MAX_CACHED_CHUNKS = 32;
+
+struct CachedChunk
+{
+  DiscIO::Partition partition;
+  u64 offset = 0;
+  u64 last_used = 0;
+  std::vector<u8> data;
+};
+
+static std::vector<CachedChunk> s_read_ahead_cache;
+static std::deque<std::pair<DiscIO::Partition, u64>> s_read_ahead_queue;
+static u64 s_read_ahead_use_counter = 0;
+static DiscIO::Partition s_last_read_partition;
+static u64 s_last_read_end = 0;
+
 void Start()
 {
   s_finish_read = CoreTiming::RegisterEvent("FinishReadDVDThread", FinishRead);
@@ -114,6 +145,7 @@ void Stop()
 {
   StopDVDThread();
   s_disc.reset();
+  ClearReadAheadCache();
 }
 
 static void StopDVDThread()
@@ -177,6 +209,7 @@ void SetDisc(std::unique_ptr<DiscIO::Volume> disc)
 {
   WaitUntilIdle();
   s_disc = std::move(disc);
+  ClearReadAheadCache();
 }
 
 bool HasDisc()
@@ -361,6 +394,97 @@ static void FinishRead(u64 id, s64 cycles_late)
   DVDInterface::FinishExecutingCommand(request.reply_type, interrupt, cycles_late, buffer);
 }
 
+static void ClearReadAheadCache()
+{
+  s_read_ahead_cache.clear();
+  s_read_ahead_queue.clear();
+  s_last_read_partition = DiscIO::Partition();
+  s_last_read_end = 0;
+}
+
+static CachedChunk* FindCachedChunk(const DiscIO::Partition& partition, u64 offset)
+{
+  for (CachedChunk& chunk : s_read_ahead_cache)
+  {
+    if (chunk.offset == offset && chunk.partition == partition)
+      return &chunk;
+  }
+  return nullptr;
+}
+
+// Reads as much as possible from cached chunks and the rest from the disc.
+static bool ReadThroughCache(u64 offset, u32 length, u8* buffer,
+                             const DiscIO::Partition& partition)
+{
+  while (length > 0)
+  {
+    const u64 chunk_offset = Common::AlignDown(offset, READ_AHEAD_CHUNK_SIZE);
+    CachedChunk* chunk = FindCachedChunk(partition, chunk_offset);
+    if (!chunk)
+      return s_disc->Read(offset, length, buffer, partition);
+
+    chunk->last_used = ++s_read_ahead_use_counter;
+    const u32 chunk_length =
+        static_cast<u32>(std::min<u64>(length, chunk_offset + READ_AHEAD_CHUNK_SIZE - offset));
+    std::memcpy(buffer, chunk->data.data() + (offset - chunk_offset), chunk_length);
+
+    offset += chunk_length;
+    buffer += chunk_length;
+    length -= chunk_length;
+  }
+
+  return true;
+}
+
+// Only the most recent stream is read ahead of, so that switching to another file doesn't leave
+// the DVD thread busy with chunks that won't be needed.
+static void QueueReadAhead(const DiscIO::Partition& partition, u64 end)
+{
+  s_read_ahead_queue.clear();
+
+  const u64 first_chunk = Common::AlignDown(end, READ_AHEAD_CHUNK_SIZE);
+  for (u64 i = 0; i < READ_AHEAD_CHUNKS; ++i)
+  {
+    const u64 offset = first_chunk + i * READ_AHEAD_CHUNK_SIZE;
+    if (!FindCachedChunk(partition, offset))
+      s_read_ahead_queue.emplace_back(partition, offset);
+  }
+}
+
+// Returns false if there was nothing left to read ahead.
+static bool ReadAheadOneChunk()
+{
+  if (s_read_ahead_queue.empty())
+    return false;
+
+  const auto [partition, offset] = s_read_ahead_queue.front();
+  s_read_ahead_queue.pop_front();
+
+  std::vector<u8> data(READ_AHEAD_CHUNK_SIZE);
+  // This fails for the last chunk of a partition if it's cut short, which only means that the end
+  // of the partition gets read directly.
+  if (!s_disc->Read(offset, READ_AHEAD_CHUNK_SIZE, data.data(), partition))
+    return true;
+
+  CachedChunk* chunk;
+  if (s_read_ahead_cache.size() < MAX_CACHED_CHUNKS)
+  {
+    chunk = &s_read_ahead_cache.emplace_back();
+  }
+  else
+  {
+    chunk = &*std::min_element(
+        s_read_ahead_cache.begin(), s_read_ahead_cache.end(),
+        [](const CachedChunk& a, const CachedChunk& b) { return a.last_used < b.last_used; });
+  }
+
+  chunk->partition = partition;
+  chunk->offset = offset;
+  chunk->last_used = ++s_read_ahead_use_counter;
+  chunk->data = std::move(data);
+  return true;
+}
+
 static void DVDThread()
 {
   Common::SetCurrentThreadName("DVD thread");
@@ -378,17 +502,31 @@ static void DVDThread()
       FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
 
       std::vector<u8> buffer(request.length);
-      if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
+      if (!ReadThroughCache(request.dvd_offset, request.length, buffer.data(), request.partition))
         buffer.resize(0);
 
       request.realtime_done_us = Common::Timer::GetTimeUs();
 
+      const u64 end = request.dvd_offset + request.length;
+      if (request.partition == s_last_read_partition && request.dvd_offset == s_last_read_end)
+        QueueReadAhead(request.partition, end);
+      s_last_read_partition = request.partition;
+      s_last_read_end = end;
+
       s_result_queue.Push(ReadResult(std::move(request), std::move(buffer)));
       s_result_queue_expanded.Set();
 
       if (s_dvd_thread_exiting.IsSet())
         return;
     }
+
+    // Pushing a request sets s_request_queue_expanded, so the wait above won't miss one that
+    // comes in while reading ahead.
+    while (s_request_queue.Empty() && ReadAheadOneChunk())
+    {
+      if (s_dvd_thread_exiting.IsSet())
+        return;
+    }
   }
 }
 }  // namespace DVDThread
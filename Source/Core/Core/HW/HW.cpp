@@ -25,6 +25,7 @@
 #include "Core/HW/VideoInterface.h"
 #include "Core/HW/WII_IPC.h"
 #include "Core/IOS/IOS.h"
+#include "Core/Rewind.h"
 #include "Core/State.h"
 
 namespace HW
@@ -35,6 +36,7 @@ void Init()
   SystemTimers::PreInit();
 
   State::Init();
+  Rewind::Init();
 
   // Init the whole Hardware
   AudioInterface::Init();
@@ -75,13 +77,14 @@ void Shutdown()
   SerialInterface::Shutdown();
   AudioInterface::Shutdown();
 
+  Rewind::Shutdown();
   State::Shutdown();
   CoreTiming::Shutdown();
 }
 
-void DoState(PointerWrap& p)
+void DoState(PointerWrap& p, bool include_ram)
 {
-  Memory::DoState(p);
+  Memory::DoState(p, include_ram);
   p.DoMarker("Memory");
   VideoInterface::DoState(p);
   p.DoMarker("VideoInterface");
@@ -9,5 +9,5 @@ namespace HW
 {
 void Init();
 void Shutdown();
-void DoState(PointerWrap& p);
+void DoState(PointerWrap& p, bool include_ram = true);
 }  // namespace HW
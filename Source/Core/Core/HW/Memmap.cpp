@@ -394,7 +394,7 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
   }
 }
 
-void DoState(PointerWrap& p)
+void DoState(PointerWrap& p, bool include_ram)
 {
   const u32 current_ram_size = GetRamSize();
   const u32 current_l1_cache_size = GetL1CacheSize();
@@ -432,6 +432,9 @@ void DoState(PointerWrap& p)
     return;
   }
 
+  if (!include_ram)
+    return;
+
   p.DoArray(m_pRAM, current_ram_size);
   p.DoArray(m_pL1Cache, current_l1_cache_size);
   p.DoMarker("Memory RAM");
@@ -443,6 +446,16 @@ void DoState(PointerWrap& p)
   p.DoMarker("Memory EXRAM");
 }
 
+std::vector<StateRegion> GetStateRegions()
+{
+  std::vector<StateRegion> regions{{m_pRAM, GetRamSize()}, {m_pL1Cache, GetL1CacheSize()}};
+  if (m_pFakeVMEM)
+    regions.push_back({m_pFakeVMEM, GetFakeVMemSize()});
+  if (m_pEXRAM)
+    regions.push_back({m_pEXRAM, GetExRamSize()});
+  return regions;
+}
+
 void Shutdown()
 {
   ShutdownFastmemArena();
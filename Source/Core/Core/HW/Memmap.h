@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
@@ -64,7 +65,17 @@ void Init();
 void Shutdown();
 bool InitFastmemArena();
 void ShutdownFastmemArena();
-void DoState(PointerWrap& p);
+// If include_ram is false, the contents of emulated memory are left out of the state, so that
+// incremental savestates can store them separately.
+void DoState(PointerWrap& p, bool include_ram = true);
+
+// The areas of emulated memory whose contents DoState saves, in the order it saves them.
+struct StateRegion
+{
+  u8* data;
+  u32 size;
+};
+std::vector<StateRegion> GetStateRegions();
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
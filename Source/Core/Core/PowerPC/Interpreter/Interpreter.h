@@ -16,6 +16,8 @@ public:
   void Shutdown() override;
   void SingleStep() override;
   int SingleStepInner();
+  // Executes instructions up to the end of the block at PC and returns the number of cycles.
+  int RunBlock();
 
   void Run() override;
   void ClearCache() override;
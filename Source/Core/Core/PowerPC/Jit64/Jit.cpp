@@ -154,6 +154,9 @@ enum
   GUARD_OFFSET = STACK_SIZE - SAFE_STACK_SIZE - GUARD_SIZE,
 };
 
+// How often a block compiled at the baseline tier runs before it gets recompiled.
+constexpr u32 HOT_BLOCK_THRESHOLD = 500;
+
 Jit64::Jit64() : QuantizedMemoryRoutines(*this)
 {
 }
@@ -386,6 +389,7 @@ void Jit64::ClearCache()
   trampolines.ClearCodeSpace();
   m_far_code.ClearCodeSpace();
   m_const_pool.Clear();
+  m_hot_block_addresses.clear();
   ClearCodeSpace();
   Clear();
   UpdateMemoryAndExceptionOptions();
@@ -823,8 +827,19 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
+  // Tiering changes where blocks end, which affects timing, so it can't be used when other
+  // emulators have to follow along.
+  m_compiling_baseline_tier =
+      m_tiered_compilation && !m_enable_debugging && !jo.profile_blocks &&
+      !Core::WantsDeterminism() && m_hot_block_addresses.count(em_address) == 0;
+  if (m_compiling_baseline_tier)
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+
   const u32 nextPC = analyzer.Analyze(em_address, &code_block, &m_code_buffer, block_size);
 
+  if (m_compiling_baseline_tier)
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+
   if (code_block.m_memory_exception)
   {
     // Address of instruction could not be translated
@@ -938,6 +953,10 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
     ADD(64, MDisp(ABI_PARAM1, offset), Imm8(1));
     ABI_CallFunction(QueryPerformanceCounter);
   }
+
+  if (m_compiling_baseline_tier)
+    WriteTierUpCheck();
+
 #if defined(_DEBUG) || defined(DEBUGFAST) || defined(NAN_CHECK)
   // should help logged stack-traces become more accurate
   MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
@@ -1259,6 +1278,35 @@ void Jit64::EnableOptimization()
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
 }
 
+void Jit64::WriteTierUpCheck()
+{
+  // Count the runs of the block in its profiling data, and once it turns out to be hot, go back to
+  // the dispatcher to have it compiled again. Nothing has been executed at this point yet.
+  SwitchToFarCode();
+  const u8* promote = GetCodePtr();
+  MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+  ABI_PushRegistersAndAdjustStack({}, 0);
+  ABI_CallFunctionPC(PromoteBlock, this, js.blockStart);
+  ABI_PopRegistersAndAdjustStack({}, 0);
+  JMP(asm_routines.dispatcher_no_check, true);
+  SwitchToNearCode();
+
+  MOV(64, R(RSCRATCH), ImmPtr(&js.curBlock->profile_data.runCount));
+  ADD(64, MatR(RSCRATCH), Imm8(1));
+  CMP(64, MatR(RSCRATCH), Imm32(HOT_BLOCK_THRESHOLD));
+  J_CC(CC_AE, promote);
+}
+
+void Jit64::PromoteBlock(Jit64& jit, u32 address)
+{
+  jit.m_hot_block_addresses.insert(address);
+
+  // The block we're coming from is left before anything else gets compiled into its space.
+  JitBlock* block = jit.blocks.GetBlockFromStartAddress(address, MSR.Hex);
+  if (block)
+    jit.blocks.EraseBlock(*block);
+}
+
 void Jit64::IntializeSpeculativeConstants()
 {
   // If the block depends on an input register which looks like a gather pipe or MMIO related
@@ -17,6 +17,8 @@
 // ----------
 #pragma once
 
+#include <unordered_set>
+
 #include <rangeset/rangesizeset.h>
 
 #include "Common/CommonTypes.h"
@@ -68,6 +70,7 @@ public:
   BitSet8 ComputeStaticGQRs(const PPCAnalyst::CodeBlock&) const;
 
   void IntializeSpeculativeConstants();
+  void WriteTierUpCheck();
 
   JitBlockCache* GetBlockCache() override { return &blocks; }
   void Trace();
@@ -257,6 +260,8 @@ private:
 
   void ResetFreeMemoryRanges();
 
+  static void PromoteBlock(Jit64& jit, u32 address);
+
   JitBlockCache blocks{*this};
   TrampolineCache trampolines{*this};
 
@@ -269,6 +274,12 @@ private:
   bool m_cleanup_after_stackfault = false;
   u8* m_stack = nullptr;
 
+  // With tiered compilation, blocks are first compiled without following branches, which keeps
+  // them short and cheap to compile. Once a block has run often enough, its address is added here
+  // and it is compiled again with the full analysis.
+  bool m_compiling_baseline_tier = false;
+  std::unordered_set<u32> m_hot_block_addresses;
+
   HyoutaUtilities::RangeSizeSet<u8*> m_free_ranges_near;
   HyoutaUtilities::RangeSizeSet<u8*> m_free_ranges_far;
 };
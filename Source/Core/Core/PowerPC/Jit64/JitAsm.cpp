@@ -190,7 +190,10 @@ void Jit64AsmRoutineManager::Generate()
   ABI_CallFunction(JitTrampoline);
   ABI_PopRegistersAndAdjustStack({}, 0);
 
-  JMP(dispatcher_no_check, true);
+  // A block that got interpreted instead of compiled may have used up the downcount, in which
+  // case we have to go through do_timing so that CoreTiming and the CPU state get checked.
+  CMP(32, PPCSTATE(downcount), Imm8(0));
+  J_CC(CC_G, dispatcher_no_check);
 
   SetJumpTarget(bail);
   do_timing = GetCodePtr();
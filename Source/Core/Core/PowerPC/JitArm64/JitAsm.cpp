@@ -155,7 +155,12 @@ void JitArm64::GenerateAsm()
   MOVP2R(ARM64Reg::X8, reinterpret_cast<void*>(&JitTrampoline));
   BLR(ARM64Reg::X8);
   LDR(IndexType::Unsigned, DISPATCHER_PC, PPC_REG, PPCSTATE_OFF(pc));
-  B(dispatcher_no_check);
+
+  // A block that got interpreted instead of compiled may have used up the downcount, in which
+  // case we have to go through do_timing so that CoreTiming and the CPU state get checked.
+  LDR(IndexType::Unsigned, ARM64Reg::W0, PPC_REG, PPCSTATE_OFF(downcount));
+  CMP(ARM64Reg::W0, 0);
+  B(CC_GT, dispatcher_no_check);
 
   SetJumpTarget(bail);
   do_timing = GetCodePtr();
@@ -3,11 +3,16 @@
 
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
+#include <algorithm>
+
 #include "Common/CommonTypes.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/CoreTiming.h"
 #include "Core/HW/CPU.h"
+#include "Core/HW/SystemTimers.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/System.h"
@@ -19,9 +24,15 @@ const u8* JitBase::Dispatch(JitBase& jit)
 
 void JitTrampoline(JitBase& jit, u32 em_address)
 {
-  jit.Jit(em_address);
+  jit.CompileFromDispatcher(em_address);
 }
 
+// The compile budget is handed out per 1/60th of a second of emulated time.
+constexpr u32 COMPILE_BUDGET_WINDOWS_PER_SECOND = 60;
+// The longest a dispatcher miss spends compiling blocks the persistent cache expects to be needed.
+constexpr std::chrono::steady_clock::duration MAX_PREWARM_TIME_PER_MISS =
+    std::chrono::microseconds(200);
+
 JitBase::JitBase() : m_code_buffer(code_buffer_size)
 {
   m_registered_config_callback_id = Config::AddConfigChangedCallback(
@@ -57,12 +68,77 @@ void JitBase::RefreshConfig()
   m_accurate_nans = Config::Get(Config::MAIN_ACCURATE_NANS);
   m_fastmem_enabled = Config::Get(Config::MAIN_FASTMEM);
   m_mmu_enabled = Core::System::GetInstance().IsMMUMode();
+  m_persistent_cache = Config::Get(Config::MAIN_JIT_PERSISTENT_CACHE);
+  m_tiered_compilation = Config::Get(Config::MAIN_JIT_TIERED_COMPILATION);
+  m_compile_budget =
+      std::chrono::microseconds(std::max(0, Config::Get(Config::MAIN_JIT_COMPILE_BUDGET)));
   analyzer.SetDebuggingEnabled(m_enable_debugging);
   analyzer.SetBranchFollowingEnabled(Config::Get(Config::MAIN_JIT_FOLLOW_BRANCH));
   analyzer.SetFloatExceptionsEnabled(m_enable_float_exceptions);
   analyzer.SetDivByZeroExceptionsEnabled(m_enable_div_by_zero_exceptions);
 }
 
+void JitBase::CompileFromDispatcher(u32 em_address)
+{
+  // Whether a block gets compiled depends on how fast the host is, which changes where blocks end
+  // and thereby the timing, so deterministic modes always compile right away.
+  if (m_compile_budget.count() == 0 || m_enable_debugging || Core::WantsDeterminism())
+  {
+    Jit(em_address);
+    PrewarmBlocks(em_address, std::chrono::steady_clock::now() + MAX_PREWARM_TIME_PER_MISS);
+    return;
+  }
+
+  if (!HasCompileBudgetLeft())
+  {
+    InterpretBlock();
+    return;
+  }
+
+  // Prewarming only gets what is left of the budget after the block that is actually needed.
+  const auto start = std::chrono::steady_clock::now();
+  Jit(em_address);
+  const auto now = std::chrono::steady_clock::now();
+  PrewarmBlocks(em_address, std::min(now + MAX_PREWARM_TIME_PER_MISS,
+                                     start + m_compile_time_left));
+  m_compile_time_left -= std::chrono::steady_clock::now() - start;
+}
+
+bool JitBase::HasCompileBudgetLeft()
+{
+  const u64 ticks = CoreTiming::GetTicks();
+  if (ticks >= m_compile_window_end)
+  {
+    m_compile_window_end =
+        ticks + SystemTimers::GetTicksPerSecond() / COMPILE_BUDGET_WINDOWS_PER_SECOND;
+    m_compile_time_left = m_compile_budget;
+  }
+  return m_compile_time_left.count() > 0;
+}
+
+void JitBase::InterpretBlock()
+{
+  // Once this uses up the downcount, the dispatcher goes on to do_timing when we return.
+  PowerPC::ppcState.downcount -= Interpreter::getInstance()->RunBlock();
+}
+
+void JitBase::PrewarmBlocks(u32 em_address, std::chrono::steady_clock::time_point deadline)
+{
+  if (!m_persistent_cache || m_enable_debugging || SConfig::GetInstance().bJITNoBlockCache)
+    return;
+
+  m_disk_cache.QueuePrewarm(em_address);
+  m_disk_cache.Prewarm(*this, deadline);
+}
+
+void JitBase::SwitchDiskCacheToRunningGame()
+{
+  if (m_persistent_cache && !m_enable_debugging && !SConfig::GetInstance().bJITNoBlockCache)
+    m_disk_cache.SwitchToRunningGame(*this);
+  else
+    m_disk_cache.Close(*this);
+}
+
 bool JitBase::CanMergeNextInstructions(int count) const
 {
   if (CPU::IsStepping() || js.instructionsLeft < count)
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <map>
 #include <unordered_set>
@@ -15,6 +16,7 @@
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/JitCommon/JitAsmCommon.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitCommon/JitDiskCache.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 
 //#define JIT_LOG_GENERATED_CODE  // Enables logging of generated code
@@ -134,6 +136,16 @@ protected:
   bool m_accurate_nans = false;
   bool m_fastmem_enabled = false;
   bool m_mmu_enabled = false;
+  bool m_persistent_cache = false;
+  bool m_tiered_compilation = false;
+
+  // Limits the time spent compiling per window of emulated time, see MAIN_JIT_COMPILE_BUDGET.
+  // Blocks which miss the budget run in the interpreter until the next window.
+  std::chrono::steady_clock::duration m_compile_budget{};
+  std::chrono::steady_clock::duration m_compile_time_left{};
+  u64 m_compile_window_end = 0;
+
+  JitDiskCache m_disk_cache;
 
   void RefreshConfig();
 
@@ -143,6 +155,9 @@ protected:
 
   bool ShouldHandleFPExceptionForInstruction(const PPCAnalyst::CodeOp* op);
 
+  bool HasCompileBudgetLeft();
+  void InterpretBlock();
+
 public:
   JitBase();
   ~JitBase() override;
@@ -159,6 +174,16 @@ public:
   virtual bool HandleFault(uintptr_t access_address, SContext* ctx) = 0;
   virtual bool HandleStackFault() { return false; }
 
+  // Called by the dispatcher when there is no block for em_address. Usually compiles one.
+  void CompileFromDispatcher(u32 em_address);
+
+  // Queues the blocks which the persistent cache expects to be needed after em_address, and
+  // compiles queued blocks until the deadline has passed.
+  void PrewarmBlocks(u32 em_address, std::chrono::steady_clock::time_point deadline);
+  // Opens the persistent cache of the game that is running now, if it is enabled.
+  void SwitchDiskCacheToRunningGame();
+  JitDiskCache& GetDiskCache() { return m_disk_cache; }
+
   static constexpr std::size_t code_buffer_size = 32000;
 
   // This should probably be removed from public:
@@ -7,7 +7,6 @@
 #include <array>
 #include <cstring>
 #include <functional>
-#include <map>
 #include <set>
 #include <utility>
 
@@ -28,8 +27,8 @@ using namespace Gen;
 
 bool JitBlock::OverlapsPhysicalRange(u32 address, u32 length) const
 {
-  return physical_addresses.lower_bound(address) !=
-         physical_addresses.lower_bound(address + length);
+  const auto it = std::lower_bound(physical_addresses.begin(), physical_addresses.end(), address);
+  return it != physical_addresses.end() && *it - address < length;
 }
 
 JitBaseBlockCache::JitBaseBlockCache(JitBase& jit) : m_jit{jit}
@@ -57,15 +56,23 @@ void JitBaseBlockCache::Clear()
 #if defined(_DEBUG) || defined(DEBUGFAST)
   Core::DisplayMessage("Clearing code cache.", 3000);
 #endif
+  // The persistent cache keeps the learned addresses of the whole game, so hold on to them.
+  m_jit.GetDiskCache().RememberLearnedAddresses(m_jit);
   m_jit.js.fifoWriteAddresses.clear();
   m_jit.js.pairedQuantizeAddresses.clear();
-  for (auto& e : block_map)
+  m_jit.GetDiskCache().RestoreLearnedAddresses(m_jit);
+  RunOnBlocks([this](const JitBlock& block) { DestroyBlock(const_cast<JitBlock&>(block)); });
+
+  m_free_blocks.clear();
+  for (auto it = m_block_slabs.rbegin(); it != m_block_slabs.rend(); ++it)
   {
-    DestroyBlock(e.second);
+    for (size_t i = BLOCKS_PER_SLAB; i > 0; --i)
+      FreeBlock((*it)[i - 1]);
   }
-  block_map.clear();
-  links_to.clear();
-  block_range_map.clear();
+
+  m_block_map.Clear();
+  m_links_to.Clear();
+  m_block_range_map.Clear();
 
   valid_block.ClearAll();
 
@@ -85,19 +92,50 @@ JitBlock** JitBaseBlockCache::GetFastBlockMap()
 
 void JitBaseBlockCache::RunOnBlocks(std::function<void(const JitBlock&)> f)
 {
-  for (const auto& e : block_map)
-    f(e.second);
+  m_block_map.ForEach([&f](u32, JitBlock* block) {
+    for (; block; block = block->next_at_same_address)
+      f(*block);
+  });
+}
+
+JitBlock* JitBaseBlockCache::NewBlock()
+{
+  if (m_free_blocks.empty())
+  {
+    m_block_slabs.push_back(std::make_unique<JitBlock[]>(BLOCKS_PER_SLAB));
+    JitBlock* slab = m_block_slabs.back().get();
+    for (size_t i = BLOCKS_PER_SLAB; i > 0; --i)
+      m_free_blocks.push_back(&slab[i - 1]);
+  }
+
+  JitBlock* block = m_free_blocks.back();
+  m_free_blocks.pop_back();
+  return block;
+}
+
+void JitBaseBlockCache::FreeBlock(JitBlock& block)
+{
+  // Reset everything, but keep the capacity of the vectors around for the next block.
+  static_cast<JitBlockData&>(block) = {};
+  block.linkData.clear();
+  block.physical_addresses.clear();
+  block.next_at_same_address = nullptr;
+  block.profile_data = {};
+  m_free_blocks.push_back(&block);
 }
 
 JitBlock* JitBaseBlockCache::AllocateBlock(u32 em_address)
 {
   const u32 physical_address = PowerPC::JitCache_TranslateAddress(em_address).address;
-  JitBlock& b = block_map.emplace(physical_address, JitBlock())->second;
+  JitBlock& b = *NewBlock();
   b.effectiveAddress = em_address;
   b.physicalAddress = physical_address;
   b.msrBits = MSR.Hex & JIT_CACHE_MSR_MASK;
-  b.linkData.clear();
   b.fast_block_map_index = 0;
+
+  JitBlock*& first = m_block_map[physical_address];
+  b.next_at_same_address = first;
+  first = &b;
   return &b;
 }
 
@@ -108,20 +146,26 @@ void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
   fast_block_map[index] = &block;
   block.fast_block_map_index = index;
 
-  block.physical_addresses = physical_addresses;
+  block.physical_addresses.assign(physical_addresses.begin(), physical_addresses.end());
 
-  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
-  for (u32 addr : physical_addresses)
+  for (size_t i = 0; i < block.physical_addresses.size(); ++i)
   {
+    const u32 addr = block.physical_addresses[i];
     valid_block.Set(addr / 32);
-    block_range_map[addr & range_mask].insert(&block);
+
+    // The addresses are sorted, so the block only has to be added when the range changes.
+    const u32 range = addr >> BLOCK_RANGE_SHIFT;
+    if (i == 0 || range != block.physical_addresses[i - 1] >> BLOCK_RANGE_SHIFT)
+      m_block_range_map[range].push_back(&block);
   }
 
   if (block_link)
   {
     for (const auto& e : block.linkData)
     {
-      links_to[e.exitAddress].insert(&block);
+      std::vector<JitBlock*>& sources = m_links_to[e.exitAddress];
+      if (std::find(sources.begin(), sources.end(), &block) == sources.end())
+        sources.push_back(&block);
     }
 
     LinkBlock(block);
@@ -154,12 +198,14 @@ JitBlock* JitBaseBlockCache::GetBlockFromStartAddress(u32 addr, u32 msr)
     translated_addr = translated.address;
   }
 
-  auto iter = block_map.equal_range(translated_addr);
-  for (; iter.first != iter.second; iter.first++)
+  JitBlock* const* first = m_block_map.Find(translated_addr);
+  if (!first)
+    return nullptr;
+
+  for (JitBlock* b = *first; b; b = b->next_at_same_address)
   {
-    JitBlock& b = iter.first->second;
-    if (b.effectiveAddress == addr && b.msrBits == (msr & JIT_CACHE_MSR_MASK))
-      return &b;
+    if (b->effectiveAddress == addr && b->msrBits == (msr & JIT_CACHE_MSR_MASK))
+      return b;
   }
 
   return nullptr;
@@ -262,51 +308,88 @@ void JitBaseBlockCache::InvalidateICacheInternal(u32 physical_address, u32 addre
 
 void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
 {
-  // Iterate over all macro blocks which overlap the given range.
-  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
-  auto start = block_range_map.lower_bound(address & range_mask);
-  auto end = block_range_map.lower_bound(address + length);
-  while (start != end)
-  {
-    // Iterate over all blocks in the macro block.
-    auto iter = start->second.begin();
-    while (iter != start->second.end())
+  if (length == 0)
+    return;
+
+  const auto add_overlapping_blocks = [&](const std::vector<JitBlock*>& blocks) {
+    for (JitBlock* block : blocks)
     {
-      JitBlock* block = *iter;
       if (block->OverlapsPhysicalRange(address, length))
-      {
-        // If the block overlaps, also remove all other occupied slots in the other macro blocks.
-        // This will leak empty macro blocks, but they may be reused or cleared later on.
-        for (u32 addr : block->physical_addresses)
-          if ((addr & range_mask) != start->first)
-            block_range_map[addr & range_mask].erase(block);
-
-        // And remove the block.
-        DestroyBlock(*block);
-        auto block_map_iter = block_map.equal_range(block->physicalAddress);
-        while (block_map_iter.first != block_map_iter.second)
-        {
-          if (&block_map_iter.first->second == block)
-          {
-            block_map.erase(block_map_iter.first);
-            break;
-          }
-          block_map_iter.first++;
-        }
-        iter = start->second.erase(iter);
-      }
-      else
-      {
-        iter++;
-      }
+        m_blocks_to_erase.push_back(block);
     }
+  };
 
-    // If the macro block is empty, drop it.
-    if (start->second.empty())
-      start = block_range_map.erase(start);
-    else
-      start++;
+  // Collect the blocks first, since erasing them modifies the range map.
+  const u32 first_range = address >> BLOCK_RANGE_SHIFT;
+  const u32 last_range = static_cast<u32>((u64{address} + length - 1) >> BLOCK_RANGE_SHIFT);
+  if (last_range - first_range >= m_block_range_map.Size())
+  {
+    // For large ranges (like the whole address space), visiting the occupied entries is cheaper
+    // than looking up every single range.
+    m_block_range_map.ForEach([&](u32 range, const std::vector<JitBlock*>& blocks) {
+      if (range >= first_range && range <= last_range)
+        add_overlapping_blocks(blocks);
+    });
   }
+  else
+  {
+    for (u32 range = first_range; range <= last_range; ++range)
+    {
+      if (const std::vector<JitBlock*>* blocks = m_block_range_map.Find(range))
+        add_overlapping_blocks(*blocks);
+    }
+  }
+
+  // A block which spans several ranges may have been found more than once.
+  std::sort(m_blocks_to_erase.begin(), m_blocks_to_erase.end());
+  m_blocks_to_erase.erase(std::unique(m_blocks_to_erase.begin(), m_blocks_to_erase.end()),
+                          m_blocks_to_erase.end());
+
+  for (JitBlock* block : m_blocks_to_erase)
+    EraseBlock(*block);
+  m_blocks_to_erase.clear();
+}
+
+void JitBaseBlockCache::EraseBlock(JitBlock& block)
+{
+  const auto remove_from = [&block](std::vector<JitBlock*>& blocks) {
+    const auto it = std::find(blocks.begin(), blocks.end(), &block);
+    if (it != blocks.end())
+    {
+      *it = blocks.back();
+      blocks.pop_back();
+    }
+  };
+
+  for (size_t i = 0; i < block.physical_addresses.size(); ++i)
+  {
+    const u32 range = block.physical_addresses[i] >> BLOCK_RANGE_SHIFT;
+    if (i != 0 && range == block.physical_addresses[i - 1] >> BLOCK_RANGE_SHIFT)
+      continue;
+
+    std::vector<JitBlock*>* blocks = m_block_range_map.Find(range);
+    if (!blocks)
+      continue;
+
+    remove_from(*blocks);
+    if (blocks->empty())
+      m_block_range_map.Erase(range);
+  }
+
+  DestroyBlock(block);
+
+  JitBlock** next = m_block_map.Find(block.physicalAddress);
+  if (next)
+  {
+    while (*next && *next != &block)
+      next = &(*next)->next_at_same_address;
+    if (*next)
+      *next = block.next_at_same_address;
+    if (!*m_block_map.Find(block.physicalAddress))
+      m_block_map.Erase(block.physicalAddress);
+  }
+
+  FreeBlock(block);
 }
 
 u32* JitBaseBlockCache::GetBlockBitSet() const
@@ -343,11 +426,11 @@ void JitBaseBlockCache::LinkBlockExits(JitBlock& block)
 void JitBaseBlockCache::LinkBlock(JitBlock& block)
 {
   LinkBlockExits(block);
-  const auto it = links_to.find(block.effectiveAddress);
-  if (it == links_to.end())
+  const std::vector<JitBlock*>* sources = m_links_to.Find(block.effectiveAddress);
+  if (!sources)
     return;
 
-  for (JitBlock* b2 : it->second)
+  for (JitBlock* b2 : *sources)
   {
     if (block.msrBits == b2->msrBits)
       LinkBlockExits(*b2);
@@ -363,10 +446,10 @@ void JitBaseBlockCache::UnlinkBlock(const JitBlock& block)
   }
 
   // Unlink all exits of other blocks which points to this block
-  const auto it = links_to.find(block.effectiveAddress);
-  if (it == links_to.end())
+  const std::vector<JitBlock*>* sources = m_links_to.Find(block.effectiveAddress);
+  if (!sources)
     return;
-  for (JitBlock* sourceBlock : it->second)
+  for (JitBlock* sourceBlock : *sources)
   {
     if (sourceBlock->msrBits != block.msrBits)
       continue;
@@ -392,12 +475,16 @@ void JitBaseBlockCache::DestroyBlock(JitBlock& block)
   // Delete linking addresses
   for (const auto& e : block.linkData)
   {
-    auto it = links_to.find(e.exitAddress);
-    if (it == links_to.end())
+    std::vector<JitBlock*>* sources = m_links_to.Find(e.exitAddress);
+    if (!sources)
+      continue;
+    const auto it = std::find(sources->begin(), sources->end(), &block);
+    if (it == sources->end())
       continue;
-    it->second.erase(&block);
-    if (it->second.empty())
-      links_to.erase(it);
+    *it = sources->back();
+    sources->pop_back();
+    if (sources->empty())
+      m_links_to.Erase(e.exitAddress);
   }
 
   // Raise an signal if we are going to call this block again
@@ -4,18 +4,15 @@
 #pragma once
 
 #include <array>
-#include <bitset>
 #include <cstring>
 #include <functional>
-#include <map>
 #include <memory>
 #include <set>
 #include <type_traits>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/FlatHashMap.h"
 
 class JitBase;
 
@@ -40,7 +37,7 @@ struct JitBlockData
   // The MSR bits expected for this block to be valid; see JIT_CACHE_MSR_MASK.
   u32 msrBits;
   // The physical address of the code represented by this block.
-  // Various maps in the cache are indexed by this (block_map
+  // Various maps in the cache are indexed by this (m_block_map
   // and valid_block in particular). This is useful because of
   // of the way the instruction cache works on PowerPC.
   u32 physicalAddress;
@@ -78,8 +75,11 @@ struct JitBlock : public JitBlockData
   };
   std::vector<LinkData> linkData;
 
-  // This set stores all physical addresses of all occupied instructions.
-  std::set<u32> physical_addresses;
+  // The physical addresses of all occupied instructions, sorted.
+  std::vector<u32> physical_addresses;
+
+  // The next block which starts at the same physical address, see m_block_map.
+  JitBlock* next_at_same_address;
 
   // Block profiling data, structure is inlined in Jit.cpp
   struct ProfileData
@@ -163,6 +163,8 @@ public:
   void InvalidateICache(u32 address, u32 length, bool forced);
   void InvalidateICacheLine(u32 address);
   void ErasePhysicalRange(u32 address, u32 length);
+  // Removes a single block, e.g. so that it gets compiled again the next time it is needed.
+  void EraseBlock(JitBlock& block);
 
   u32* GetBlockBitSet() const;
 
@@ -185,19 +187,31 @@ private:
   // Fast but risky block lookup based on fast_block_map.
   size_t FastLookupIndexForAddress(u32 address);
 
-  // links_to hold all exit points of all valid blocks in a reverse way.
-  // It is used to query all blocks which links to an address.
-  std::unordered_map<u32, std::unordered_set<JitBlock*>> links_to;  // destination_PC -> number
+  // Blocks are allocated in slabs so that they never move, since the fast block map, the
+  // generated code for block links and the maps below all point to them.
+  static constexpr size_t BLOCKS_PER_SLAB = 1024;
+  JitBlock* NewBlock();
+  void FreeBlock(JitBlock& block);
+
+  std::vector<std::unique_ptr<JitBlock[]>> m_block_slabs;
+  std::vector<JitBlock*> m_free_blocks;
 
-  // Map indexed by the physical address of the entry point.
+  // m_links_to holds all exit points of all valid blocks in a reverse way.
+  // It is used to query all blocks which link to an address.
+  Common::FlatHashMap<u32, std::vector<JitBlock*>> m_links_to;  // destination_PC -> blocks
+
+  // Map indexed by the physical address of the entry point, holding the first of the blocks that
+  // start there. The others are chained through JitBlock::next_at_same_address.
   // This is used to query the block based on the current PC in a slow way.
-  std::multimap<u32, JitBlock> block_map;  // start_addr -> block
+  Common::FlatHashMap<u32, JitBlock*> m_block_map;  // start_addr -> block
+
+  // Blocks overlapping each range of physical memory, indexed by the physical address shifted
+  // right by BLOCK_RANGE_SHIFT. This is used for invalidation of memory regions.
+  static constexpr u32 BLOCK_RANGE_SHIFT = 8;
+  Common::FlatHashMap<u32, std::vector<JitBlock*>> m_block_range_map;
 
-  // Range of overlapping code indexed by a masked physical address.
-  // This is used for invalidation of memory regions. The range is grouped
-  // in macro blocks of each 0x100 bytes.
-  static constexpr u32 BLOCK_RANGE_MAP_ELEMENTS = 0x100;
-  std::map<u32, std::unordered_set<JitBlock*>> block_range_map;
+  // Scratch space for ErasePhysicalRange, kept around to avoid allocating on every invalidation.
+  std::vector<JitBlock*> m_blocks_to_erase;
 
   // This bitsets shows which cachelines overlap with any blocks.
   // It is used to provide a fast way to query if no icache invalidation is needed.
@@ -0,0 +1,268 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/PowerPC/JitCommon/JitDiskCache.h"
+
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <xxhash.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+
+class JitDiskCache::Reader final : public LinearDiskCacheReader<DiskKey, u32>
+{
+public:
+  explicit Reader(JitDiskCache& cache) : m_cache(cache) {}
+
+  void Read(const DiskKey& key, const u32* value, u32 value_size) override
+  {
+    switch (key.type)
+    {
+    case EntryType::Block:
+    {
+      // hash (2 words), physical address, number of physical addresses, physical addresses, exits
+      if (value_size < 4 || value[3] > value_size - 4)
+        return;
+
+      BlockInfo& info = m_cache.m_blocks[MakeBlockKey(key.address, key.msr_bits)];
+      info.hash = value[0] | static_cast<u64>(value[1]) << 32;
+      info.physical_address = value[2];
+      info.physical_addresses.assign(value + 4, value + 4 + value[3]);
+      info.exits.assign(value + 4 + value[3], value + value_size);
+      break;
+    }
+    case EntryType::FifoWriteAddress:
+      m_cache.m_fifo_write_addresses[key.address] = true;
+      break;
+    case EntryType::PairedQuantizeAddress:
+      m_cache.m_paired_quantize_addresses[key.address] = true;
+      break;
+    }
+  }
+
+private:
+  JitDiskCache& m_cache;
+};
+
+JitDiskCache::JitDiskCache() = default;
+
+JitDiskCache::~JitDiskCache() = default;
+
+u64 JitDiskCache::MakeBlockKey(u32 address, u32 msr_bits)
+{
+  return static_cast<u64>(msr_bits) << 32 | address;
+}
+
+bool JitDiskCache::HashInstructions(const std::vector<u32>& physical_addresses, u64* hash)
+{
+  std::vector<u32> instructions;
+  instructions.reserve(physical_addresses.size());
+  for (u32 address : physical_addresses)
+  {
+    if (!PowerPC::HostIsRAMAddress(address, PowerPC::RequestedAddressSpace::Physical))
+      return false;
+    instructions.push_back(Memory::Read_U32(address));
+  }
+
+  *hash = XXH64(instructions.data(), instructions.size() * sizeof(u32), 0);
+  return true;
+}
+
+void JitDiskCache::SwitchToRunningGame(JitBase& jit)
+{
+  const std::string& game_id = SConfig::GetInstance().GetGameID();
+  if (game_id == m_game_id)
+    return;
+
+  Close(jit);
+
+  // Learned addresses change when FIFO interrupts are checked, so a cache from another run would
+  // make the timing diverge from a run without it.
+  if (game_id.empty() || Core::WantsDeterminism())
+    return;
+
+  const std::string directory = File::GetUserPath(D_CACHE_IDX) + "JIT" DIR_SEP;
+  if (!File::IsDirectory(directory))
+    File::CreateDir(directory);
+
+  const std::string filename = fmt::format("{}{}.cache", directory, game_id);
+  Reader reader(*this);
+  const u32 count = m_disk_cache.OpenAndRead(filename, reader);
+  INFO_LOG_FMT(DYNA_REC, "Loaded {} cached JIT entries from {}", count, filename);
+
+  m_game_id = game_id;
+  RestoreLearnedAddresses(jit);
+}
+
+void JitDiskCache::Save(JitBase& jit)
+{
+  if (!IsOpen())
+    return;
+
+  u32 count = 0;
+  jit.GetBlockCache()->RunOnBlocks([this, &count](const JitBlock& block) {
+    BlockInfo new_info;
+    new_info.physical_address = block.physicalAddress;
+    new_info.physical_addresses = block.physical_addresses;
+    if (!HashInstructions(new_info.physical_addresses, &new_info.hash))
+      return;
+
+    for (const JitBlock::LinkData& link : block.linkData)
+      new_info.exits.push_back(link.exitAddress);
+    std::sort(new_info.exits.begin(), new_info.exits.end());
+    new_info.exits.erase(std::unique(new_info.exits.begin(), new_info.exits.end()),
+                         new_info.exits.end());
+
+    BlockInfo& info = m_blocks[MakeBlockKey(block.effectiveAddress, block.msrBits)];
+    if (info.hash == new_info.hash && info.physical_address == new_info.physical_address &&
+        info.exits == new_info.exits)
+    {
+      return;
+    }
+    info = std::move(new_info);
+
+    std::vector<u32> value{static_cast<u32>(info.hash), static_cast<u32>(info.hash >> 32),
+                           info.physical_address,
+                           static_cast<u32>(info.physical_addresses.size())};
+    value.insert(value.end(), info.physical_addresses.begin(), info.physical_addresses.end());
+    value.insert(value.end(), info.exits.begin(), info.exits.end());
+
+    const DiskKey key{EntryType::Block, block.effectiveAddress, block.msrBits};
+    m_disk_cache.Append(key, value.data(), static_cast<u32>(value.size()));
+    ++count;
+  });
+
+  RememberLearnedAddresses(jit);
+  const auto append_addresses = [this, &count](std::unordered_map<u32, bool>& addresses,
+                                               EntryType type) {
+    for (auto& [address, saved] : addresses)
+    {
+      if (saved)
+        continue;
+
+      // The key says all there is to say, but fwrite still wants a valid pointer.
+      const DiskKey key{type, address, 0};
+      m_disk_cache.Append(key, &address, 0);
+      saved = true;
+      ++count;
+    }
+  };
+  append_addresses(m_fifo_write_addresses, EntryType::FifoWriteAddress);
+  append_addresses(m_paired_quantize_addresses, EntryType::PairedQuantizeAddress);
+
+  m_disk_cache.Sync();
+  INFO_LOG_FMT(DYNA_REC, "Saved {} new JIT entries for {}", count, m_game_id);
+}
+
+void JitDiskCache::Close(JitBase& jit)
+{
+  Save(jit);
+
+  m_disk_cache.Close();
+  m_game_id.clear();
+  m_blocks.Clear();
+  m_fifo_write_addresses.clear();
+  m_paired_quantize_addresses.clear();
+  m_prewarm_queue.clear();
+  m_prewarm_queued.clear();
+}
+
+void JitDiskCache::RememberLearnedAddresses(const JitBase& jit)
+{
+  if (!IsOpen())
+    return;
+
+  for (u32 address : jit.js.fifoWriteAddresses)
+    m_fifo_write_addresses.try_emplace(address, false);
+  for (u32 address : jit.js.pairedQuantizeAddresses)
+    m_paired_quantize_addresses.try_emplace(address, false);
+}
+
+void JitDiskCache::RestoreLearnedAddresses(JitBase& jit) const
+{
+  for (const auto& [address, saved] : m_fifo_write_addresses)
+    jit.js.fifoWriteAddresses.insert(address);
+  for (const auto& [address, saved] : m_paired_quantize_addresses)
+    jit.js.pairedQuantizeAddresses.insert(address);
+}
+
+void JitDiskCache::QueuePrewarm(u32 em_address)
+{
+  if (!IsOpen())
+    return;
+
+  const u32 msr_bits = MSR.Hex & JitBaseBlockCache::JIT_CACHE_MSR_MASK;
+  const BlockInfo* info = m_blocks.Find(MakeBlockKey(em_address, msr_bits));
+  if (!info)
+    return;
+
+  m_prewarm_queued.insert(MakeBlockKey(em_address, msr_bits));
+  for (u32 address : info->exits)
+  {
+    const u64 key = MakeBlockKey(address, msr_bits);
+    if (m_prewarm_queued.insert(key).second)
+      m_prewarm_queue.push_back(key);
+  }
+}
+
+void JitDiskCache::Prewarm(JitBase& jit, std::chrono::steady_clock::time_point deadline)
+{
+  size_t compiled = 0;
+  while (!m_prewarm_queue.empty() && std::chrono::steady_clock::now() < deadline)
+  {
+    const u64 key = m_prewarm_queue.front();
+    m_prewarm_queue.pop_front();
+
+    // The block can only be compiled for the current MSR. It can get queued again from a block
+    // with the same MSR bits.
+    const u32 address = static_cast<u32>(key);
+    const u32 msr_bits = static_cast<u32>(key >> 32);
+    if (msr_bits != (MSR.Hex & JitBaseBlockCache::JIT_CACHE_MSR_MASK))
+    {
+      m_prewarm_queued.erase(key);
+      continue;
+    }
+
+    if (jit.GetBlockCache()->GetBlockFromStartAddress(address, MSR.Hex))
+      continue;
+
+    const BlockInfo* info = m_blocks.Find(key);
+    if (!info)
+      continue;
+
+    // The game might have loaded different code to the same address, or mapped it elsewhere.
+    const PowerPC::TranslateResult translated = PowerPC::JitCache_TranslateAddress(address);
+    u64 hash;
+    if (!translated.valid || translated.address != info->physical_address ||
+        !HashInstructions(info->physical_addresses, &hash) || hash != info->hash)
+    {
+      continue;
+    }
+
+    for (u32 exit : info->exits)
+    {
+      const u64 exit_key = MakeBlockKey(exit, msr_bits);
+      if (m_prewarm_queued.insert(exit_key).second)
+        m_prewarm_queue.push_back(exit_key);
+    }
+    jit.Jit(address);
+    ++compiled;
+  }
+
+  if (compiled != 0)
+  {
+    DEBUG_LOG_FMT(DYNA_REC, "Prewarmed {} blocks, {} still queued", compiled,
+                  m_prewarm_queue.size());
+  }
+}
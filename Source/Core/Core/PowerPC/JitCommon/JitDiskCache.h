@@ -0,0 +1,98 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FlatHashMap.h"
+#include "Common/LinearDiskCache.h"
+
+class JitBase;
+
+// Remembers, per game, which blocks the JIT ended up compiling and which instructions it learned
+// to treat specially at runtime (FIFO writes and paired quantized loads and stores), so that the
+// next boot doesn't have to rediscover all of that one dispatcher miss and one invalidation at a
+// time.
+//
+// The emitted code itself is not stored: it refers to host addresses such as the PowerPC state,
+// the fastmem arena, the far code region and the other blocks it is linked to, none of which stay
+// the same between runs. Instead, each block is stored with a hash of its instructions, and once
+// the game has loaded the same code again, the blocks which followed a freshly compiled block in
+// the previous run are queued and compiled a little at a time on later dispatcher misses.
+class JitDiskCache final
+{
+public:
+  JitDiskCache();
+  ~JitDiskCache();
+
+  JitDiskCache(const JitDiskCache&) = delete;
+  JitDiskCache& operator=(const JitDiskCache&) = delete;
+
+  // Saves the cache of the previous game and opens the one of the running game, if it has changed.
+  // Called when a new title gets loaded, not on every dispatcher miss.
+  void SwitchToRunningGame(JitBase& jit);
+
+  // Appends the blocks currently in the block cache and the addresses the JIT has learned about.
+  void Save(JitBase& jit);
+  void Close(JitBase& jit);
+
+  // Keeps the addresses the JIT has learned about so far, and adds all known ones back to the JIT.
+  // Used around clearing the block cache, which forgets them.
+  void RememberLearnedAddresses(const JitBase& jit);
+  void RestoreLearnedAddresses(JitBase& jit) const;
+
+  // Queues the blocks which were reached from the block at em_address in the previous run.
+  void QueuePrewarm(u32 em_address);
+  // Compiles queued blocks whose instructions haven't changed since the previous run, until the
+  // deadline has passed. The rest stay queued for the next call.
+  void Prewarm(JitBase& jit, std::chrono::steady_clock::time_point deadline);
+
+  bool IsOpen() const { return !m_game_id.empty(); }
+
+private:
+  enum class EntryType : u32
+  {
+    Block,
+    FifoWriteAddress,
+    PairedQuantizeAddress,
+  };
+
+  struct DiskKey
+  {
+    EntryType type;
+    u32 address;
+    u32 msr_bits;
+  };
+
+  struct BlockInfo
+  {
+    u64 hash = 0;
+    u32 physical_address = 0;
+    std::vector<u32> physical_addresses;
+    std::vector<u32> exits;
+  };
+
+  class Reader;
+
+  static u64 MakeBlockKey(u32 address, u32 msr_bits);
+  static bool HashInstructions(const std::vector<u32>& physical_addresses, u64* hash);
+
+  std::string m_game_id;
+  LinearDiskCache<DiskKey, u32> m_disk_cache;
+
+  Common::FlatHashMap<u64, BlockInfo> m_blocks;
+  // Maps each learned address to whether it has been written to the file yet.
+  std::unordered_map<u32, bool> m_fifo_write_addresses;
+  std::unordered_map<u32, bool> m_paired_quantize_addresses;
+
+  // Blocks to compile ahead of time, as block keys. Every block is only queued once per game.
+  std::deque<u64> m_prewarm_queue;
+  std::unordered_set<u64> m_prewarm_queued;
+};
@@ -282,10 +282,17 @@ void CompileExceptionCheck(ExceptionType type)
   }
 }
 
+void OnNewTitleLoad()
+{
+  if (g_jit)
+    g_jit->SwitchDiskCacheToRunningGame();
+}
+
 void Shutdown()
 {
   if (g_jit)
   {
+    g_jit->GetDiskCache().Close(*g_jit);
     g_jit->Shutdown();
     delete g_jit;
     g_jit = nullptr;
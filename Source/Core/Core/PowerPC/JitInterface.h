@@ -67,6 +67,9 @@ void InvalidateICacheLines(u32 address, u32 count);
 
 void CompileExceptionCheck(ExceptionType type);
 
+// Switches the persistent JIT cache to the game that is running now.
+void OnNewTitleLoad();
+
 /// used for the page fault unit test, don't use outside of tests!
 void SetJit(JitBase* jit);
 
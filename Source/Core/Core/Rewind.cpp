@@ -0,0 +1,331 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/Rewind.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <zstd.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+
+#include "Core/Config/MainSettings.h"
+#include "Core/Core.h"
+#include "Core/Movie.h"
+#include "Core/NetPlayProto.h"
+#include "Core/State.h"
+
+namespace Rewind
+{
+// Number of snapshots in a chain before it gets compressed and a new chain is started. Longer
+// chains deduplicate more pages, but stepping back into them means applying more deltas.
+constexpr size_t SNAPSHOTS_PER_SEGMENT = 30;
+
+// Snapshots are compressed for speed rather than size, since a segment gets compressed every
+// SNAPSHOTS_PER_SEGMENT snapshots while the game keeps running.
+constexpr int COMPRESSION_LEVEL = 1;
+
+struct History::Segment
+{
+  std::mutex lock;
+
+  // Holds the snapshots until the segment has been compressed, and after it has been
+  // decompressed again for stepping back into it.
+  State::DeltaChain chain;
+
+  // The full state followed by the deltas, each compressed on its own.
+  std::vector<std::vector<u8>> compressed;
+  std::vector<size_t> uncompressed_sizes;
+
+  std::atomic<size_t> memory_usage = 0;
+};
+
+static void CompressSegment(History::Segment& segment)
+{
+  std::lock_guard lk(segment.lock);
+
+  // The segment might have been stepped back into before we got to it.
+  if (segment.chain.IsEmpty())
+    return;
+
+  const auto compress = [&segment](const std::vector<u8>& buffer) {
+    std::vector<u8> compressed(ZSTD_compressBound(buffer.size()));
+    const size_t size = ZSTD_compress(compressed.data(), compressed.size(), buffer.data(),
+                                      buffer.size(), COMPRESSION_LEVEL);
+    if (ZSTD_isError(size))
+      return false;
+
+    compressed.resize(size);
+    compressed.shrink_to_fit();
+    segment.compressed.push_back(std::move(compressed));
+    segment.uncompressed_sizes.push_back(buffer.size());
+    return true;
+  };
+
+  bool success = compress(segment.chain.base);
+  for (size_t i = 0; success && i < segment.chain.deltas.size(); ++i)
+    success = compress(segment.chain.deltas[i]);
+
+  if (!success)
+  {
+    ERROR_LOG_FMT(CORE, "Failed to compress rewind snapshots");
+    segment.compressed.clear();
+    segment.uncompressed_sizes.clear();
+    return;
+  }
+
+  size_t memory_usage = 0;
+  for (const std::vector<u8>& buffer : segment.compressed)
+    memory_usage += buffer.size();
+
+  segment.chain.Clear();
+  segment.memory_usage = memory_usage;
+}
+
+static bool DecompressSegment(History::Segment& segment)
+{
+  if (!segment.chain.IsEmpty())
+    return true;
+
+  std::vector<std::vector<u8>> buffers(segment.compressed.size());
+  for (size_t i = 0; i < buffers.size(); ++i)
+  {
+    buffers[i].resize(segment.uncompressed_sizes[i]);
+    const size_t size = ZSTD_decompress(buffers[i].data(), buffers[i].size(),
+                                        segment.compressed[i].data(), segment.compressed[i].size());
+    if (ZSTD_isError(size) || size != buffers[i].size())
+      return false;
+  }
+
+  if (buffers.empty())
+    return false;
+
+  segment.chain.base = std::move(buffers.front());
+  segment.chain.deltas.assign(std::make_move_iterator(buffers.begin() + 1),
+                              std::make_move_iterator(buffers.end()));
+  segment.compressed.clear();
+  segment.uncompressed_sizes.clear();
+  return true;
+}
+
+History::History(size_t memory_budget) : m_memory_budget(memory_budget)
+{
+}
+
+History::~History()
+{
+  m_compress_pool.Cancel();
+}
+
+void History::Add(State::DeltaChain chain)
+{
+  auto segment = std::make_shared<Segment>();
+  segment->chain = std::move(chain);
+  segment->memory_usage = segment->chain.GetMemoryUsage();
+
+  m_segments.push_back(segment);
+  m_compress_pool.Submit([segment = std::move(segment)] { CompressSegment(*segment); });
+}
+
+std::optional<State::DeltaChain> History::TakeNewest()
+{
+  if (m_segments.empty())
+    return std::nullopt;
+
+  std::shared_ptr<Segment> segment = std::move(m_segments.back());
+  m_segments.pop_back();
+
+  std::lock_guard lk(segment->lock);
+  if (!DecompressSegment(*segment))
+  {
+    ERROR_LOG_FMT(CORE, "Failed to decompress rewind snapshots");
+    return std::nullopt;
+  }
+
+  State::DeltaChain chain = std::move(segment->chain);
+  segment->chain.Clear();
+  return chain;
+}
+
+void History::Clear()
+{
+  m_compress_pool.Cancel();
+  m_segments.clear();
+}
+
+void History::WaitForCompression()
+{
+  m_compress_pool.WaitForCompletion();
+}
+
+size_t History::GetSnapshotCount() const
+{
+  size_t count = 0;
+  for (const std::shared_ptr<Segment>& segment : m_segments)
+  {
+    std::lock_guard lk(segment->lock);
+    count += segment->chain.IsEmpty() ? segment->compressed.size() :
+                                        segment->chain.GetStateCount();
+  }
+  return count;
+}
+
+size_t History::GetMemoryUsage() const
+{
+  size_t memory_usage = 0;
+  for (const std::shared_ptr<Segment>& segment : m_segments)
+    memory_usage += segment->memory_usage;
+  return memory_usage;
+}
+
+void History::EnforceMemoryBudget(size_t other_memory_usage)
+{
+  size_t memory_usage = GetMemoryUsage() + other_memory_usage;
+  while (memory_usage > m_memory_budget && !m_segments.empty())
+  {
+    memory_usage -= m_segments.front()->memory_usage;
+    m_segments.pop_front();
+  }
+}
+
+// Protects s_current and s_history. Captures and rewinds happen on the host thread.
+static std::mutex s_lock;
+static State::DeltaChain s_current;
+static std::unique_ptr<History> s_history;
+
+static bool s_enabled;
+static u32 s_frame_interval;
+
+// Only touched on the CPU thread.
+static u32 s_fields_until_capture;
+static std::atomic<bool> s_capture_pending;
+
+static void Capture()
+{
+  if (!Core::IsRunningAndStarted())
+    return;
+
+  std::lock_guard lk(s_lock);
+
+  // Pauses the CPU thread for as long as hashing emulated memory takes, see State::DeltaChain.
+  const auto start = std::chrono::steady_clock::now();
+  State::SaveToChain(s_current);
+  const auto duration = std::chrono::steady_clock::now() - start;
+
+  DEBUG_LOG_FMT(CORE, "Rewind snapshot {} took {} us", s_current.GetStateCount(),
+                std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+
+  if (s_current.GetStateCount() >= SNAPSHOTS_PER_SEGMENT)
+  {
+    s_history->Add(std::move(s_current));
+    s_current.Clear();
+  }
+
+  s_history->EnforceMemoryBudget(s_current.GetMemoryUsage());
+}
+
+void Init()
+{
+  s_enabled = Config::Get(Config::MAIN_REWIND_ENABLE);
+  s_frame_interval = std::max(1, Config::Get(Config::MAIN_REWIND_FRAME_INTERVAL));
+
+  s_fields_until_capture = s_frame_interval;
+  s_capture_pending = false;
+
+  if (s_enabled)
+  {
+    const size_t memory_budget =
+        static_cast<size_t>(std::max(0, Config::Get(Config::MAIN_REWIND_MEMORY_MB))) << 20;
+
+    std::lock_guard lk(s_lock);
+    s_history = std::make_unique<History>(memory_budget);
+  }
+}
+
+void Shutdown()
+{
+  s_enabled = false;
+
+  std::lock_guard lk(s_lock);
+  s_current.Clear();
+  s_history.reset();
+}
+
+void OnNewField()
+{
+  if (!s_enabled || s_capture_pending.load())
+    return;
+
+  if (--s_fields_until_capture != 0)
+    return;
+  s_fields_until_capture = s_frame_interval;
+
+  // Loading a snapshot would desync netplay, and movies have no way of following along.
+  if (NetPlay::IsNetPlayRunning() || Movie::IsMovieActive())
+    return;
+
+  // Saving a state in the middle of a CoreTiming event would capture a half-updated machine,
+  // so let the host thread take the snapshot, which interrupts the CPU thread at a safe point.
+  s_capture_pending = true;
+  Core::QueueHostJob([] {
+    Capture();
+    s_capture_pending = false;
+  });
+}
+
+bool StepBack()
+{
+  if (!s_enabled)
+    return false;
+
+  std::lock_guard lk(s_lock);
+
+  bool success = false;
+  if (s_current.GetStateCount() >= 2)
+  {
+    // The newest snapshot was taken at most one interval ago, so skip over it to actually go back.
+    success = State::LoadFromChain(s_current, s_current.GetStateCount() - 2);
+  }
+  else if (std::optional<State::DeltaChain> chain = s_history->TakeNewest())
+  {
+    s_current = std::move(*chain);
+    success = State::LoadFromChain(s_current, s_current.GetStateCount() - 1);
+  }
+  else if (s_current.GetStateCount() == 1)
+  {
+    success = State::LoadFromChain(s_current, 0);
+  }
+
+  if (success)
+    s_fields_until_capture = s_frame_interval;
+
+  return success;
+}
+
+void Clear()
+{
+  std::lock_guard lk(s_lock);
+  s_current.Clear();
+  if (s_history)
+    s_history->Clear();
+}
+
+size_t GetSnapshotCount()
+{
+  return s_current.GetStateCount() + (s_history ? s_history->GetSnapshotCount() : 0);
+}
+
+size_t GetMemoryUsage()
+{
+  return s_current.GetMemoryUsage() + (s_history ? s_history->GetMemoryUsage() : 0);
+}
+}  // namespace Rewind
@@ -0,0 +1,76 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Keeps a bounded history of recent savestates in memory so that emulation can be stepped back.
+//
+// A snapshot is taken every few frames and appended to an incremental savestate chain (see
+// State::DeltaChain), which means only the pages of emulated memory that changed since the
+// previous snapshot get stored. Once a chain has grown long enough it is compressed on a
+// background thread and a new chain is started. The oldest chains are dropped whenever the
+// history exceeds its memory budget.
+//
+// Taking a snapshot pauses the CPU thread while emulated memory gets hashed, which takes a few
+// milliseconds (see State::DeltaChain), so the snapshot interval shouldn't be too short.
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <optional>
+
+#include "Common/ThreadPool.h"
+#include "Core/State.h"
+
+namespace Rewind
+{
+// The chains that have been completed, each of which gets compressed in the background.
+class History
+{
+public:
+  explicit History(size_t memory_budget);
+  ~History();
+
+  History(const History&) = delete;
+  History& operator=(const History&) = delete;
+
+  void Add(State::DeltaChain chain);
+  // Removes the newest chain from the history and returns it decompressed. Returns nothing if
+  // the history is empty or the chain couldn't be decompressed.
+  std::optional<State::DeltaChain> TakeNewest();
+  void Clear();
+
+  // Drops the oldest chains until they, together with other_memory_usage, fit in the budget.
+  void EnforceMemoryBudget(size_t other_memory_usage = 0);
+
+  // Blocks until every chain added so far has been compressed.
+  void WaitForCompression();
+
+  size_t GetSnapshotCount() const;
+  size_t GetMemoryUsage() const;
+
+  struct Segment;
+
+private:
+  size_t m_memory_budget;
+  // Oldest first.
+  std::deque<std::shared_ptr<Segment>> m_segments;
+
+  Common::ThreadPool m_compress_pool{1, "Rewind compression"};
+};
+
+void Init();
+void Shutdown();
+
+// Called on the CPU thread at the start of every field.
+void OnNewField();
+
+// Loads the most recent snapshot that is older than the current emulation state.
+// Returns false if there's nothing left to rewind to.
+bool StepBack();
+
+void Clear();
+
+size_t GetSnapshotCount();
+size_t GetMemoryUsage();
+}  // namespace Rewind
@@ -3,15 +3,22 @@
 
 #include "Core/State.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <lzo/lzo1x.h>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include <fmt/format.h>
+#include <xxhash.h>
+#include <zstd.h>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -21,9 +28,11 @@
 #include "Common/MsgHandler.h"
 #include "Common/ScopeGuard.h"
 #include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 #include "Common/Timer.h"
 #include "Common/Version.h"
 
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -54,10 +63,22 @@ static const u32 OUT_LEN = IN_LEN + (IN_LEN / 16) + 64 + 3;
 
 static unsigned char __LZO_MMODEL out[OUT_LEN];
 
-#define HEAP_ALLOC(var, size)                                                                      \
-  lzo_align_t __LZO_MMODEL var[((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t)]
+// States are split into chunks of this size, which get compressed independently of each other
+// so that compression and decompression can be spread across multiple threads.
+constexpr u32 STATE_CHUNK_SIZE = 1024 * 1024;
 
-static HEAP_ALLOC(wrkmem, LZO1X_1_MEM_COMPRESS);
+// Incremental states track changes to emulated memory with this granularity.
+constexpr u32 DELTA_PAGE_SIZE = 4096;
+
+// Each delta in a DeltaChain starts with this header. It is followed by a table of
+// changed_page_count u32 page indices, then by the contents of those pages, and finally by the
+// rest of the state (everything except emulated memory).
+struct DeltaStateHeader
+{
+  u32 page_size;
+  u32 total_page_count;
+  u32 changed_page_count;
+};
 
 static AfterLoadCallbackFunc s_on_after_load_callback;
 
@@ -73,6 +94,9 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 static std::recursive_mutex g_save_thread_mutex;
 static std::thread g_save_thread;
 
+// Used for compressing and decompressing states and for hashing emulated memory.
+static std::unique_ptr<Common::ThreadPool> s_thread_pool;
+
 // Don't forget to increase this after doing changes on the savestate system
 constexpr u32 STATE_VERSION = 144;  // Last changed in PR 10762
 
@@ -146,7 +170,7 @@ static bool DoStateVersion(PointerWrap& p, std::string* version_created_by)
   return true;
 }
 
-static void DoState(PointerWrap& p)
+static void DoState(PointerWrap& p, bool include_ram = true)
 {
   std::string version_created_by;
   if (!DoStateVersion(p, &version_created_by))
@@ -206,7 +230,7 @@ static void DoState(PointerWrap& p)
   // the controller code might need to schedule an event if the controller has changed.
   CoreTiming::DoState(p);
   p.DoMarker("CoreTiming");
-  HW::DoState(p);
+  HW::DoState(p, include_ram);
   p.DoMarker("HW");
   if (SConfig::GetInstance().bWii)
     Wiimote::DoState(p);
@@ -250,6 +274,215 @@ void SaveToBuffer(std::vector<u8>& buffer)
       true);
 }
 
+static std::vector<DeltaChain::Page> GetMemoryPages()
+{
+  std::vector<DeltaChain::Page> pages;
+  for (const Memory::StateRegion& region : Memory::GetStateRegions())
+  {
+    for (u32 offset = 0; offset < region.size; offset += DELTA_PAGE_SIZE)
+      pages.push_back({region.data + offset, std::min(DELTA_PAGE_SIZE, region.size - offset)});
+  }
+  return pages;
+}
+
+static std::vector<u64> HashMemoryPages(const std::vector<DeltaChain::Page>& pages)
+{
+  // Hashing all of MEM1 and MEM2 is most of the cost of saving a delta, so spread it out.
+  constexpr size_t PAGES_PER_TASK = 256;
+
+  std::vector<u64> hashes(pages.size());
+  const size_t task_count = (pages.size() + PAGES_PER_TASK - 1) / PAGES_PER_TASK;
+  s_thread_pool->ParallelFor(task_count, [&](size_t i) {
+    const size_t end = std::min(pages.size(), (i + 1) * PAGES_PER_TASK);
+    for (size_t j = i * PAGES_PER_TASK; j < end; ++j)
+      hashes[j] = XXH64(pages[j].data, pages[j].size, 0);
+  });
+  return hashes;
+}
+
+// Copies the pages stored in a delta into memory. Returns the offset of the rest of the state
+// within the delta, or nothing if the delta doesn't match the memory layout.
+static std::optional<size_t> ApplyDeltaPages(const std::vector<u8>& delta,
+                                             const std::vector<DeltaChain::Page>& pages)
+{
+  DeltaStateHeader header;
+  if (delta.size() < sizeof(header))
+    return std::nullopt;
+  std::memcpy(&header, delta.data(), sizeof(header));
+
+  if (header.page_size != DELTA_PAGE_SIZE || header.total_page_count != pages.size() ||
+      header.changed_page_count > pages.size())
+  {
+    return std::nullopt;
+  }
+
+  size_t offset = sizeof(header);
+  const size_t data_offset = offset + header.changed_page_count * sizeof(u32);
+  if (delta.size() < data_offset)
+    return std::nullopt;
+
+  std::vector<u32> indices(header.changed_page_count);
+  std::memcpy(indices.data(), delta.data() + offset, indices.size() * sizeof(u32));
+
+  offset = data_offset;
+  for (const u32 index : indices)
+  {
+    if (index >= pages.size() || delta.size() - offset < pages[index].size)
+      return std::nullopt;
+
+    std::memcpy(pages[index].data, delta.data() + offset, pages[index].size);
+    offset += pages[index].size;
+  }
+
+  return offset;
+}
+
+size_t DeltaChain::GetMemoryUsage() const
+{
+  size_t usage = base.size() + page_hashes.size() * sizeof(u64);
+  for (const std::vector<u8>& delta : deltas)
+    usage += delta.size();
+  return usage;
+}
+
+void DeltaChain::Clear()
+{
+  base.clear();
+  deltas.clear();
+  page_hashes.clear();
+}
+
+bool DeltaChain::Save(const std::vector<Page>& pages, const DoStateFunction& do_state)
+{
+  std::vector<u64> new_page_hashes = HashMemoryPages(pages);
+
+  if (IsEmpty() || page_hashes.size() != new_page_hashes.size())
+  {
+    Clear();
+
+    u8* ptr = nullptr;
+    PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
+    do_state(p_measure, true);
+    const size_t state_size = reinterpret_cast<size_t>(ptr);
+
+    std::vector<u8> state(state_size);
+    ptr = state.data();
+    PointerWrap p(&ptr, state_size, PointerWrap::Mode::Write);
+    do_state(p, true);
+    if (!p.IsWriteMode())
+      return false;
+
+    base = std::move(state);
+    page_hashes = std::move(new_page_hashes);
+    return true;
+  }
+
+  std::vector<u32> changed_pages;
+  size_t changed_size = 0;
+  for (u32 i = 0; i < static_cast<u32>(pages.size()); ++i)
+  {
+    if (new_page_hashes[i] != page_hashes[i])
+    {
+      changed_pages.push_back(i);
+      changed_size += pages[i].size;
+    }
+  }
+
+  u8* ptr = nullptr;
+  PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
+  do_state(p_measure, false);
+  const size_t state_size = reinterpret_cast<size_t>(ptr);
+
+  const DeltaStateHeader header{DELTA_PAGE_SIZE, static_cast<u32>(pages.size()),
+                                static_cast<u32>(changed_pages.size())};
+  const size_t state_offset = sizeof(header) + changed_pages.size() * sizeof(u32) + changed_size;
+
+  std::vector<u8> delta(state_offset + state_size);
+  u8* write_ptr = delta.data();
+  std::memcpy(write_ptr, &header, sizeof(header));
+  write_ptr += sizeof(header);
+  std::memcpy(write_ptr, changed_pages.data(), changed_pages.size() * sizeof(u32));
+  write_ptr += changed_pages.size() * sizeof(u32);
+  for (const u32 index : changed_pages)
+  {
+    std::memcpy(write_ptr, pages[index].data, pages[index].size);
+    write_ptr += pages[index].size;
+  }
+
+  ptr = delta.data() + state_offset;
+  PointerWrap p(&ptr, state_size, PointerWrap::Mode::Write);
+  do_state(p, false);
+  if (!p.IsWriteMode())
+    return false;
+
+  deltas.push_back(std::move(delta));
+  page_hashes = std::move(new_page_hashes);
+  return true;
+}
+
+bool DeltaChain::Load(size_t index, const std::vector<Page>& pages,
+                      const DoStateFunction& do_state)
+{
+  if (index >= GetStateCount())
+    return false;
+
+  u8* ptr = base.data();
+  PointerWrap p_base(&ptr, base.size(), PointerWrap::Mode::Read);
+  do_state(p_base, true);
+  if (!p_base.IsReadMode())
+    return false;
+
+  if (index != 0)
+  {
+    // Every delta only contains the pages that changed since the one before it, so all of
+    // them have to be applied in order.
+    std::optional<size_t> state_offset;
+    for (size_t i = 0; i < index; ++i)
+    {
+      state_offset = ApplyDeltaPages(deltas[i], pages);
+      if (!state_offset)
+      {
+        Core::DisplayMessage("The incremental savestate is corrupted", 2000);
+        return false;
+      }
+    }
+
+    std::vector<u8>& delta = deltas[index - 1];
+    ptr = delta.data() + *state_offset;
+    PointerWrap p(&ptr, delta.size() - *state_offset, PointerWrap::Mode::Read);
+    do_state(p, false);
+    if (!p.IsReadMode())
+      return false;
+  }
+
+  deltas.resize(index);
+  page_hashes = HashMemoryPages(pages);
+  return true;
+}
+
+void SaveToChain(DeltaChain& chain)
+{
+  Core::RunOnCPUThread(
+      [&] {
+        if (!chain.Save(GetMemoryPages(), DoState))
+          Core::DisplayMessage("Unable to save: Internal DoState Error", 4000);
+      },
+      true);
+}
+
+bool LoadFromChain(DeltaChain& chain, size_t index)
+{
+  if (NetPlay::IsNetPlayRunning())
+  {
+    OSD::AddMessage("Loading savestates is disabled in Netplay to prevent desyncs");
+    return false;
+  }
+
+  bool success = false;
+  Core::RunOnCPUThread([&] { success = chain.Load(index, GetMemoryPages(), DoState); }, true);
+  return success;
+}
+
 // return state number not in map
 static int GetEmptySlot(std::map<double, int> m)
 {
@@ -302,9 +535,57 @@ struct CompressAndDumpState_args
   std::vector<u8>* buffer_vector = nullptr;
   std::mutex* buffer_mutex = nullptr;
   std::string filename;
+  int compression_level = 0;
   bool wait = false;
 };
 
+static bool WriteChunkedState(File::IOFile& f, const u8* buffer_data, size_t buffer_size,
+                              int compression_level)
+{
+  const u32 chunk_count = static_cast<u32>((buffer_size + STATE_CHUNK_SIZE - 1) / STATE_CHUNK_SIZE);
+  std::vector<std::vector<u8>> chunks(chunk_count);
+  std::atomic<bool> failed = false;
+
+  s_thread_pool->ParallelFor(chunk_count, [&](size_t i) {
+    const size_t offset = i * STATE_CHUNK_SIZE;
+    const size_t size = std::min<size_t>(STATE_CHUNK_SIZE, buffer_size - offset);
+
+    std::vector<u8>& chunk = chunks[i];
+    chunk.resize(ZSTD_compressBound(size));
+    const size_t compressed_size =
+        ZSTD_compress(chunk.data(), chunk.size(), buffer_data + offset, size, compression_level);
+    if (ZSTD_isError(compressed_size))
+      failed = true;
+    else
+      chunk.resize(compressed_size);
+  });
+
+  if (failed)
+  {
+    PanicAlertFmtT("Internal Zstandard Error - compression failed");
+    return false;
+  }
+
+  const ChunkedStateHeader chunked_header{STATE_CHUNK_SIZE, chunk_count};
+  std::vector<u32> compressed_sizes(chunk_count);
+  std::transform(chunks.begin(), chunks.end(), compressed_sizes.begin(),
+                 [](const std::vector<u8>& chunk) { return static_cast<u32>(chunk.size()); });
+
+  if (!f.WriteArray(&chunked_header, 1) ||
+      !f.WriteArray(compressed_sizes.data(), compressed_sizes.size()))
+  {
+    return false;
+  }
+
+  for (const std::vector<u8>& chunk : chunks)
+  {
+    if (!f.WriteBytes(chunk.data(), chunk.size()))
+      return false;
+  }
+
+  return true;
+}
+
 static void CompressAndDumpState(CompressAndDumpState_args save_args)
 {
   std::lock_guard lk(*save_args.buffer_mutex);
@@ -358,6 +639,7 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
   // Setting up the header
   StateHeader header{};
   SConfig::GetInstance().GetGameID().copy(header.gameID, std::size(header.gameID));
+  header.compression = StateCompression::ZstdChunked;
   header.size = s_use_compression ? (u32)buffer_size : 0;
   header.time = Common::Timer::GetDoubleTime();
 
@@ -365,32 +647,10 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
 
   if (header.size != 0)  // non-zero header size means the state is compressed
   {
-    lzo_uint i = 0;
-    while (true)
+    if (!WriteChunkedState(f, buffer_data, buffer_size, save_args.compression_level))
     {
-      lzo_uint32 cur_len = 0;
-      lzo_uint out_len = 0;
-
-      if ((i + IN_LEN) >= buffer_size)
-      {
-        cur_len = (lzo_uint32)(buffer_size - i);
-      }
-      else
-      {
-        cur_len = IN_LEN;
-      }
-
-      if (lzo1x_1_compress(buffer_data + i, cur_len, out, &out_len, wrkmem) != LZO_E_OK)
-        PanicAlertFmtT("Internal LZO Error - compression failed");
-
-      // The size of the data to write is 'out_len'
-      f.WriteArray((lzo_uint32*)&out_len, 1);
-      f.WriteBytes(out, out_len);
-
-      if (cur_len != IN_LEN)
-        break;
-
-      i += cur_len;
+      Core::DisplayMessage("Could not save state", 2000);
+      return;
     }
   }
   else  // uncompressed
@@ -435,6 +695,9 @@ void SaveAs(const std::string& filename, bool wait)
           save_args.buffer_vector = &g_current_buffer;
           save_args.buffer_mutex = &g_cs_current_buffer;
           save_args.filename = filename;
+          save_args.compression_level =
+              std::clamp(Config::Get(Config::MAIN_STATE_COMPRESSION_LEVEL), ZSTD_minCLevel(),
+                         ZSTD_maxCLevel());
           save_args.wait = wait;
 
           {
@@ -485,6 +748,64 @@ u64 GetUnixTimeOfSlot(int slot)
          (Common::Timer::DOUBLE_TIME_OFFSET * MS_PER_SEC);
 }
 
+static bool ReadChunkedState(File::IOFile& f, u32 state_size, std::vector<u8>& buffer)
+{
+  ChunkedStateHeader chunked_header;
+  if (!f.ReadArray(&chunked_header, 1) || chunked_header.chunk_size == 0 ||
+      chunked_header.chunk_count !=
+          (u64{state_size} + chunked_header.chunk_size - 1) / chunked_header.chunk_size)
+  {
+    PanicAlertFmtT("The savestate's chunk table is invalid");
+    return false;
+  }
+
+  const u32 chunk_count = chunked_header.chunk_count;
+  std::vector<u32> compressed_sizes(chunk_count);
+  if (!f.ReadArray(compressed_sizes.data(), chunk_count))
+  {
+    PanicAlertFmtT("The savestate's chunk table is invalid");
+    return false;
+  }
+
+  std::vector<u64> compressed_offsets(chunk_count);
+  u64 compressed_total = 0;
+  for (u32 i = 0; i < chunk_count; ++i)
+  {
+    compressed_offsets[i] = compressed_total;
+    compressed_total += compressed_sizes[i];
+  }
+
+  std::vector<u8> compressed(compressed_total);
+  if (!f.ReadBytes(compressed.data(), compressed.size()))
+  {
+    PanicAlertFmt("Error reading bytes: {0}", compressed.size());
+    return false;
+  }
+
+  buffer.resize(state_size);
+  std::atomic<bool> failed = false;
+
+  s_thread_pool->ParallelFor(chunk_count, [&](size_t i) {
+    const size_t offset = i * chunked_header.chunk_size;
+    const size_t size = std::min<size_t>(chunked_header.chunk_size, state_size - offset);
+
+    const size_t result = ZSTD_decompress(buffer.data() + offset, size,
+                                          compressed.data() + compressed_offsets[i],
+                                          compressed_sizes[i]);
+    if (ZSTD_isError(result) || result != size)
+      failed = true;
+  });
+
+  if (failed)
+  {
+    PanicAlertFmtT("Internal Zstandard Error - decompression failed\n"
+                   "Try loading the state again");
+    return false;
+  }
+
+  return true;
+}
+
 static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_data)
 {
   Flush();
@@ -507,7 +828,14 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
 
   std::vector<u8> buffer;
 
-  if (header.size != 0)  // non-zero size means the state is compressed
+  if (header.size != 0 && header.compression == StateCompression::ZstdChunked)
+  {
+    Core::DisplayMessage("Decompressing State...", 500);
+
+    if (!ReadChunkedState(f, header.size, buffer))
+      return;
+  }
+  else if (header.size != 0)  // non-zero size means the state is compressed
   {
     Core::DisplayMessage("Decompressing State...", 500);
 
@@ -633,6 +961,8 @@ void Init()
 {
   if (lzo_init() != LZO_E_OK)
     PanicAlertFmtT("Internal LZO Error - lzo_init() failed");
+
+  s_thread_pool = std::make_unique<Common::ThreadPool>(0, "SaveState worker");
 }
 
 void Shutdown()
@@ -651,6 +981,8 @@ void Shutdown()
     std::lock_guard lk(g_cs_undo_load_buffer);
     std::vector<u8>().swap(g_undo_load_buffer);
   }
+
+  s_thread_pool.reset();
 }
 
 static std::string MakeStateFilename(int number)
@@ -12,15 +12,27 @@
 
 #include "Common/CommonTypes.h"
 
+class PointerWrap;
+
 namespace State
 {
 // number of states
 static const u32 NUM_STATES = 10;
 
+// How the state data following the header is stored. States with a size of 0 in the header
+// are stored uncompressed regardless of this value.
+enum class StateCompression : u16
+{
+  // Written by older versions of Dolphin, which left this field zeroed.
+  LZO = 0,
+  // The state is split into independently compressed chunks, see ChunkedStateHeader.
+  ZstdChunked = 1,
+};
+
 struct StateHeader
 {
   char gameID[6];
-  u16 reserved1;
+  StateCompression compression;
   u32 size;
   u32 reserved2;
   double time;
@@ -30,6 +42,16 @@ static_assert(STATE_HEADER_SIZE == 24);
 static_assert(offsetof(StateHeader, size) == 8);
 static_assert(offsetof(StateHeader, time) == 16);
 
+// Follows the StateHeader for StateCompression::ZstdChunked. It is followed in turn by a table
+// of chunk_count u32 compressed sizes and then the compressed chunks themselves. Every chunk
+// except for the last one decompresses to exactly chunk_size bytes.
+struct ChunkedStateHeader
+{
+  u32 chunk_size;
+  u32 chunk_count;
+};
+static_assert(sizeof(ChunkedStateHeader) == 8);
+
 void Init();
 
 void Shutdown();
@@ -59,6 +81,48 @@ void LoadAs(const std::string& filename);
 void SaveToBuffer(std::vector<u8>& buffer);
 void LoadFromBuffer(std::vector<u8>& buffer);
 
+// Incremental savestates. A chain starts with a full state, and every state saved to it after
+// that is stored as a delta which only contains the pages of emulated memory that changed since
+// the previous state in the chain, plus the rest of the emulated state (which is small compared
+// to emulated memory). Changed pages are found by comparing hashes rather than contents, so the
+// chain doesn't have to keep an uncompressed copy of emulated memory around.
+//
+// Hashing every page is what makes saving a delta expensive. The 88 MiB of a Wii take about 20 ms
+// on one core, which the savestate worker threads split between them. Copying memory out to diff
+// it later costs about as much as hashing it, so that wouldn't let the CPU thread resume sooner.
+struct DeltaChain
+{
+  struct Page
+  {
+    u8* data;
+    u32 size;
+  };
+
+  // Reads or writes the state. The pages tracked by the chain are only included if include_ram
+  // is true.
+  using DoStateFunction = std::function<void(PointerWrap& p, bool include_ram)>;
+
+  std::vector<u8> base;
+  std::vector<std::vector<u8>> deltas;
+  // A hash of every page of emulated memory, as of the newest state in the chain.
+  std::vector<u64> page_hashes;
+
+  bool IsEmpty() const { return base.empty(); }
+  size_t GetStateCount() const { return base.empty() ? 0 : deltas.size() + 1; }
+  size_t GetMemoryUsage() const;
+  void Clear();
+
+  // What SaveToChain and LoadFromChain do on the CPU thread, but for any memory and state.
+  bool Save(const std::vector<Page>& pages, const DoStateFunction& do_state);
+  bool Load(size_t index, const std::vector<Page>& pages, const DoStateFunction& do_state);
+};
+
+// Saves a full state if the chain is empty, and a delta otherwise.
+void SaveToChain(DeltaChain& chain);
+// Loads the state at the given position in the chain, where 0 is the full state. Any newer states
+// are dropped from the chain, so that states saved afterwards continue from the loaded one.
+bool LoadFromChain(DeltaChain& chain, size_t index);
+
 void LoadLastSaved(int i = 1);
 void SaveFirstSaved();
 void UndoSaveState();
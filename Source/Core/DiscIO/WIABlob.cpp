@@ -27,6 +27,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/ScopeGuard.h"
 #include "Common/Swap.h"
+#include "Common/ThreadPool.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/DiscUtils.h"
@@ -40,6 +41,13 @@
 
 namespace DiscIO
 {
+// Shared by all readers, since there's rarely more than one that reads sequentially.
+static Common::ThreadPool& GetPrefetchPool()
+{
+  static Common::ThreadPool pool(2, "WIA Prefetch");
+  return pool;
+}
+
 static void PushBack(std::vector<u8>* vector, const u8* begin, const u8* end)
 {
   const size_t offset_in_vector = vector->size();
@@ -79,13 +87,21 @@ std::pair<int, int> GetAllowedCompressionLevels(WIARVZCompressionType compressio
 
 template <bool RVZ>
 WIARVZFileReader<RVZ>::WIARVZFileReader(File::IOFile file, const std::string& path)
-    : m_file(std::move(file)), m_encryption_cache(this)
+    : m_file(std::move(file)), m_path(path), m_encryption_cache(this)
 {
   m_valid = Initialize(path);
 }
 
 template <bool RVZ>
-WIARVZFileReader<RVZ>::~WIARVZFileReader() = default;
+WIARVZFileReader<RVZ>::~WIARVZFileReader()
+{
+  // Don't wait for prefetches that are still running. Their results are no longer needed.
+  if (m_prefetch_state)
+  {
+    std::lock_guard lk(m_prefetch_state->lock);
+    m_prefetch_state->reader = nullptr;
+  }
+}
 
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
@@ -210,11 +226,11 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
 
   const u32 number_of_raw_data_entries = Common::swap32(m_header_2.number_of_raw_data_entries);
   m_raw_data_entries.resize(number_of_raw_data_entries);
-  Chunk& raw_data_entries =
+  const std::shared_ptr<Chunk> raw_data_entries =
       ReadCompressedData(Common::swap64(m_header_2.raw_data_entries_offset),
                          Common::swap32(m_header_2.raw_data_entries_size),
                          number_of_raw_data_entries * sizeof(RawDataEntry), m_compression_type);
-  if (!raw_data_entries.ReadAll(&m_raw_data_entries))
+  if (!raw_data_entries->ReadAll(&m_raw_data_entries))
     return false;
 
   for (size_t i = 0; i < m_raw_data_entries.size(); ++i)
@@ -227,11 +243,11 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
 
   const u32 number_of_group_entries = Common::swap32(m_header_2.number_of_group_entries);
   m_group_entries.resize(number_of_group_entries);
-  Chunk& group_entries =
+  const std::shared_ptr<Chunk> group_entries =
       ReadCompressedData(Common::swap64(m_header_2.group_entries_offset),
                          Common::swap32(m_header_2.group_entries_size),
                          number_of_group_entries * sizeof(GroupEntry), m_compression_type);
-  if (!group_entries.ReadAll(&m_group_entries))
+  if (!group_entries->ReadAll(&m_group_entries))
     return false;
 
   if (HasDataOverlap())
@@ -494,37 +510,37 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
   if (*offset < data_offset)
     return false;
 
+  if (*offset == m_last_read_end && group_index == m_last_read_group_index)
+    ++m_sequential_reads;
+  else
+    m_sequential_reads = 0;
+
   const u64 skipped_data = data_offset % sector_size;
   data_offset -= skipped_data;
   data_size += skipped_data;
 
+  const u64 full_chunk_size = chunk_size;
   const u64 start_group_index = (*offset - data_offset) / chunk_size;
-  for (u64 i = start_group_index; i < number_of_groups && (*size) > 0; ++i)
+  u64 i = start_group_index;
+  for (; i < number_of_groups && (*size) > 0; ++i)
   {
     const u64 total_group_index = group_index + i;
-    if (total_group_index >= m_group_entries.size())
+    u64 group_offset_in_file;
+    u32 group_data_size;
+    WIARVZCompressionType compression_type;
+    u32 rvz_packed_size;
+    if (!GetGroupData(total_group_index, &group_offset_in_file, &group_data_size,
+                      &compression_type, &rvz_packed_size))
+    {
       return false;
+    }
 
-    const GroupEntry group = m_group_entries[total_group_index];
     const u64 group_offset_in_data = i * chunk_size;
     const u64 offset_in_group = *offset - group_offset_in_data - data_offset;
 
     chunk_size = std::min(chunk_size, data_size - group_offset_in_data);
 
     const u64 bytes_to_read = std::min(chunk_size - offset_in_group, *size);
-    u32 group_data_size = Common::swap32(group.data_size);
-
-    WIARVZCompressionType compression_type = m_compression_type;
-    u32 rvz_packed_size = 0;
-    if constexpr (RVZ)
-    {
-      if ((group_data_size & 0x80000000) == 0)
-        compression_type = WIARVZCompressionType::None;
-
-      group_data_size &= 0x7FFFFFFF;
-
-      rvz_packed_size = Common::swap32(group.rvz_packed_size);
-    }
 
     if (group_data_size == 0)
     {
@@ -532,15 +548,14 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
     }
     else
     {
-      const u64 group_offset_in_file = static_cast<u64>(Common::swap32(group.data_offset)) << 2;
-
-      Chunk& chunk =
+      const std::shared_ptr<Chunk> chunk =
           ReadCompressedData(group_offset_in_file, group_data_size, chunk_size, compression_type,
                              exception_lists, rvz_packed_size, group_offset_in_data);
 
-      if (!chunk.Read(offset_in_group, bytes_to_read, *out_ptr))
+      if (!chunk->Read(offset_in_group, bytes_to_read, *out_ptr))
       {
-        m_cached_chunk_offset = std::numeric_limits<u64>::max();  // Invalidate the cache
+        std::lock_guard lk(m_cached_chunks_mutex);
+        UncacheChunk(group_offset_in_file);
         return false;
       }
 
@@ -550,7 +565,7 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
         const u16 additional_offset =
             static_cast<u16>(group_offset_in_data % VolumeWii::GROUP_DATA_SIZE /
                              VolumeWii::BLOCK_DATA_SIZE * VolumeWii::BLOCK_HEADER_SIZE);
-        chunk.GetHashExceptions(&m_exception_list, exception_list_index, additional_offset);
+        chunk->GetHashExceptions(&m_exception_list, exception_list_index, additional_offset);
         m_exception_list_last_group_index = total_group_index;
       }
     }
@@ -560,19 +575,201 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
     *out_ptr += bytes_to_read;
   }
 
+  m_last_read_end = *offset;
+  m_last_read_group_index = group_index;
+
+  // Sequential reads tend to go on, so get the following chunks ready.
+  if (m_sequential_reads < SEQUENTIAL_READS_BEFORE_PREFETCH)
+    return true;
+
+  const u64 prefetch_end = std::min<u64>(i + PREFETCH_CHUNKS, number_of_groups);
+  for (; i < prefetch_end; ++i)
+  {
+    u64 group_offset_in_file;
+    u32 group_data_size;
+    WIARVZCompressionType compression_type;
+    u32 rvz_packed_size;
+    if (!GetGroupData(group_index + i, &group_offset_in_file, &group_data_size, &compression_type,
+                      &rvz_packed_size))
+    {
+      break;
+    }
+
+    if (group_data_size == 0)
+      continue;
+
+    const u64 group_offset_in_data = i * full_chunk_size;
+    PrefetchCompressedData(group_offset_in_file, group_data_size,
+                           std::min(full_chunk_size, data_size - group_offset_in_data),
+                           compression_type, exception_lists, rvz_packed_size,
+                           group_offset_in_data);
+  }
+
+  return true;
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::GetGroupData(u64 total_group_index, u64* offset_in_file,
+                                         u32* data_size, WIARVZCompressionType* compression_type,
+                                         u32* rvz_packed_size) const
+{
+  if (total_group_index >= m_group_entries.size())
+    return false;
+
+  const GroupEntry& group = m_group_entries[total_group_index];
+  *offset_in_file = static_cast<u64>(Common::swap32(group.data_offset)) << 2;
+  *data_size = Common::swap32(group.data_size);
+  *compression_type = m_compression_type;
+  *rvz_packed_size = 0;
+  if constexpr (RVZ)
+  {
+    if ((*data_size & 0x80000000) == 0)
+      *compression_type = WIARVZCompressionType::None;
+
+    *data_size &= 0x7FFFFFFF;
+
+    *rvz_packed_size = Common::swap32(group.rvz_packed_size);
+  }
+
   return true;
 }
 
 template <bool RVZ>
-typename WIARVZFileReader<RVZ>::Chunk&
+std::shared_ptr<typename WIARVZFileReader<RVZ>::Chunk>
 WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_size,
                                           u64 decompressed_size,
                                           WIARVZCompressionType compression_type,
                                           u32 exception_lists, u32 rvz_packed_size, u64 data_offset)
 {
-  if (offset_in_file == m_cached_chunk_offset)
-    return m_cached_chunk;
+  std::unique_lock lk(m_cached_chunks_mutex);
+
+  // If the chunk is being prefetched, waiting for it is faster than decompressing it again.
+  m_prefetch_done.wait(lk, [&] { return !IsPrefetchPending(offset_in_file); });
+
+  std::shared_ptr<Chunk> chunk = FindCachedChunk(offset_in_file);
+  if (!chunk)
+  {
+    chunk = CreateChunk(&m_file, offset_in_file, compressed_size, decompressed_size,
+                        compression_type, exception_lists, rvz_packed_size, data_offset);
+    CacheChunk(offset_in_file, compressed_size + decompressed_size, chunk);
+  }
+
+  return chunk;
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::PrefetchCompressedData(u64 offset_in_file, u64 compressed_size,
+                                                   u64 decompressed_size,
+                                                   WIARVZCompressionType compression_type,
+                                                   u32 exception_lists, u32 rvz_packed_size,
+                                                   u64 data_offset)
+{
+  {
+    std::lock_guard lk(m_cached_chunks_mutex);
+    if (IsPrefetchPending(offset_in_file) || FindCachedChunk(offset_in_file))
+      return;
+    m_pending_prefetches.push_back(offset_in_file);
+  }
+
+  if (!m_prefetch_state)
+  {
+    m_prefetch_state = std::make_shared<PrefetchState>();
+    m_prefetch_state->reader = this;
+  }
+
+  // The task doesn't access the reader until it is done, since the reader may be gone by then.
+  std::shared_ptr<Chunk> chunk =
+      CreateChunk(nullptr, offset_in_file, compressed_size, decompressed_size, compression_type,
+                  exception_lists, rvz_packed_size, data_offset);
+  GetPrefetchPool().Submit([state = m_prefetch_state, path = m_path, chunk = std::move(chunk),
+                            offset_in_file, size = compressed_size + decompressed_size]() mutable {
+    {
+      std::lock_guard lk(state->lock);
+      if (!state->reader)
+        return;
+    }
+
+    // m_file can't be shared with the thread that is reading, since every read seeks it.
+    File::IOFile file(path, "rb");
+    const bool success = file.IsOpen() && chunk->DecompressAll(&file);
+
+    std::lock_guard lk(state->lock);
+    if (state->reader)
+      state->reader->FinishPrefetch(offset_in_file, size, std::move(chunk), success);
+  });
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::FinishPrefetch(u64 offset_in_file, size_t size,
+                                           std::shared_ptr<Chunk> chunk, bool success)
+{
+  {
+    std::lock_guard lk(m_cached_chunks_mutex);
+    m_pending_prefetches.erase(
+        std::find(m_pending_prefetches.begin(), m_pending_prefetches.end(), offset_in_file));
+    if (success)
+      CacheChunk(offset_in_file, size, std::move(chunk));
+  }
+  m_prefetch_done.notify_all();
+}
+
+template <bool RVZ>
+std::shared_ptr<typename WIARVZFileReader<RVZ>::Chunk>
+WIARVZFileReader<RVZ>::FindCachedChunk(u64 offset_in_file)
+{
+  const auto it = std::find_if(m_cached_chunks.begin(), m_cached_chunks.end(),
+                               [offset_in_file](const CachedChunk& cached) {
+                                 return cached.offset_in_file == offset_in_file;
+                               });
+  if (it == m_cached_chunks.end())
+    return nullptr;
+
+  m_cached_chunks.splice(m_cached_chunks.begin(), m_cached_chunks, it);
+  return it->chunk;
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::CacheChunk(u64 offset_in_file, size_t size,
+                                       std::shared_ptr<Chunk> chunk)
+{
+  m_cached_chunks.push_front({offset_in_file, size, std::move(chunk)});
+  m_cached_chunks_size += size;
 
+  while (m_cached_chunks_size > MAX_CACHED_CHUNKS_SIZE && m_cached_chunks.size() > 1)
+  {
+    m_cached_chunks_size -= m_cached_chunks.back().size;
+    m_cached_chunks.pop_back();
+  }
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::UncacheChunk(u64 offset_in_file)
+{
+  const auto it = std::find_if(m_cached_chunks.begin(), m_cached_chunks.end(),
+                               [offset_in_file](const CachedChunk& cached) {
+                                 return cached.offset_in_file == offset_in_file;
+                               });
+  if (it == m_cached_chunks.end())
+    return;
+
+  m_cached_chunks_size -= it->size;
+  m_cached_chunks.erase(it);
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::IsPrefetchPending(u64 offset_in_file) const
+{
+  return std::find(m_pending_prefetches.begin(), m_pending_prefetches.end(), offset_in_file) !=
+         m_pending_prefetches.end();
+}
+
+template <bool RVZ>
+std::shared_ptr<typename WIARVZFileReader<RVZ>::Chunk>
+WIARVZFileReader<RVZ>::CreateChunk(File::IOFile* file, u64 offset_in_file, u64 compressed_size,
+                                   u64 decompressed_size, WIARVZCompressionType compression_type,
+                                   u32 exception_lists, u32 rvz_packed_size,
+                                   u64 data_offset) const
+{
   std::unique_ptr<Decompressor> decompressor;
   switch (compression_type)
   {
@@ -601,11 +798,9 @@ WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_siz
 
   const bool compressed_exception_lists = compression_type > WIARVZCompressionType::Purge;
 
-  m_cached_chunk =
-      Chunk(&m_file, offset_in_file, compressed_size, decompressed_size, exception_lists,
-            compressed_exception_lists, rvz_packed_size, data_offset, std::move(decompressor));
-  m_cached_chunk_offset = offset_in_file;
-  return m_cached_chunk;
+  return std::make_shared<Chunk>(file, offset_in_file, compressed_size, decompressed_size,
+                                 exception_lists, compressed_exception_lists, rvz_packed_size,
+                                 data_offset, std::move(decompressor));
 }
 
 template <bool RVZ>
@@ -649,16 +844,35 @@ WIARVZFileReader<RVZ>::Chunk::Chunk(File::IOFile* file, u64 offset_in_file, u64
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
 {
-  if (!m_decompressor || !m_file ||
-      offset + size > m_out.data.size() - m_out_bytes_allocated_for_exceptions)
-  {
+  if (!DecompressUntil(offset + size))
     return false;
-  }
 
-  while (offset + size > GetOutBytesWrittenExcludingExceptions())
+  std::memcpy(out_ptr, m_out.data.data() + offset + m_out_bytes_used_for_exceptions, size);
+  return true;
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::Chunk::DecompressAll(File::IOFile* file)
+{
+  m_file = file;
+  const bool success = DecompressUntil(m_out.data.size() - m_out_bytes_allocated_for_exceptions);
+  m_file = nullptr;
+  return success;
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::Chunk::DecompressUntil(u64 end)
+{
+  if (!m_decompressor || end > m_out.data.size() - m_out_bytes_allocated_for_exceptions)
+    return false;
+
+  while (end > GetOutBytesWrittenExcludingExceptions())
   {
+    if (!m_file)
+      return false;
+
     u64 bytes_to_read;
-    if (offset + size == m_out.data.size())
+    if (end == m_out.data.size())
     {
       // Read all the remaining data.
       bytes_to_read = m_in.data.size() - m_in.bytes_written;
@@ -671,7 +885,7 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
 
       // The compressed data is probably not much bigger than the decompressed data.
       // Add a few bytes for possible compression overhead and for any hash exceptions.
-      bytes_to_read = offset + size - GetOutBytesWrittenExcludingExceptions() + 0x100;
+      bytes_to_read = end - GetOutBytesWrittenExcludingExceptions() + 0x100;
 
       // Align the access in an attempt to gain speed. But we don't actually know the
       // block size of the underlying storage device, so we just use the Wii block size.
@@ -751,7 +965,6 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
     }
   }
 
-  std::memcpy(out_ptr, m_out.data.data() + offset + m_out_bytes_used_for_exceptions, size);
   return true;
 }
 
@@ -4,12 +4,16 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
@@ -193,6 +197,10 @@ private:
 
     bool Read(u64 offset, u64 size, u8* out_ptr);
 
+    // Decompresses everything in advance, reading from the given file rather than the one the
+    // chunk was created with. Afterwards, the chunk no longer accesses any file.
+    bool DecompressAll(File::IOFile* file);
+
     // This can only be called once at least one byte of data has been read
     void GetHashExceptions(std::vector<HashExceptionEntry>* exception_list,
                            u64 exception_list_index, u16 additional_offset) const;
@@ -204,6 +212,7 @@ private:
     }
 
   private:
+    bool DecompressUntil(u64 end);
     bool Decompress();
     bool HandleExceptions(const u8* data, size_t bytes_allocated, size_t bytes_written,
                           size_t* bytes_used, bool align);
@@ -236,9 +245,30 @@ private:
   bool ReadFromGroups(u64* offset, u64* size, u8** out_ptr, u64 chunk_size, u32 sector_size,
                       u64 data_offset, u64 data_size, u32 group_index, u32 number_of_groups,
                       u32 exception_lists);
-  Chunk& ReadCompressedData(u64 offset_in_file, u64 compressed_size, u64 decompressed_size,
-                            WIARVZCompressionType compression_type, u32 exception_lists = 0,
-                            u32 rvz_packed_size = 0, u64 data_offset = 0);
+  bool GetGroupData(u64 total_group_index, u64* offset_in_file, u32* data_size,
+                    WIARVZCompressionType* compression_type, u32* rvz_packed_size) const;
+  std::shared_ptr<Chunk> ReadCompressedData(u64 offset_in_file, u64 compressed_size,
+                                            u64 decompressed_size,
+                                            WIARVZCompressionType compression_type,
+                                            u32 exception_lists = 0, u32 rvz_packed_size = 0,
+                                            u64 data_offset = 0);
+  std::shared_ptr<Chunk> CreateChunk(File::IOFile* file, u64 offset_in_file, u64 compressed_size,
+                                     u64 decompressed_size,
+                                     WIARVZCompressionType compression_type, u32 exception_lists,
+                                     u32 rvz_packed_size, u64 data_offset) const;
+
+  // Decompresses a chunk on the prefetch threads, so that it's ready when it gets read.
+  void PrefetchCompressedData(u64 offset_in_file, u64 compressed_size, u64 decompressed_size,
+                              WIARVZCompressionType compression_type, u32 exception_lists,
+                              u32 rvz_packed_size, u64 data_offset);
+  void FinishPrefetch(u64 offset_in_file, size_t size, std::shared_ptr<Chunk> chunk,
+                      bool success);
+
+  // These must be called with m_cached_chunks_mutex held.
+  std::shared_ptr<Chunk> FindCachedChunk(u64 offset_in_file);
+  void CacheChunk(u64 offset_in_file, size_t size, std::shared_ptr<Chunk> chunk);
+  void UncacheChunk(u64 offset_in_file);
+  bool IsPrefetchPending(u64 offset_in_file) const;
 
   static bool ApplyHashExceptions(const std::vector<HashExceptionEntry>& exception_list,
                                   VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]);
@@ -365,10 +395,24 @@ private:
   WIARVZCompressionType m_compression_type;
 
   File::IOFile m_file;
-  Chunk m_cached_chunk;
-  u64 m_cached_chunk_offset = std::numeric_limits<u64>::max();
+  std::string m_path;
   WiiEncryptionCache m_encryption_cache;
 
+  struct CachedChunk
+  {
+    u64 offset_in_file;
+    size_t size;
+    std::shared_ptr<Chunk> chunk;
+  };
+
+  // Most recently used first. Prefetched chunks are fully decompressed, while the others are
+  // only decompressed as far as they have been read.
+  std::list<CachedChunk> m_cached_chunks;
+  size_t m_cached_chunks_size = 0;
+  std::vector<u64> m_pending_prefetches;
+  std::mutex m_cached_chunks_mutex;
+  std::condition_variable m_prefetch_done;
+
   std::vector<HashExceptionEntry> m_exception_list;
   bool m_write_to_exception_list = false;
   u64 m_exception_list_last_group_index;
@@ -381,6 +425,31 @@ private:
 
   std::map<u64, DataEntry> m_data_entries;
 
+  // Where the last read from the data of group_index ended, and how many reads in a row have
+  // continued where the one before them ended. Only sequential reads get prefetched for, so that
+  // readers that read a few small things (like those of the game list) don't decompress more.
+  u64 m_last_read_end = std::numeric_limits<u64>::max();
+  u32 m_last_read_group_index = 0;
+  u32 m_sequential_reads = 0;
+
+  // Shared with the prefetch tasks, which are left to finish on their own when the reader is
+  // destroyed. They only hand their chunk to the reader if it still exists. Created on the first
+  // prefetch.
+  struct PrefetchState
+  {
+    std::mutex lock;
+    WIARVZFileReader* reader;
+  };
+  std::shared_ptr<PrefetchState> m_prefetch_state;
+
+  // Chunks are evicted once the cache takes up more than this many bytes, except for the most
+  // recently used one.
+  static constexpr size_t MAX_CACHED_CHUNKS_SIZE = 32 * 1024 * 1024;
+  // How many of the chunks following the last chunk a read touched get decompressed ahead.
+  static constexpr u64 PREFETCH_CHUNKS = 2;
+  // How many reads in a row have to continue where the one before them ended before prefetching.
+  static constexpr u32 SEQUENTIAL_READS_BEFORE_PREFETCH = 2;
+
   // Perhaps we could set WIA_VERSION_WRITE_COMPATIBLE to 0.9, but WIA version 0.9 was never in
   // any official release of wit, and interim versions (either source or binaries) are hard to find.
   // Since we've been unable to check if we're write compatible with 0.9, we set it 1.0 to be safe.
@@ -58,6 +58,7 @@
 #include "Core/NetPlayClient.h"
 #include "Core/NetPlayProto.h"
 #include "Core/NetPlayServer.h"
+#include "Core/Rewind.h"
 #include "Core/State.h"
 #include "Core/WiiUtils.h"
 
@@ -616,6 +617,7 @@ void MainWindow::ConnectHotkeys()
           &MainWindow::StateLoadLastSavedAt);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateLoadUndo, this, &MainWindow::StateLoadUndo);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateSaveUndo, this, &MainWindow::StateSaveUndo);
+  connect(m_hotkey_scheduler, &HotkeyScheduler::StateRewind, this, &MainWindow::StateRewind);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateSaveOldest, this,
           &MainWindow::StateSaveOldest);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateSaveFile, this, &MainWindow::StateSave);
@@ -1375,6 +1377,11 @@ void MainWindow::StateSaveUndo()
   State::UndoSaveState();
 }
 
+void MainWindow::StateRewind()
+{
+  Rewind::StepBack();
+}
+
 void MainWindow::StateSaveOldest()
 {
   State::SaveFirstSaved();
@@ -0,0 +1,346 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/BenchCommand.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <picojson.h>
+
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/Flag.h"
+#include "Common/WindowSystemInfo.h"
+#include "Core/Boot/Boot.h"
+#include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/Core.h"
+#include "Core/FifoPlayer/FifoPlayer.h"
+#include "UICommon/UICommon.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VideoBackendBase.h"
+
+namespace DolphinTool
+{
+namespace
+{
+// The counters at the start of a frame.
+struct Snapshot
+{
+  u32 frame;
+  std::chrono::steady_clock::time_point time;
+  u64 command_processing_ns;
+  u64 vertex_loading_ns;
+  int shaders_created;
+  int vertex_loaders_created;
+};
+
+Snapshot TakeSnapshot(u32 frame)
+{
+  return {frame,
+          std::chrono::steady_clock::now(),
+          g_stats.command_processing_ns.load(std::memory_order_relaxed),
+          g_stats.vertex_loading_ns.load(std::memory_order_relaxed),
+          g_stats.num_pixel_shaders_created + g_stats.num_vertex_shaders_created,
+          g_stats.num_vertex_loaders};
+}
+
+double NanosecondsToMilliseconds(u64 ns)
+{
+  return static_cast<double>(ns) / 1000000.0;
+}
+
+struct Summary
+{
+  double mean;
+  double p50;
+  double p90;
+  double p99;
+  double max;
+};
+
+// Nearest-rank percentiles.
+template <typename T>
+Summary Summarize(const std::vector<T>& samples, double T::*member)
+{
+  std::vector<double> values(samples.size());
+  std::transform(samples.begin(), samples.end(), values.begin(),
+                 [member](const T& sample) { return sample.*member; });
+  std::sort(values.begin(), values.end());
+
+  const auto percentile = [&values](double p) {
+    const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+    return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+  };
+
+  return {std::accumulate(values.begin(), values.end(), 0.0) / values.size(), percentile(50),
+          percentile(90), percentile(99), values.back()};
+}
+
+picojson::value SummaryToJSON(const Summary& summary)
+{
+  picojson::object json;
+  json.emplace("mean", summary.mean);
+  json.emplace("p50", summary.p50);
+  json.emplace("p90", summary.p90);
+  json.emplace("p99", summary.p99);
+  json.emplace("max", summary.max);
+  return picojson::value(std::move(json));
+}
+}  // namespace
+
+int BenchCommand::Main(const std::vector<std::string>& args)
+{
+  auto parser = std::make_unique<optparse::OptionParser>();
+
+  parser->usage("usage: bench [options]...");
+
+  parser->add_option("-u", "--user")
+      .action("store")
+      .help("User folder path, required for temporary processing files. "
+            "Will be automatically created if this option is not set.");
+
+  parser->add_option("-i", "--input")
+      .type("string")
+      .action("store")
+      .help("Path to FIFO log FILE.")
+      .metavar("FILE");
+
+  parser->add_option("-o", "--output")
+      .type("string")
+      .action("store")
+      .help("Optional. Path to write the report to. Only a summary is printed if not set.")
+      .metavar("FILE");
+
+  parser->add_option("-f", "--format")
+      .type("string")
+      .action("store")
+      .help("Format of the report. [%choices]")
+      .choices({"json", "csv"})
+      .set_default("json");
+
+  parser->add_option("-b", "--video_backend")
+      .type("string")
+      .action("store")
+      .help("Video backend to replay the FIFO log with. [default: %default]")
+      .metavar("BACKEND")
+      .set_default("Null");
+
+  parser->add_option("-l", "--loops")
+      .type("int")
+      .action("store")
+      .help("Number of times to measure the FIFO log. [default: %default]")
+      .set_default(1);
+
+  parser->add_option("-w", "--warmup")
+      .type("int")
+      .action("store")
+      .help("Number of times to replay the FIFO log before measuring it, which moves shader "
+            "compilation and other first-time work out of the report. [default: %default]")
+      .set_default(0);
+
+  const optparse::Values& options = parser->parse_args(args);
+
+  // Initialize the dolphin user directory, required for temporary processing files
+  // If this is not set, destructive file operations could occur due to path confusion
+  std::string user_directory;
+  if (options.is_set("user"))
+    user_directory = static_cast<const char*>(options.get("user"));
+
+  UICommon::SetUserDirectory(user_directory);
+  UICommon::Init();
+
+  // Validate options
+  const std::string input_file_path = static_cast<const char*>(options.get("input"));
+  if (input_file_path.empty())
+  {
+    std::cerr << "Error: No input set" << std::endl;
+    return 1;
+  }
+
+  const int loops = static_cast<int>(options.get("loops"));
+  const int warmup = static_cast<int>(options.get("warmup"));
+  if (loops < 1 || warmup < 0)
+  {
+    std::cerr << "Error: Invalid number of loops" << std::endl;
+    return 1;
+  }
+
+  const std::string backend = static_cast<const char*>(options.get("video_backend"));
+  const auto& backends = VideoBackendBase::GetAvailableBackends();
+  if (std::none_of(backends.begin(), backends.end(),
+                   [&backend](const auto& b) { return b->GetName() == backend; }))
+  {
+    std::cerr << "Error: Unknown video backend " << backend << std::endl;
+    return 1;
+  }
+
+  // Replay as fast as possible, looping until enough frames have been measured.
+  Config::SetCurrent(Config::MAIN_GFX_BACKEND, backend);
+  Config::SetCurrent(Config::GFX_VSYNC, false);
+  Config::SetCurrent(Config::MAIN_EMULATION_SPEED, 0.0f);
+  Config::SetCurrent(Config::MAIN_FIFOPLAYER_LOOP_REPLAY, true);
+
+  std::vector<FrameSample> samples;
+  Common::Flag done;
+  std::optional<Snapshot> previous;
+  u32 frames_replayed = 0;
+
+  // Called on the CPU thread before each frame is written, by which point the previous frame has
+  // been processed completely.
+  FifoPlayer& player = FifoPlayer::GetInstance();
+  player.SetFrameWrittenCallback([&] {
+    if (done.IsSet())
+      return;
+
+    const Snapshot current = TakeSnapshot(player.GetCurrentFrameNum());
+    const u32 frame_count = player.GetFrameRangeEnd() - player.GetFrameRangeStart() + 1;
+
+    if (previous && frames_replayed++ >= static_cast<u32>(warmup) * frame_count)
+    {
+      samples.push_back(
+          {previous->frame,
+           std::chrono::duration<double, std::milli>(current.time - previous->time).count(),
+           NanosecondsToMilliseconds(current.command_processing_ns -
+                                     previous->command_processing_ns),
+           NanosecondsToMilliseconds(current.vertex_loading_ns - previous->vertex_loading_ns),
+           current.shaders_created - previous->shaders_created,
+           current.vertex_loaders_created - previous->vertex_loaders_created});
+    }
+
+    if (frames_replayed == static_cast<u32>(warmup + loops) * frame_count)
+      done.Set();
+
+    previous = current;
+  });
+
+  g_stats.measure_timings.store(true, std::memory_order_relaxed);
+
+  WindowSystemInfo wsi;
+  wsi.type = WindowSystemType::Headless;
+  auto boot = BootParameters::GenerateFromFile(
+      input_file_path, BootSessionData(std::nullopt, DeleteSavestateAfterBoot::No));
+  if (!BootManager::BootCore(std::move(boot), wsi))
+  {
+    std::cerr << "Error: Unable to replay FIFO log" << std::endl;
+    return 1;
+  }
+
+  while (!done.IsSet() && Core::GetState() != Core::State::Uninitialized)
+  {
+    Core::HostDispatchJobs();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  Core::Stop();
+  Core::Shutdown();
+  player.SetFrameWrittenCallback(nullptr);
+  g_stats.measure_timings.store(false, std::memory_order_relaxed);
+
+  if (!done.IsSet() || samples.empty())
+  {
+    std::cerr << "Error: The FIFO log stopped before it could be measured" << std::endl;
+    return 1;
+  }
+
+  const Summary frame_time = Summarize(samples, &FrameSample::frame_time_ms);
+  std::cout << fmt::format("{} frames, frame time mean {:.3f} ms, p50 {:.3f} ms, p90 {:.3f} ms, "
+                           "p99 {:.3f} ms, max {:.3f} ms",
+                           samples.size(), frame_time.mean, frame_time.p50, frame_time.p90,
+                           frame_time.p99, frame_time.max)
+            << std::endl;
+
+  if (options.is_set("output"))
+  {
+    const std::string output_file_path = static_cast<const char*>(options.get("output"));
+    const std::string format = static_cast<const char*>(options.get("format"));
+    const std::string report = format == "csv" ? WriteCSV(samples) :
+                                                 WriteJSON(input_file_path, backend, samples);
+    if (!File::WriteStringToFile(output_file_path, report))
+    {
+      std::cerr << "Error: Unable to write report to " << output_file_path << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+std::string BenchCommand::WriteJSON(const std::string& input_file_path,
+                                    const std::string& backend,
+                                    const std::vector<FrameSample>& samples)
+{
+  picojson::object summary;
+  summary.emplace("frame_time_ms",
+                  SummaryToJSON(Summarize(samples, &FrameSample::frame_time_ms)));
+  summary.emplace("command_processing_ms",
+                  SummaryToJSON(Summarize(samples, &FrameSample::command_processing_ms)));
+  summary.emplace("vertex_loading_ms",
+                  SummaryToJSON(Summarize(samples, &FrameSample::vertex_loading_ms)));
+
+  int shaders_compiled = 0;
+  int vertex_loaders_created = 0;
+  picojson::array frames;
+  for (const FrameSample& sample : samples)
+  {
+    shaders_compiled += sample.shaders_compiled;
+    vertex_loaders_created += sample.vertex_loaders_created;
+
+    picojson::object frame;
+    frame.emplace("frame", static_cast<double>(sample.frame));
+    frame.emplace("frame_time_ms", sample.frame_time_ms);
+    frame.emplace("command_processing_ms", sample.command_processing_ms);
+    frame.emplace("vertex_loading_ms", sample.vertex_loading_ms);
+    frame.emplace("shaders_compiled", static_cast<double>(sample.shaders_compiled));
+    frame.emplace("vertex_loaders_created", static_cast<double>(sample.vertex_loaders_created));
+    frames.emplace_back(std::move(frame));
+  }
+  summary.emplace("shaders_compiled", static_cast<double>(shaders_compiled));
+  summary.emplace("vertex_loaders_created", static_cast<double>(vertex_loaders_created));
+
+  picojson::object json_root;
+  json_root.emplace("input", input_file_path);
+  json_root.emplace("video_backend", backend);
+  json_root.emplace("summary", std::move(summary));
+  json_root.emplace("frames", std::move(frames));
+  return picojson::value(json_root).serialize(true);
+}
+
+std::string BenchCommand::WriteCSV(const std::vector<FrameSample>& samples)
+{
+  std::string csv = "frame,frame_time_ms,command_processing_ms,vertex_loading_ms,"
+                    "shaders_compiled,vertex_loaders_created\n";
+  for (const FrameSample& sample : samples)
+  {
+    csv += fmt::format("{},{:.6f},{:.6f},{:.6f},{},{}\n", sample.frame, sample.frame_time_ms,
+                       sample.command_processing_ms, sample.vertex_loading_ms,
+                       sample.shaders_compiled, sample.vertex_loaders_created);
+  }
+
+  // The percentiles go below the frames, with their name in place of the frame number.
+  const Summary frame_time = Summarize(samples, &FrameSample::frame_time_ms);
+  const Summary command_processing = Summarize(samples, &FrameSample::command_processing_ms);
+  const Summary vertex_loading = Summarize(samples, &FrameSample::vertex_loading_ms);
+  const auto add_row = [&](const char* name, double Summary::*member) {
+    csv += fmt::format("{},{:.6f},{:.6f},{:.6f},,\n", name, frame_time.*member,
+                       command_processing.*member, vertex_loading.*member);
+  };
+  add_row("mean", &Summary::mean);
+  add_row("p50", &Summary::p50);
+  add_row("p90", &Summary::p90);
+  add_row("p99", &Summary::p99);
+  add_row("max", &Summary::max);
+  return csv;
+}
+
+}  // namespace DolphinTool
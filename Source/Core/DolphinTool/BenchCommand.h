@@ -0,0 +1,36 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "DolphinTool/Command.h"
+
+namespace DolphinTool
+{
+// Replays a FIFO log as fast as possible without a window and reports how long each frame took.
+class BenchCommand final : public Command
+{
+public:
+  int Main(const std::vector<std::string>& args) override;
+
+private:
+  struct FrameSample
+  {
+    u32 frame;
+    double frame_time_ms;
+    double command_processing_ms;
+    double vertex_loading_ms;
+    int shaders_compiled;
+    int vertex_loaders_created;
+  };
+
+  static std::string WriteJSON(const std::string& input_file_path, const std::string& backend,
+                               const std::vector<FrameSample>& samples);
+  static std::string WriteCSV(const std::vector<FrameSample>& samples);
+};
+
+}  // namespace DolphinTool
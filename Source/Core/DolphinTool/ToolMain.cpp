@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "Common/Version.h"
+#include "DolphinTool/BenchCommand.h"
 #include "DolphinTool/Command.h"
 #include "DolphinTool/ConvertCommand.h"
 #include "DolphinTool/HeaderCommand.h"
@@ -16,7 +17,7 @@
 static int PrintUsage(int code)
 {
   std::cerr << "usage: dolphin-tool COMMAND -h" << std::endl << std::endl;
-  std::cerr << "commands supported: [convert, verify, header]" << std::endl;
+  std::cerr << "commands supported: [convert, verify, header, bench]" << std::endl;
 
   return code;
 }
@@ -45,6 +46,8 @@ int main(int argc, char* argv[])
     command = std::make_unique<DolphinTool::VerifyCommand>();
   else if (command_str == "header")
     command = std::make_unique<DolphinTool::HeaderCommand>();
+  else if (command_str == "bench")
+    command = std::make_unique<DolphinTool::BenchCommand>();
   else
     return PrintUsage(1);
 
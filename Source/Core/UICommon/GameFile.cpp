@@ -115,6 +115,11 @@ GameFile::GameFile(std::string path) : m_file_path(std::move(path))
 {
   m_file_name = PathToFileName(m_file_path);
 
+  // Before reading anything, so that a modification during the scan can't go unnoticed.
+  const File::FileInfo file_info(m_file_path);
+  m_scanned_file_size = file_info.GetSize();
+  m_scanned_file_time = file_info.GetModificationTime();
+
   {
     std::unique_ptr<DiscIO::Volume> volume(DiscIO::CreateVolume(m_file_path));
     if (volume != nullptr)
@@ -348,6 +353,8 @@ void GameFile::DoState(PointerWrap& p)
   p.Do(m_file_name);
 
   p.Do(m_file_size);
+  p.Do(m_scanned_file_size);
+  p.Do(m_scanned_file_time);
   p.Do(m_volume_size);
   p.Do(m_volume_size_is_accurate);
   p.Do(m_is_datel_disc);
@@ -383,6 +390,13 @@ void GameFile::DoState(PointerWrap& p)
   m_custom_cover.DoState(p);
 }
 
+bool GameFile::FileChanged() const
+{
+  const File::FileInfo file_info(m_file_path);
+  return file_info.GetSize() != m_scanned_file_size ||
+         file_info.GetModificationTime() != m_scanned_file_time;
+}
+
 std::string GameFile::GetExtension() const
 {
   std::string extension;
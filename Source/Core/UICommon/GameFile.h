@@ -111,6 +111,8 @@ public:
   const GameBanner& GetBannerImage() const;
   const GameCover& GetCoverImage() const;
   void DoState(PointerWrap& p);
+  // Returns true if the size or modification time of the file differs from when it was scanned.
+  bool FileChanged() const;
   bool XMLMetadataChanged();
   void XMLMetadataCommit();
   bool WiiBannerChanged();
@@ -144,6 +146,8 @@ private:
   std::string m_file_name;
 
   u64 m_file_size{};
+  u64 m_scanned_file_size{};
+  s64 m_scanned_file_time{};
   u64 m_volume_size{};
   bool m_volume_size_is_accurate{};
   bool m_is_datel_disc{};
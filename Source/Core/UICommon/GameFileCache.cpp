@@ -5,6 +5,8 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <functional>
 #include <list>
@@ -20,6 +22,7 @@
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/ThreadPool.h"
 
 #include "DiscIO/DirectoryBlob.h"
 
@@ -27,7 +30,51 @@
 
 namespace UICommon
 {
-static constexpr u32 CACHE_REVISION = 21;  // Last changed in PR 10187
+static constexpr u32 CACHE_REVISION = 22;  // Last changed to store file modification times
+
+// While scanning many new files, the cache is saved this often, so that the work isn't lost if
+// Dolphin gets closed before the scan finishes.
+static constexpr auto SAVE_INTERVAL = std::chrono::seconds(30);
+
+// Runs task for every index on a thread pool. Each worker takes the next index as soon as it is
+// free, while the calling thread passes the indices to handle_result in order as their tasks
+// finish. A slow task therefore only delays the results after it, not the other tasks.
+static void ForEachInOrder(size_t count, const std::function<void(size_t)>& task,
+                           const std::function<void(size_t)>& handle_result,
+                           const std::atomic_bool& processing_halted)
+{
+  std::mutex mutex;
+  std::condition_variable finished;
+  std::vector<u8> done(count);
+
+  Common::ThreadPool thread_pool(0, "GameFileCache");
+  for (size_t i = 0; i < count; ++i)
+  {
+    thread_pool.Submit([&, i] {
+      if (!processing_halted)
+        task(i);
+
+      {
+        std::lock_guard lk(mutex);
+        done[i] = true;
+      }
+      finished.notify_one();
+    });
+  }
+
+  for (size_t i = 0; i < count && !processing_halted; ++i)
+  {
+    {
+      std::unique_lock lk(mutex);
+      finished.wait(lk, [&] { return done[i] != 0; });
+    }
+    handle_result(i);
+  }
+
+  // The tasks refer to the locals above.
+  thread_pool.Cancel();
+  thread_pool.WaitForCompletion();
+}
 
 std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
                                           bool recursive_scan)
@@ -103,51 +150,67 @@ bool GameFileCache::Update(
 
   bool cache_changed = false;
 
-  // Delete paths that aren't in game_paths from m_cached_files,
-  // while simultaneously deleting paths that are in m_cached_files from game_paths.
-  // For the sake of speed, we don't care about maintaining the order of m_cached_files.
+  // Delete paths that aren't in game_paths and files that have changed since they were scanned
+  // from m_cached_files, while simultaneously deleting the paths that remain in m_cached_files
+  // from game_paths. The order of the remaining files is kept.
   {
+    auto out = m_cached_files.begin();
     auto it = m_cached_files.begin();
-    auto end = m_cached_files.end();
-    while (it != end)
+    for (; it != m_cached_files.end(); ++it)
     {
       if (processing_halted)
         break;
 
-      if (game_paths.erase((*it)->GetFilePath()))
+      const std::string& path = (*it)->GetFilePath();
+      if (game_paths.count(path) != 0 && !(*it)->FileChanged())
       {
-        ++it;
+        game_paths.erase(path);
+        *out++ = std::move(*it);
       }
       else
       {
         if (game_removed_from_cache)
-          game_removed_from_cache((*it)->GetFilePath());
+          game_removed_from_cache(path);
 
         cache_changed = true;
-        --end;
-        *it = std::move(*end);
       }
     }
-    m_cached_files.erase(it, m_cached_files.end());
+    out = std::move(it, m_cached_files.end(), out);
+    m_cached_files.erase(out, m_cached_files.end());
   }
 
   // Now that the previous loop has run, game_paths only contains paths that
   // aren't in m_cached_files, so we simply add all of them to m_cached_files.
-  for (const std::string& path : game_paths)
-  {
-    if (processing_halted)
-      break;
-
-    auto file = std::make_shared<GameFile>(path);
-    if (file->IsValid())
-    {
-      if (game_added_to_cache)
-        game_added_to_cache(file);
-
-      cache_changed = true;
-      m_cached_files.push_back(std::move(file));
-    }
-  }
+  // They are sorted so that the cache ends up in the same order regardless of how the
+  // scanning threads happen to be scheduled.
+  std::vector<std::string> new_paths(game_paths.begin(), game_paths.end());
+  std::sort(new_paths.begin(), new_paths.end());
+  if (new_paths.empty() || processing_halted)
+    return cache_changed;
+
+  std::vector<std::shared_ptr<GameFile>> files(new_paths.size());
+  auto last_save = std::chrono::steady_clock::now();
+
+  ForEachInOrder(
+      new_paths.size(), [&](size_t i) { files[i] = std::make_shared<GameFile>(new_paths[i]); },
+      [&](size_t i) {
+        std::shared_ptr<GameFile> file = std::move(files[i]);
+        if (file && file->IsValid())
+        {
+          if (game_added_to_cache)
+            game_added_to_cache(file);
+
+          cache_changed = true;
+          m_cached_files.push_back(std::move(file));
+        }
+
+        if (cache_changed && std::chrono::steady_clock::now() - last_save >= SAVE_INTERVAL)
+        {
+          Save();
+          last_save = std::chrono::steady_clock::now();
+        }
+      },
+      processing_halted);
 
   return cache_changed;
 }
@@ -157,17 +220,25 @@ bool GameFileCache::UpdateAdditionalMetadata(
     const std::atomic_bool& processing_halted)
 {
   bool cache_changed = false;
+  if (m_cached_files.empty())
+    return cache_changed;
+
+  // The files are independent of each other, and UpdateAdditionalMetadata only replaces the
+  // element it is given, so they can be updated in parallel. The callback is still called in
+  // order from this thread.
+  std::vector<u8> updated(m_cached_files.size());
+  ForEachInOrder(
+      m_cached_files.size(),
+      [&](size_t i) { updated[i] = UpdateAdditionalMetadata(&m_cached_files[i]); },
+      [&](size_t i) {
+        if (!updated[i])
+          return;
 
-  for (std::shared_ptr<GameFile>& file : m_cached_files)
-  {
-    if (processing_halted)
-      break;
-
-    const bool updated = UpdateAdditionalMetadata(&file);
-    cache_changed |= updated;
-    if (game_updated && updated)
-      game_updated(file);
-  }
+        cache_changed = true;
+        if (game_updated)
+          game_updated(m_cached_files[i]);
+      },
+      processing_halted);
 
   return cache_changed;
 }
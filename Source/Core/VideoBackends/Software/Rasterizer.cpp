@@ -4,14 +4,18 @@
 #include "VideoBackends/Software/Rasterizer.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
+#include <memory>
 #include <vector>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/ThreadPool.h"
 
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/NativeVertexFormat.h"
+#include "VideoBackends/Software/SWBoundingBox.h"
 #include "VideoBackends/Software/Tev.h"
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/BPMemory.h"
@@ -97,22 +101,74 @@ struct Slope
 };
 
 static Slope ZSlope;
-static Slope WSlope;
-static Slope ColorSlopes[2][4];
-static Slope TexSlopes[8][3];
 
-static Tev tev;
-static RasterBlock rasterBlock;
+// Triangles aren't drawn right away. Instead, they are set up in the order they are submitted and
+// binned into tiles of the EFB, and Flush draws each tile's triangles in that order. No pixel is
+// part of more than one tile, so the tiles can be drawn on several threads at once and still give
+// exactly the same result as drawing one triangle after another. Everything else the pixel
+// pipeline reads (BP memory, pixel shader constants and textures) can only change between
+// batches, which end with a flush.
+static constexpr s32 TILE_SIZE = 64;
+static_assert(TILE_SIZE % BLOCK_SIZE == 0, "Blocks must not cross tiles");
+static constexpr s32 TILES_X = (EFB_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+static constexpr s32 TILES_Y = (EFB_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+
+// Bounds the memory used by a batch with lots of triangles.
+static constexpr size_t MAX_QUEUED_TRIANGLES = 4096;
+
+struct TriangleSetup
+{
+  Slope z;
+  Slope w;
+  Slope color[2][4];
+  Slope tex[8][3];
+
+  // Half-edge constants and deltas in 28.4 fixed point
+  s32 C1, C2, C3;
+  s32 DX12, DX23, DX31;
+  s32 DY12, DY23, DY31;
+
+  // Bounding rectangle, clipped to the scissor rectangle
+  s32 minx, maxx, miny, maxy;
+};
+
+struct Tile
+{
+  Tev tev;
+  RasterBlock raster_block;
+  u32 rasterized_pixels = 0;
+  std::vector<u32> triangles;
+};
+
+static std::vector<TriangleSetup> s_triangles;
+static std::array<Tile, TILES_X * TILES_Y> s_tiles;
+static std::vector<size_t> s_tiles_to_draw;
+static std::unique_ptr<Common::ThreadPool> s_thread_pool;
 
 static std::vector<BPFunctions::ScissorRect> scissors;
 
 void Init()
 {
-  tev.Init();
+  for (Tile& tile : s_tiles)
+    tile.tev.Init();
 
   // The other slopes are set each for each primitive drawn, but zfreeze means that the z slope
   // needs to be set to an (untested) default value.
   ZSlope = Slope();
+
+  if (g_ActiveConfig.iSWRasterizerThreads != 1)
+  {
+    s_thread_pool = std::make_unique<Common::ThreadPool>(
+        std::max(g_ActiveConfig.iSWRasterizerThreads, 0), "Software Rasterizer");
+  }
+}
+
+void Shutdown()
+{
+  s_thread_pool.reset();
+  s_triangles.clear();
+  for (Tile& tile : s_tiles)
+    tile.triangles.clear();
 }
 
 void ScissorChanged()
@@ -144,29 +200,32 @@ static inline int iround(float x)
 
 void SetTevReg(int reg, int comp, s16 color)
 {
-  tev.SetRegColor(reg, comp, color);
+  for (Tile& tile : s_tiles)
+    tile.tev.SetRegColor(reg, comp, color);
 }
 
-static void Draw(s32 x, s32 y, s32 xi, s32 yi)
+static void Draw(Tile& tile, const TriangleSetup& triangle, s32 x, s32 y, s32 xi, s32 yi)
 {
-  INCSTAT(g_stats.this_frame.rasterized_pixels);
+  ++tile.rasterized_pixels;
 
-  s32 z = (s32)std::clamp<float>(ZSlope.GetValue(x, y), 0.0f, 16777215.0f);
+  Tev& tev = tile.tev;
+  s32 z = (s32)std::clamp<float>(triangle.z.GetValue(x, y), 0.0f, 16777215.0f);
 
   if (bpmem.UseEarlyDepthTest())
   {
     // TODO: Test if perf regs are incremented even if test is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT_ZCOMPLOC);
+    ++tev.PerfCounterPixels[PQ_ZCOMP_INPUT_ZCOMPLOC];
     if (bpmem.zmode.testenable)
     {
       // early z
       if (!EfbInterface::ZCompare(x, y, z))
         return;
     }
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
+    ++tev.PerfCounterPixels[PQ_ZCOMP_OUTPUT_ZCOMPLOC];
   }
 
-  RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
+  const RasterBlock& rasterBlock = tile.raster_block;
+  const RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
   tev.Position[0] = x;
   tev.Position[1] = y;
@@ -177,7 +236,7 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
   {
     for (int comp = 0; comp < 4; comp++)
     {
-      u16 color = (u16)ColorSlopes[i][comp].GetValue(x, y);
+      u16 color = (u16)triangle.color[i][comp].GetValue(x, y);
 
       // clamp color value to 0
       u16 mask = ~(color >> 8);
@@ -209,7 +268,8 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
   tev.Draw();
 }
 
-static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoord)
+static inline void CalculateLOD(const RasterBlock& rasterBlock, s32* lodp, bool* linear,
+                                u32 texmap, u32 texcoord)
 {
   auto texUnit = bpmem.tex.GetUnit(texmap);
 
@@ -220,9 +280,9 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
 
   float sDelta, tDelta;
 
-  float* uv00 = rasterBlock.Pixel[0][0].Uv[texcoord];
-  float* uv10 = rasterBlock.Pixel[1][0].Uv[texcoord];
-  float* uv01 = rasterBlock.Pixel[0][1].Uv[texcoord];
+  const float* uv00 = rasterBlock.Pixel[0][0].Uv[texcoord];
+  const float* uv10 = rasterBlock.Pixel[1][0].Uv[texcoord];
+  const float* uv01 = rasterBlock.Pixel[0][1].Uv[texcoord];
 
   float dudx = fabsf(uv00[0] - uv10[0]);
   float dvdx = fabsf(uv00[1] - uv10[1]);
@@ -260,8 +320,10 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   *lodp = lod;
 }
 
-static void BuildBlock(s32 blockX, s32 blockY)
+static void BuildBlock(Tile& tile, const TriangleSetup& triangle, s32 blockX, s32 blockY)
 {
+  RasterBlock& rasterBlock = tile.raster_block;
+
   for (s32 yi = 0; yi < BLOCK_SIZE; yi++)
   {
     for (s32 xi = 0; xi < BLOCK_SIZE; xi++)
@@ -271,19 +333,19 @@ static void BuildBlock(s32 blockX, s32 blockY)
       s32 x = xi + blockX;
       s32 y = yi + blockY;
 
-      float invW = 1.0f / WSlope.GetValue(x, y);
+      float invW = 1.0f / triangle.w.GetValue(x, y);
       pixel.InvW = invW;
 
       // tex coords
       for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
       {
         float projection = invW;
-        float q = TexSlopes[i][2].GetValue(x, y) * invW;
+        float q = triangle.tex[i][2].GetValue(x, y) * invW;
         if (q != 0.0f)
           projection = invW / q;
 
-        pixel.Uv[i][0] = TexSlopes[i][0].GetValue(x, y) * projection;
-        pixel.Uv[i][1] = TexSlopes[i][1].GetValue(x, y) * projection;
+        pixel.Uv[i][0] = triangle.tex[i][0].GetValue(x, y) * projection;
+        pixel.Uv[i][1] = triangle.tex[i][1].GetValue(x, y) * projection;
       }
     }
   }
@@ -296,7 +358,8 @@ static void BuildBlock(s32 blockX, s32 blockY)
     u32 texcoord = indref & 3;
     indref >>= 3;
 
-    CalculateLOD(&rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
+    CalculateLOD(rasterBlock, &rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap,
+                 texcoord);
   }
 
   for (unsigned int i = 0; i <= bpmem.genMode.numtevstages; i++)
@@ -308,7 +371,8 @@ static void BuildBlock(s32 blockX, s32 blockY)
       u32 texmap = order.getTexMap(stageOdd);
       u32 texcoord = order.getTexCoord(stageOdd);
 
-      CalculateLOD(&rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
+      CalculateLOD(rasterBlock, &rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap,
+                   texcoord);
     }
   }
 }
@@ -325,34 +389,22 @@ void UpdateZSlope(const OutputVertexData* v0, const OutputVertexData* v1,
   }
 }
 
-static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
-                                  const OutputVertexData* v2,
-                                  const BPFunctions::ScissorRect& scissor)
+// Draws the part of a triangle within the given rectangle, which must be aligned to blocks
+// wherever it is narrower than the triangle's bounding rectangle.
+static void RasterizeTriangle(Tile& tile, const TriangleSetup& triangle, s32 minx, s32 maxx,
+                              s32 miny, s32 maxy)
 {
-  // The zslope should be updated now, even if the triangle is rejected by the scissor test, as
-  // zfreeze depends on it
-  UpdateZSlope(v0, v1, v2, scissor.x_off, scissor.y_off);
+  const s32 C1 = triangle.C1;
+  const s32 C2 = triangle.C2;
+  const s32 C3 = triangle.C3;
 
-  // adapted from http://devmaster.net/posts/6145/advanced-rasterization
+  const s32 DX12 = triangle.DX12;
+  const s32 DX23 = triangle.DX23;
+  const s32 DX31 = triangle.DX31;
 
-  // 28.4 fixed-pou32 coordinates. rounded to nearest and adjusted to match hardware output
-  // could also take floor and adjust -8
-  const s32 Y1 = iround(16.0f * (v0->screenPosition.y - scissor.y_off)) - 9;
-  const s32 Y2 = iround(16.0f * (v1->screenPosition.y - scissor.y_off)) - 9;
-  const s32 Y3 = iround(16.0f * (v2->screenPosition.y - scissor.y_off)) - 9;
-
-  const s32 X1 = iround(16.0f * (v0->screenPosition.x - scissor.x_off)) - 9;
-  const s32 X2 = iround(16.0f * (v1->screenPosition.x - scissor.x_off)) - 9;
-  const s32 X3 = iround(16.0f * (v2->screenPosition.x - scissor.x_off)) - 9;
-
-  // Deltas
-  const s32 DX12 = X1 - X2;
-  const s32 DX23 = X2 - X3;
-  const s32 DX31 = X3 - X1;
-
-  const s32 DY12 = Y1 - Y2;
-  const s32 DY23 = Y2 - Y3;
-  const s32 DY31 = Y3 - Y1;
+  const s32 DY12 = triangle.DY12;
+  const s32 DY23 = triangle.DY23;
+  const s32 DY31 = triangle.DY31;
 
   // Fixed-pos32 deltas
   const s32 FDX12 = DX12 * 16;
@@ -363,62 +415,6 @@ static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertex
   const s32 FDY23 = DY23 * 16;
   const s32 FDY31 = DY31 * 16;
 
-  // Bounding rectangle
-  s32 minx = (std::min(std::min(X1, X2), X3) + 0xF) >> 4;
-  s32 maxx = (std::max(std::max(X1, X2), X3) + 0xF) >> 4;
-  s32 miny = (std::min(std::min(Y1, Y2), Y3) + 0xF) >> 4;
-  s32 maxy = (std::max(std::max(Y1, Y2), Y3) + 0xF) >> 4;
-
-  // scissor
-  ASSERT(scissor.rect.left >= 0);
-  ASSERT(scissor.rect.right <= static_cast<int>(EFB_WIDTH));
-  ASSERT(scissor.rect.top >= 0);
-  ASSERT(scissor.rect.bottom <= static_cast<int>(EFB_HEIGHT));
-
-  minx = std::max(minx, scissor.rect.left);
-  maxx = std::min(maxx, scissor.rect.right);
-  miny = std::max(miny, scissor.rect.top);
-  maxy = std::min(maxy, scissor.rect.bottom);
-
-  if (minx >= maxx || miny >= maxy)
-    return;
-
-  // Set up the remaining slopes
-  const SlopeContext ctx(v0, v1, v2, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4, scissor.x_off,
-                         scissor.y_off);
-
-  float w[3] = {1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w,
-                1.0f / v2->projectedPosition.w};
-  WSlope = Slope(w[0], w[1], w[2], ctx);
-
-  for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
-  {
-    for (int comp = 0; comp < 4; comp++)
-      ColorSlopes[i][comp] = Slope(v0->color[i][comp], v1->color[i][comp], v2->color[i][comp], ctx);
-  }
-
-  for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
-  {
-    for (int comp = 0; comp < 3; comp++)
-    {
-      TexSlopes[i][comp] = Slope(v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1],
-                                 v2->texCoords[i][comp] * w[2], ctx);
-    }
-  }
-
-  // Half-edge constants
-  s32 C1 = DY12 * X1 - DX12 * Y1;
-  s32 C2 = DY23 * X2 - DX23 * Y2;
-  s32 C3 = DY31 * X3 - DX31 * Y3;
-
-  // Correct for fill convention
-  if (DY12 < 0 || (DY12 == 0 && DX12 > 0))
-    C1++;
-  if (DY23 < 0 || (DY23 == 0 && DX23 > 0))
-    C2++;
-  if (DY31 < 0 || (DY31 == 0 && DX31 > 0))
-    C3++;
-
   // Start in corner of 2x2 block
   s32 block_minx = minx & ~(BLOCK_SIZE - 1);
   s32 block_miny = miny & ~(BLOCK_SIZE - 1);
@@ -460,7 +456,7 @@ static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertex
       if (a == 0x0 || b == 0x0 || c == 0x0)
         continue;
 
-      BuildBlock(x, y);
+      BuildBlock(tile, triangle, x, y);
 
       // Accept whole block when totally covered
       // We still need to check min/max x/y because of the scissor
@@ -470,7 +466,7 @@ static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertex
         {
           for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
           {
-            Draw(x + ix, y + iy, ix, iy);
+            Draw(tile, triangle, x + ix, y + iy, ix, iy);
           }
         }
       }
@@ -493,7 +489,7 @@ static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertex
               // This check enforces the scissor rectangle, since it might not be aligned with the
               // blocks
               if (x + ix >= minx && x + ix < maxx && y + iy >= miny && y + iy < maxy)
-                Draw(x + ix, y + iy, ix, iy);
+                Draw(tile, triangle, x + ix, y + iy, ix, iy);
             }
 
             CX1 -= FDY12;
@@ -510,6 +506,194 @@ static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertex
   }
 }
 
+static void DrawTile(size_t index)
+{
+  Tile& tile = s_tiles[index];
+  const s32 tile_x = static_cast<s32>(index % TILES_X) * TILE_SIZE;
+  const s32 tile_y = static_cast<s32>(index / TILES_X) * TILE_SIZE;
+
+  for (u32 triangle_index : tile.triangles)
+  {
+    const TriangleSetup& triangle = s_triangles[triangle_index];
+    RasterizeTriangle(tile, triangle, std::max(triangle.minx, tile_x),
+                      std::min(triangle.maxx, tile_x + TILE_SIZE), std::max(triangle.miny, tile_y),
+                      std::min(triangle.maxy, tile_y + TILE_SIZE));
+  }
+}
+
+void Flush()
+{
+  if (s_triangles.empty())
+    return;
+
+  s_tiles_to_draw.clear();
+  for (size_t i = 0; i < s_tiles.size(); ++i)
+  {
+    if (!s_tiles[i].triangles.empty())
+      s_tiles_to_draw.push_back(i);
+  }
+
+  // TEV dumps write to shared buffers as they go.
+  const bool parallel = s_thread_pool && s_tiles_to_draw.size() > 1 &&
+                        !g_ActiveConfig.bDumpTevStages && !g_ActiveConfig.bDumpTevTextureFetches;
+  if (parallel)
+  {
+    s_thread_pool->ParallelFor(s_tiles_to_draw.size(),
+                               [](size_t i) { DrawTile(s_tiles_to_draw[i]); });
+  }
+  else
+  {
+    for (size_t index : s_tiles_to_draw)
+      DrawTile(index);
+  }
+
+  for (size_t index : s_tiles_to_draw)
+  {
+    Tile& tile = s_tiles[index];
+    Tev& tev = tile.tev;
+
+    ADDSTAT(g_stats.this_frame.rasterized_pixels, static_cast<int>(tile.rasterized_pixels));
+    ADDSTAT(g_stats.this_frame.tev_pixels_in, static_cast<int>(tev.PixelsIn));
+    ADDSTAT(g_stats.this_frame.tev_pixels_out, static_cast<int>(tev.PixelsOut));
+
+    for (size_t type = 0; type < tev.PerfCounterPixels.size(); ++type)
+    {
+      if (tev.PerfCounterPixels[type] != 0)
+      {
+        EfbInterface::IncPerfCounterQuadCount(static_cast<PerfQueryType>(type),
+                                              tev.PerfCounterPixels[type]);
+      }
+    }
+
+    if (tev.BBoxLeft <= tev.BBoxRight)
+      BBoxManager::Update(tev.BBoxLeft, tev.BBoxRight, tev.BBoxTop, tev.BBoxBottom);
+
+    tile.rasterized_pixels = 0;
+    tev.ResetCounters();
+    tile.triangles.clear();
+  }
+
+  s_triangles.clear();
+}
+
+static void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
+                                  const OutputVertexData* v2,
+                                  const BPFunctions::ScissorRect& scissor)
+{
+  // The zslope should be updated now, even if the triangle is rejected by the scissor test, as
+  // zfreeze depends on it
+  UpdateZSlope(v0, v1, v2, scissor.x_off, scissor.y_off);
+
+  // adapted from http://devmaster.net/posts/6145/advanced-rasterization
+
+  // 28.4 fixed-pou32 coordinates. rounded to nearest and adjusted to match hardware output
+  // could also take floor and adjust -8
+  const s32 Y1 = iround(16.0f * (v0->screenPosition.y - scissor.y_off)) - 9;
+  const s32 Y2 = iround(16.0f * (v1->screenPosition.y - scissor.y_off)) - 9;
+  const s32 Y3 = iround(16.0f * (v2->screenPosition.y - scissor.y_off)) - 9;
+
+  const s32 X1 = iround(16.0f * (v0->screenPosition.x - scissor.x_off)) - 9;
+  const s32 X2 = iround(16.0f * (v1->screenPosition.x - scissor.x_off)) - 9;
+  const s32 X3 = iround(16.0f * (v2->screenPosition.x - scissor.x_off)) - 9;
+
+  // Deltas
+  const s32 DX12 = X1 - X2;
+  const s32 DX23 = X2 - X3;
+  const s32 DX31 = X3 - X1;
+
+  const s32 DY12 = Y1 - Y2;
+  const s32 DY23 = Y2 - Y3;
+  const s32 DY31 = Y3 - Y1;
+
+  // Bounding rectangle
+  s32 minx = (std::min(std::min(X1, X2), X3) + 0xF) >> 4;
+  s32 maxx = (std::max(std::max(X1, X2), X3) + 0xF) >> 4;
+  s32 miny = (std::min(std::min(Y1, Y2), Y3) + 0xF) >> 4;
+  s32 maxy = (std::max(std::max(Y1, Y2), Y3) + 0xF) >> 4;
+
+  // scissor
+  ASSERT(scissor.rect.left >= 0);
+  ASSERT(scissor.rect.right <= static_cast<int>(EFB_WIDTH));
+  ASSERT(scissor.rect.top >= 0);
+  ASSERT(scissor.rect.bottom <= static_cast<int>(EFB_HEIGHT));
+
+  minx = std::max(minx, scissor.rect.left);
+  maxx = std::min(maxx, scissor.rect.right);
+  miny = std::max(miny, scissor.rect.top);
+  maxy = std::min(maxy, scissor.rect.bottom);
+
+  if (minx >= maxx || miny >= maxy)
+    return;
+
+  if (s_triangles.size() == MAX_QUEUED_TRIANGLES)
+    Flush();
+
+  const u32 triangle_index = static_cast<u32>(s_triangles.size());
+  TriangleSetup& triangle = s_triangles.emplace_back();
+
+  // zfreeze draws with the z slope of an earlier triangle, so it's captured along with the others
+  triangle.z = ZSlope;
+
+  // Set up the remaining slopes
+  const SlopeContext ctx(v0, v1, v2, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4, scissor.x_off,
+                         scissor.y_off);
+
+  float w[3] = {1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w,
+                1.0f / v2->projectedPosition.w};
+  triangle.w = Slope(w[0], w[1], w[2], ctx);
+
+  for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
+  {
+    for (int comp = 0; comp < 4; comp++)
+    {
+      triangle.color[i][comp] =
+          Slope(v0->color[i][comp], v1->color[i][comp], v2->color[i][comp], ctx);
+    }
+  }
+
+  for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
+  {
+    for (int comp = 0; comp < 3; comp++)
+    {
+      triangle.tex[i][comp] = Slope(v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1],
+                                    v2->texCoords[i][comp] * w[2], ctx);
+    }
+  }
+
+  // Half-edge constants
+  s32 C1 = DY12 * X1 - DX12 * Y1;
+  s32 C2 = DY23 * X2 - DX23 * Y2;
+  s32 C3 = DY31 * X3 - DX31 * Y3;
+
+  // Correct for fill convention
+  if (DY12 < 0 || (DY12 == 0 && DX12 > 0))
+    C1++;
+  if (DY23 < 0 || (DY23 == 0 && DX23 > 0))
+    C2++;
+  if (DY31 < 0 || (DY31 == 0 && DX31 > 0))
+    C3++;
+
+  triangle.C1 = C1;
+  triangle.C2 = C2;
+  triangle.C3 = C3;
+  triangle.DX12 = DX12;
+  triangle.DX23 = DX23;
+  triangle.DX31 = DX31;
+  triangle.DY12 = DY12;
+  triangle.DY23 = DY23;
+  triangle.DY31 = DY31;
+  triangle.minx = minx;
+  triangle.maxx = maxx;
+  triangle.miny = miny;
+  triangle.maxy = maxy;
+
+  for (s32 tile_y = miny / TILE_SIZE; tile_y <= (maxy - 1) / TILE_SIZE; ++tile_y)
+  {
+    for (s32 tile_x = minx / TILE_SIZE; tile_x <= (maxx - 1) / TILE_SIZE; ++tile_x)
+      s_tiles[tile_y * TILES_X + tile_x].triangles.push_back(triangle_index);
+  }
+}
+
 void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
                            const OutputVertexData* v2)
 {
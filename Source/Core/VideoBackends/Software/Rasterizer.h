@@ -10,6 +10,7 @@ struct OutputVertexData;
 namespace Rasterizer
 {
 void Init();
+void Shutdown();
 void ScissorChanged();
 
 void UpdateZSlope(const OutputVertexData* v0, const OutputVertexData* v1,
@@ -17,6 +18,10 @@ void UpdateZSlope(const OutputVertexData* v0, const OutputVertexData* v1,
 void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
                            const OutputVertexData* v2);
 
+// Draws the triangles submitted since the last flush. Must be called before any state the pixel
+// pipeline depends on changes, and before the EFB is accessed.
+void Flush();
+
 void SetTevReg(int reg, int comp, s16 color);
 
 struct RasterBlockPixel
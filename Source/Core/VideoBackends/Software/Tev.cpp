@@ -11,12 +11,10 @@
 #include "Common/CommonTypes.h"
 #include "VideoBackends/Software/DebugUtil.h"
 #include "VideoBackends/Software/EfbInterface.h"
-#include "VideoBackends/Software/SWBoundingBox.h"
 #include "VideoBackends/Software/TextureSampler.h"
 
 #include "VideoCommon/PerfQueryBase.h"
 #include "VideoCommon/PixelShaderManager.h"
-#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
@@ -146,20 +144,20 @@ void Tev::Init()
     m_KonstLUT[31][comp] = &KonstantColors[3][ALP_C];
   }
 
-  m_BiasLUT[0] = 0;
-  m_BiasLUT[1] = 128;
-  m_BiasLUT[2] = -128;
-  m_BiasLUT[3] = 0;
+  m_CombinerParamsKey.fill(~u64{0});
 
-  m_ScaleLShiftLUT[0] = 0;
-  m_ScaleLShiftLUT[1] = 1;
-  m_ScaleLShiftLUT[2] = 2;
-  m_ScaleLShiftLUT[3] = 0;
+  ResetCounters();
+}
 
-  m_ScaleRShiftLUT[0] = 0;
-  m_ScaleRShiftLUT[1] = 0;
-  m_ScaleRShiftLUT[2] = 0;
-  m_ScaleRShiftLUT[3] = 1;
+void Tev::ResetCounters()
+{
+  PixelsIn = 0;
+  PixelsOut = 0;
+  PerfCounterPixels = {};
+  BBoxLeft = 0xffff;
+  BBoxRight = 0;
+  BBoxTop = 0xffff;
+  BBoxBottom = 0;
 }
 
 static inline s16 Clamp255(s16 in)
@@ -227,30 +225,21 @@ void Tev::SetRasColor(RasColorChan colorChan, int swaptable)
   }
 }
 
-void Tev::DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4])
+const TevCombiner::Params& Tev::GetCombinerParams(unsigned int stageNum,
+                                                  const TevStageCombiner::ColorCombiner& cc,
+                                                  const TevStageCombiner::AlphaCombiner& ac)
 {
-  for (int i = BLU_C; i <= RED_C; i++)
+  const u64 key = cc.hex | u64{ac.hex} << 32;
+  if (m_CombinerParamsKey[stageNum] != key)
   {
-    const InputRegType& InputReg = inputs[i];
-
-    const u16 c = InputReg.c + (InputReg.c >> 7);
-
-    s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
-    temp <<= m_ScaleLShiftLUT[u32(cc.scale.Value())];
-    temp += (cc.scale == TevScale::Divide2) ? 0 : (cc.op == TevOp::Sub) ? 127 : 128;
-    temp >>= 8;
-    temp = cc.op == TevOp::Sub ? -temp : temp;
-
-    s32 result = ((InputReg.d + m_BiasLUT[u32(cc.bias.Value())])
-                  << m_ScaleLShiftLUT[u32(cc.scale.Value())]) +
-                 temp;
-    result = result >> m_ScaleRShiftLUT[u32(cc.scale.Value())];
-
-    Reg[u32(cc.dest.Value())][i] = result;
+    m_CombinerParams[stageNum] = TevCombiner::MakeParams(cc, ac);
+    m_CombinerParamsKey[stageNum] = key;
   }
+  return m_CombinerParams[stageNum];
 }
 
-void Tev::DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4])
+void Tev::DrawColorCompare(const TevStageCombiner::ColorCombiner& cc,
+                           const TevCombiner::Inputs& inputs)
 {
   for (int i = BLU_C; i <= RED_C; i++)
   {
@@ -258,23 +247,23 @@ void Tev::DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const Inpu
     switch (cc.compare_mode)
     {
     case TevCompareMode::R8:
-      a = inputs[RED_C].a;
-      b = inputs[RED_C].b;
+      a = inputs.a[RED_C];
+      b = inputs.b[RED_C];
       break;
 
     case TevCompareMode::GR16:
-      a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+      a = (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+      b = (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
       break;
 
     case TevCompareMode::BGR24:
-      a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+      a = (inputs.a[BLU_C] << 16) | (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+      b = (inputs.b[BLU_C] << 16) | (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
       break;
 
     case TevCompareMode::RGB8:
-      a = inputs[i].a;
-      b = inputs[i].b;
+      a = inputs.a[i];
+      b = inputs.b[i];
       break;
 
     default:
@@ -283,54 +272,36 @@ void Tev::DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const Inpu
     }
 
     if (cc.comparison == TevComparison::GT)
-      Reg[u32(cc.dest.Value())][i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
+      Reg[u32(cc.dest.Value())][i] = inputs.d[i] + ((a > b) ? inputs.c[i] : 0);
     else
-      Reg[u32(cc.dest.Value())][i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
+      Reg[u32(cc.dest.Value())][i] = inputs.d[i] + ((a == b) ? inputs.c[i] : 0);
   }
 }
 
-void Tev::DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
-{
-  const InputRegType& InputReg = inputs[ALP_C];
-
-  const u16 c = InputReg.c + (InputReg.c >> 7);
-
-  s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
-  temp <<= m_ScaleLShiftLUT[u32(ac.scale.Value())];
-  temp += (ac.scale == TevScale::Divide2) ? 0 : (ac.op == TevOp::Sub) ? 127 : 128;
-  temp = ac.op == TevOp::Sub ? (-temp >> 8) : (temp >> 8);
-
-  s32 result =
-      ((InputReg.d + m_BiasLUT[u32(ac.bias.Value())]) << m_ScaleLShiftLUT[u32(ac.scale.Value())]) +
-      temp;
-  result = result >> m_ScaleRShiftLUT[u32(ac.scale.Value())];
-
-  Reg[u32(ac.dest.Value())][ALP_C] = result;
-}
-
-void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
+void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac,
+                           const TevCombiner::Inputs& inputs)
 {
   u32 a, b;
   switch (ac.compare_mode)
   {
   case TevCompareMode::R8:
-    a = inputs[RED_C].a;
-    b = inputs[RED_C].b;
+    a = inputs.a[RED_C];
+    b = inputs.b[RED_C];
     break;
 
   case TevCompareMode::GR16:
-    a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+    a = (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+    b = (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
     break;
 
   case TevCompareMode::BGR24:
-    a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+    a = (inputs.a[BLU_C] << 16) | (inputs.a[GRN_C] << 8) | inputs.a[RED_C];
+    b = (inputs.b[BLU_C] << 16) | (inputs.b[GRN_C] << 8) | inputs.b[RED_C];
     break;
 
   case TevCompareMode::A8:
-    a = inputs[ALP_C].a;
-    b = inputs[ALP_C].b;
+    a = inputs.a[ALP_C];
+    b = inputs.b[ALP_C];
     break;
 
   default:
@@ -339,9 +310,9 @@ void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const Inpu
   }
 
   if (ac.comparison == TevComparison::GT)
-    Reg[u32(ac.dest.Value())][ALP_C] = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
+    Reg[u32(ac.dest.Value())][ALP_C] = inputs.d[ALP_C] + ((a > b) ? inputs.c[ALP_C] : 0);
   else
-    Reg[u32(ac.dest.Value())][ALP_C] = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
+    Reg[u32(ac.dest.Value())][ALP_C] = inputs.d[ALP_C] + ((a == b) ? inputs.c[ALP_C] : 0);
 }
 
 static bool AlphaCompare(int alpha, int ref, CompareMode comp)
@@ -543,7 +514,7 @@ void Tev::Draw()
   ASSERT(Position[0] >= 0 && Position[0] < s32(EFB_WIDTH));
   ASSERT(Position[1] >= 0 && Position[1] < s32(EFB_HEIGHT));
 
-  INCSTAT(g_stats.this_frame.tev_pixels_in);
+  ++PixelsIn;
 
   // initial color values
   for (int i = 0; i < 4; i++)
@@ -653,46 +624,60 @@ void Tev::Draw()
     SetRasColor(order.getColorChan(stageOdd), ac.rswap * 2);
 
     // combine inputs
-    InputRegType inputs[4];
+    TevCombiner::Inputs inputs;
     for (int i = 0; i < 3; i++)
     {
-      inputs[BLU_C + i].a = *m_ColorInputLUT[u32(cc.a.Value())][i];
-      inputs[BLU_C + i].b = *m_ColorInputLUT[u32(cc.b.Value())][i];
-      inputs[BLU_C + i].c = *m_ColorInputLUT[u32(cc.c.Value())][i];
-      inputs[BLU_C + i].d = *m_ColorInputLUT[u32(cc.d.Value())][i];
+      inputs.Set(BLU_C + i, *m_ColorInputLUT[u32(cc.a.Value())][i],
+                 *m_ColorInputLUT[u32(cc.b.Value())][i], *m_ColorInputLUT[u32(cc.c.Value())][i],
+                 *m_ColorInputLUT[u32(cc.d.Value())][i]);
     }
-    inputs[ALP_C].a = *m_AlphaInputLUT[u32(ac.a.Value())];
-    inputs[ALP_C].b = *m_AlphaInputLUT[u32(ac.b.Value())];
-    inputs[ALP_C].c = *m_AlphaInputLUT[u32(ac.c.Value())];
-    inputs[ALP_C].d = *m_AlphaInputLUT[u32(ac.d.Value())];
-
-    if (cc.bias != TevBias::Compare)
-      DrawColorRegular(cc, inputs);
-    else
-      DrawColorCompare(cc, inputs);
+    inputs.Set(ALP_C, *m_AlphaInputLUT[u32(ac.a.Value())], *m_AlphaInputLUT[u32(ac.b.Value())],
+               *m_AlphaInputLUT[u32(ac.c.Value())], *m_AlphaInputLUT[u32(ac.d.Value())]);
 
-    if (cc.clamp)
+    // Both combiners read all of their inputs before either writes its result, so the color and
+    // alpha components can be computed at once.
+    if (cc.bias != TevBias::Compare || ac.bias != TevBias::Compare)
     {
-      Reg[u32(cc.dest.Value())][RED_C] = Clamp255(Reg[u32(cc.dest.Value())][RED_C]);
-      Reg[u32(cc.dest.Value())][GRN_C] = Clamp255(Reg[u32(cc.dest.Value())][GRN_C]);
-      Reg[u32(cc.dest.Value())][BLU_C] = Clamp255(Reg[u32(cc.dest.Value())][BLU_C]);
+      alignas(16) s32 results[4];
+      TevCombiner::Combine(inputs, GetCombinerParams(stageNum, cc, ac), results);
+
+      if (cc.bias != TevBias::Compare)
+      {
+        Reg[u32(cc.dest.Value())][RED_C] = results[RED_C];
+        Reg[u32(cc.dest.Value())][GRN_C] = results[GRN_C];
+        Reg[u32(cc.dest.Value())][BLU_C] = results[BLU_C];
+      }
+      if (ac.bias != TevBias::Compare)
+        Reg[u32(ac.dest.Value())][ALP_C] = results[ALP_C];
     }
-    else
+
+    if (cc.bias == TevBias::Compare)
     {
-      Reg[u32(cc.dest.Value())][RED_C] = Clamp1024(Reg[u32(cc.dest.Value())][RED_C]);
-      Reg[u32(cc.dest.Value())][GRN_C] = Clamp1024(Reg[u32(cc.dest.Value())][GRN_C]);
-      Reg[u32(cc.dest.Value())][BLU_C] = Clamp1024(Reg[u32(cc.dest.Value())][BLU_C]);
+      DrawColorCompare(cc, inputs);
+
+      if (cc.clamp)
+      {
+        Reg[u32(cc.dest.Value())][RED_C] = Clamp255(Reg[u32(cc.dest.Value())][RED_C]);
+        Reg[u32(cc.dest.Value())][GRN_C] = Clamp255(Reg[u32(cc.dest.Value())][GRN_C]);
+        Reg[u32(cc.dest.Value())][BLU_C] = Clamp255(Reg[u32(cc.dest.Value())][BLU_C]);
+      }
+      else
+      {
+        Reg[u32(cc.dest.Value())][RED_C] = Clamp1024(Reg[u32(cc.dest.Value())][RED_C]);
+        Reg[u32(cc.dest.Value())][GRN_C] = Clamp1024(Reg[u32(cc.dest.Value())][GRN_C]);
+        Reg[u32(cc.dest.Value())][BLU_C] = Clamp1024(Reg[u32(cc.dest.Value())][BLU_C]);
+      }
     }
 
-    if (ac.bias != TevBias::Compare)
-      DrawAlphaRegular(ac, inputs);
-    else
+    if (ac.bias == TevBias::Compare)
+    {
       DrawAlphaCompare(ac, inputs);
 
-    if (ac.clamp)
-      Reg[u32(ac.dest.Value())][ALP_C] = Clamp255(Reg[u32(ac.dest.Value())][ALP_C]);
-    else
-      Reg[u32(ac.dest.Value())][ALP_C] = Clamp1024(Reg[u32(ac.dest.Value())][ALP_C]);
+      if (ac.clamp)
+        Reg[u32(ac.dest.Value())][ALP_C] = Clamp255(Reg[u32(ac.dest.Value())][ALP_C]);
+      else
+        Reg[u32(ac.dest.Value())][ALP_C] = Clamp1024(Reg[u32(ac.dest.Value())][ALP_C]);
+    }
 
 #if ALLOW_TEV_DUMPS
     if (g_ActiveConfig.bDumpTevStages)
@@ -843,18 +828,20 @@ void Tev::Draw()
   if (bpmem.UseLateDepthTest())
   {
     // TODO: Check against hw if these values get incremented even if depth testing is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
+    ++PerfCounterPixels[PQ_ZCOMP_INPUT];
 
     if (!EfbInterface::ZCompare(Position[0], Position[1], Position[2]))
       return;
 
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
+    ++PerfCounterPixels[PQ_ZCOMP_OUTPUT];
   }
 
   // The GC/Wii GPU rasterizes in 2x2 pixel groups, so bounding box values will be rounded to the
   // extents of these groups, rather than the exact pixel.
-  BBoxManager::Update(static_cast<u16>(Position[0] & ~1), static_cast<u16>(Position[0] | 1),
-                      static_cast<u16>(Position[1] & ~1), static_cast<u16>(Position[1] | 1));
+  BBoxLeft = std::min(BBoxLeft, static_cast<u16>(Position[0] & ~1));
+  BBoxRight = std::max(BBoxRight, static_cast<u16>(Position[0] | 1));
+  BBoxTop = std::min(BBoxTop, static_cast<u16>(Position[1] & ~1));
+  BBoxBottom = std::max(BBoxBottom, static_cast<u16>(Position[1] | 1));
 
 #if ALLOW_TEV_DUMPS
   if (g_ActiveConfig.bDumpTevStages)
@@ -876,8 +863,8 @@ void Tev::Draw()
   }
 #endif
 
-  INCSTAT(g_stats.this_frame.tev_pixels_out);
-  EfbInterface::IncPerfCounterQuadCount(PQ_BLEND_INPUT);
+  ++PixelsOut;
+  ++PerfCounterPixels[PQ_BLEND_INPUT];
 
   EfbInterface::BlendTev(Position[0], Position[1], output);
 }
@@ -3,18 +3,15 @@
 
 #pragma once
 
+#include <array>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/TevCombiner.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PerfQueryBase.h"
 
 class Tev
 {
-  struct InputRegType
-  {
-    unsigned a : 8;
-    unsigned b : 8;
-    unsigned c : 8;
-    signed d : 11;
-  };
-
   struct TextureCoordinateType
   {
     signed s : 24;
@@ -37,9 +34,10 @@ class Tev
   s16* m_ColorInputLUT[16][3];
   s16* m_AlphaInputLUT[8];  // values must point to ABGR color
   s16* m_KonstLUT[32][4];
-  s16 m_BiasLUT[4];
-  u8 m_ScaleLShiftLUT[4];
-  u8 m_ScaleRShiftLUT[4];
+
+  // The combiner parameters of each stage, along with the combiner registers they were built from.
+  std::array<TevCombiner::Params, 16> m_CombinerParams;
+  std::array<u64, 16> m_CombinerParamsKey;
 
   // enumeration for color input LUT
   enum
@@ -58,10 +56,13 @@ class Tev
 
   void SetRasColor(RasColorChan colorChan, int swaptable);
 
-  void DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-  void DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-  void DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
-  void DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
+  const TevCombiner::Params& GetCombinerParams(unsigned int stageNum,
+                                               const TevStageCombiner::ColorCombiner& cc,
+                                               const TevStageCombiner::AlphaCombiner& ac);
+  void DrawColorCompare(const TevStageCombiner::ColorCombiner& cc,
+                        const TevCombiner::Inputs& inputs);
+  void DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac,
+                        const TevCombiner::Inputs& inputs);
 
   void Indirect(unsigned int stageNum, s32 s, s32 t);
 
@@ -74,6 +75,16 @@ public:
   s32 TextureLod[16];
   bool TextureLinear[16];
 
+  // What the pixels drawn since the last ResetCounters() add to the statistics, perf queries and
+  // bounding box. These are collected per instance so that several instances can draw at once.
+  u32 PixelsIn;
+  u32 PixelsOut;
+  std::array<u32, PQ_NUM_MEMBERS> PerfCounterPixels;
+  u16 BBoxLeft;
+  u16 BBoxRight;
+  u16 BBoxTop;
+  u16 BBoxBottom;
+
   enum
   {
     ALP_C,
@@ -83,6 +94,7 @@ public:
   };
 
   void Init();
+  void ResetCounters();
 
   void Draw();
 
@@ -0,0 +1,108 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoBackends/Software/TevCombiner.h"
+
+#include <algorithm>
+
+#include "Common/CPUDetect.h"
+#include "Common/Intrinsics.h"
+
+namespace TevCombiner
+{
+constexpr s32 BIAS_LUT[4] = {0, 128, -128, 0};
+constexpr s32 SCALE_LSHIFT_LUT[4] = {0, 1, 2, 0};
+
+static void SetLanes(Params* params, int first, int last, TevBias bias, TevOp op,
+                     TevScale scale, bool clamp, bool negate_before_divide)
+{
+  const bool subtract = op == TevOp::Sub;
+  for (int i = first; i <= last; ++i)
+  {
+    params->scale[i] = 1 << SCALE_LSHIFT_LUT[u32(scale)];
+    params->round[i] = scale == TevScale::Divide2 ? 0 : subtract ? 127 : 128;
+    params->bias[i] = BIAS_LUT[u32(bias)];
+    params->negate_before_divide[i] = subtract && negate_before_divide ? -1 : 0;
+    params->negate_after_divide[i] = subtract && !negate_before_divide ? -1 : 0;
+    params->halve[i] = scale == TevScale::Divide2 ? -1 : 0;
+    params->clamp_min[i] = clamp ? 0 : -1024;
+    params->clamp_max[i] = clamp ? 255 : 1023;
+  }
+}
+
+Params MakeParams(const TevStageCombiner::ColorCombiner& cc,
+                  const TevStageCombiner::AlphaCombiner& ac)
+{
+  Params params;
+  SetLanes(&params, BLU_C, RED_C, cc.bias, cc.op, cc.scale, cc.clamp, false);
+  SetLanes(&params, ALP_C, ALP_C, ac.bias, ac.op, ac.scale, ac.clamp, true);
+  return params;
+}
+
+void CombineGeneric(const Inputs& inputs, const Params& params, s32* results)
+{
+  for (int i = 0; i < 4; ++i)
+  {
+    const s32 c = inputs.c[i] + (inputs.c[i] >> 7);
+
+    s32 temp = (inputs.a[i] * (256 - c) + inputs.b[i] * c) * params.scale[i] + params.round[i];
+    temp = params.negate_before_divide[i] ? -temp : temp;
+    temp >>= 8;
+    temp = params.negate_after_divide[i] ? -temp : temp;
+
+    s32 result = (inputs.d[i] + params.bias[i]) * params.scale[i] + temp;
+    result = params.halve[i] ? result >> 1 : result;
+
+    results[i] = std::clamp(result, params.clamp_min[i], params.clamp_max[i]);
+  }
+}
+
+#ifdef _M_X86_64
+// Negates the lanes of value in which mask has all bits set.
+FUNCTION_TARGET_SSR41
+static inline __m128i NegateMasked(__m128i value, __m128i mask)
+{
+  return _mm_sub_epi32(_mm_xor_si128(value, mask), mask);
+}
+
+FUNCTION_TARGET_SSR41
+void CombineSSE41(const Inputs& inputs, const Params& params, s32* results)
+{
+  const auto load = [](const s32* lanes) {
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(lanes));
+  };
+
+  const __m128i a = load(inputs.a);
+  const __m128i b = load(inputs.b);
+  const __m128i c = _mm_add_epi32(load(inputs.c), _mm_srli_epi32(load(inputs.c), 7));
+  const __m128i scale = load(params.scale);
+
+  __m128i temp = _mm_add_epi32(_mm_mullo_epi32(a, _mm_sub_epi32(_mm_set1_epi32(256), c)),
+                               _mm_mullo_epi32(b, c));
+  temp = _mm_add_epi32(_mm_mullo_epi32(temp, scale), load(params.round));
+  temp = NegateMasked(temp, load(params.negate_before_divide));
+  temp = _mm_srai_epi32(temp, 8);
+  temp = NegateMasked(temp, load(params.negate_after_divide));
+
+  __m128i result =
+      _mm_add_epi32(_mm_mullo_epi32(_mm_add_epi32(load(inputs.d), load(params.bias)), scale), temp);
+  result = _mm_blendv_epi8(result, _mm_srai_epi32(result, 1), load(params.halve));
+  result = _mm_min_epi32(_mm_max_epi32(result, load(params.clamp_min)), load(params.clamp_max));
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(results), result);
+}
+#endif
+
+void Combine(const Inputs& inputs, const Params& params, s32* results)
+{
+#ifdef _M_X86_64
+  if (cpu_info.bSSE4_1)
+  {
+    CombineSSE41(inputs, params, results);
+    return;
+  }
+#endif
+
+  CombineGeneric(inputs, params, results);
+}
+}  // namespace TevCombiner
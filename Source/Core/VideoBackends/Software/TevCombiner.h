@@ -0,0 +1,69 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+
+// The arithmetic of the regular (that is, not comparing) TEV color and alpha combiners. A pixel's
+// three color components and its alpha component are computed together, one per SIMD lane, in
+// the same ABGR order the Tev class stores its registers in.
+namespace TevCombiner
+{
+enum
+{
+  ALP_C,
+  BLU_C,
+  GRN_C,
+  RED_C
+};
+
+// The inputs of a stage as the combiners see them: a, b and c are truncated to 8 bits and d is a
+// signed 11 bit value.
+struct Inputs
+{
+  alignas(16) s32 a[4];
+  alignas(16) s32 b[4];
+  alignas(16) s32 c[4];
+  alignas(16) s32 d[4];
+
+  void Set(int component, s16 in_a, s16 in_b, s16 in_c, s16 in_d)
+  {
+    a[component] = in_a & 0xff;
+    b[component] = in_b & 0xff;
+    c[component] = in_c & 0xff;
+    d[component] = ((in_d & 0x7ff) ^ 0x400) - 0x400;
+  }
+};
+
+// The per-lane form of a color and an alpha combiner. Only depends on the combiner registers, so
+// it can be built once and reused for every pixel the stage is drawn with.
+struct Params
+{
+  alignas(16) s32 scale[4];
+  alignas(16) s32 round[4];
+  alignas(16) s32 bias[4];
+  // All bits set in the lanes which subtract. The color combiner negates the product after
+  // dividing it by 256 while the alpha combiner negates it before, which rounds differently.
+  alignas(16) s32 negate_before_divide[4];
+  alignas(16) s32 negate_after_divide[4];
+  // All bits set in the lanes which halve the result.
+  alignas(16) s32 halve[4];
+  alignas(16) s32 clamp_min[4];
+  alignas(16) s32 clamp_max[4];
+};
+
+Params MakeParams(const TevStageCombiner::ColorCombiner& cc,
+                  const TevStageCombiner::AlphaCombiner& ac);
+
+// Computes the clamped results of the combiners for all four components. The lanes of a combiner
+// which compares instead hold meaningless values.
+void Combine(const Inputs& inputs, const Params& params, s32* results);
+
+// The implementations Combine chooses between, exposed for testing.
+void CombineGeneric(const Inputs& inputs, const Params& params, s32* results);
+#ifdef _M_X86_64
+void CombineSSE41(const Inputs& inputs, const Params& params, s32* results);
+#endif
+}  // namespace TevCombiner
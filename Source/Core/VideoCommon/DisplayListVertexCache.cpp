@@ -0,0 +1,223 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/DisplayListVertexCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Common/Hash.h"
+#include "Common/Swap.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VertexLoader_Color.h"
+#include "VideoCommon/VertexLoader_Normal.h"
+#include "VideoCommon/VertexLoader_Position.h"
+#include "VideoCommon/VertexLoader_TextCoord.h"
+
+// Once the vertices at an address have changed this many times, they aren't cached any more.
+constexpr u32 MAX_TIMES_CHANGED = 8;
+// Everything is thrown away when the converted vertices would take up more than this.
+constexpr size_t MAX_CACHED_BYTES = 64 * 1024 * 1024;
+
+namespace
+{
+struct IndexedComponent
+{
+  CPArray array;
+  u32 offset;
+  u32 index_size;
+  u32 num_indices;
+  // How many bytes of the array are read from each index.
+  u32 element_size;
+};
+
+// The components that are read from arrays, in the order they are in a vertex.
+std::vector<IndexedComponent> GetIndexedComponents(const TVtxDesc& vtx_desc, const VAT& vtx_attr)
+{
+  std::vector<IndexedComponent> components;
+  u32 offset = 0;
+  const auto add = [&](CPArray array, VertexComponentFormat format, u32 size, u32 num_indices,
+                       u32 element_size) {
+    if (IsIndexed(format))
+    {
+      const u32 index_size = format == VertexComponentFormat::Index8 ? 1 : 2;
+      components.push_back({array, offset, index_size, num_indices, element_size});
+    }
+    offset += size;
+  };
+
+  if (vtx_desc.low.PosMatIdx)
+    offset++;
+  for (auto texmtxidx : vtx_desc.low.TexMatIdx)
+  {
+    if (texmtxidx)
+      offset++;
+  }
+
+  add(CPArray::Position, vtx_desc.low.Position,
+      VertexLoader_Position::GetSize(vtx_desc.low.Position, vtx_attr.g0.PosFormat,
+                                     vtx_attr.g0.PosElements),
+      1,
+      VertexLoader_Position::GetSize(VertexComponentFormat::Direct, vtx_attr.g0.PosFormat,
+                                     vtx_attr.g0.PosElements));
+
+  // With NormalIndex3, the normal, tangent and binormal each have an index of their own.
+  const bool normal_index3 = vtx_attr.g0.NormalIndex3 &&
+                             vtx_attr.g0.NormalElements == NormalComponentCount::NTB;
+  add(CPArray::Normal, vtx_desc.low.Normal,
+      VertexLoader_Normal::GetSize(vtx_desc.low.Normal, vtx_attr.g0.NormalFormat,
+                                   vtx_attr.g0.NormalElements, vtx_attr.g0.NormalIndex3),
+      normal_index3 ? 3 : 1,
+      VertexLoader_Normal::GetSize(VertexComponentFormat::Direct, vtx_attr.g0.NormalFormat,
+                                   vtx_attr.g0.NormalElements, vtx_attr.g0.NormalIndex3));
+
+  for (u32 i = 0; i < vtx_desc.low.Color.Size(); i++)
+  {
+    add(CPArray::Color0 + i, vtx_desc.low.Color[i],
+        VertexLoader_Color::GetSize(vtx_desc.low.Color[i], vtx_attr.GetColorFormat(i)), 1,
+        VertexLoader_Color::GetSize(VertexComponentFormat::Direct, vtx_attr.GetColorFormat(i)));
+  }
+  for (u32 i = 0; i < vtx_desc.high.TexCoord.Size(); i++)
+  {
+    add(CPArray::TexCoord0 + i, vtx_desc.high.TexCoord[i],
+        VertexLoader_TextCoord::GetSize(vtx_desc.high.TexCoord[i], vtx_attr.GetTexFormat(i),
+                                        vtx_attr.GetTexElements(i)),
+        1,
+        VertexLoader_TextCoord::GetSize(VertexComponentFormat::Direct, vtx_attr.GetTexFormat(i),
+                                        vtx_attr.GetTexElements(i)));
+  }
+
+  return components;
+}
+
+u32 ReadIndex(const u8* data, u32 index_size)
+{
+  return index_size == 1 ? *data : Common::swap16(data);
+}
+}  // namespace
+
+std::optional<int> DisplayListVertexCache::Load(u32 address, VertexLoaderBase* loader,
+                                                const u8* src, int count, u8* dst)
+{
+  const auto iter = m_entries.find(address);
+  if (iter == m_entries.end())
+    return std::nullopt;
+
+  const Entry& entry = iter->second;
+  if (entry.times_changed >= MAX_TIMES_CHANGED || entry.loader != loader || entry.count != count)
+    return std::nullopt;
+
+  const std::optional<u64> hash = HashVertices(src, count * loader->m_vertex_size, entry.arrays);
+  if (!hash || *hash != entry.hash)
+    return std::nullopt;
+
+  std::memcpy(dst, entry.vertices.data(), entry.vertices.size());
+  VertexLoaderManager::position_cache = entry.position_cache;
+  VertexLoaderManager::position_matrix_index_cache = entry.position_matrix_index_cache;
+  VertexLoaderManager::tangent_cache = entry.tangent_cache;
+  VertexLoaderManager::binormal_cache = entry.binormal_cache;
+  loader->m_numLoadedVertices += count;
+  return entry.loaded_count;
+}
+
+void DisplayListVertexCache::Store(u32 address, VertexLoaderBase* loader, const TVtxDesc& vtx_desc,
+                                   const VAT& vtx_attr, const u8* src, int count, const u8* dst,
+                                   int loaded_count)
+{
+  const auto iter = m_entries.find(address);
+  if (iter != m_entries.end() && iter->second.times_changed >= MAX_TIMES_CHANGED)
+    return;
+
+  // Find which part of each array is used. Vertices with the position index set to all ones are
+  // skipped by the loader, so their other indices don't matter.
+  std::vector<ArrayRange> arrays;
+  const std::vector<IndexedComponent> components = GetIndexedComponents(vtx_desc, vtx_attr);
+  const u32 vertex_size = loader->m_vertex_size;
+  for (const IndexedComponent& component : components)
+  {
+    u32 min_index = UINT32_MAX;
+    u32 max_index = 0;
+    for (int i = 0; i < count; i++)
+    {
+      const u8* vertex = src + i * vertex_size;
+      if (components[0].array == CPArray::Position)
+      {
+        const u32 skip_index = components[0].index_size == 1 ? 0xff : 0xffff;
+        if (ReadIndex(vertex + components[0].offset, components[0].index_size) == skip_index)
+          continue;
+      }
+
+      for (u32 j = 0; j < component.num_indices; j++)
+      {
+        const u32 index = ReadIndex(vertex + component.offset + j * component.index_size,
+                                    component.index_size);
+        min_index = std::min(min_index, index);
+        max_index = std::max(max_index, index);
+      }
+    }
+
+    if (min_index > max_index)
+      continue;
+
+    const u32 stride = g_main_cp_state.array_strides[component.array];
+    arrays.push_back({component.array, g_main_cp_state.array_bases[component.array], stride,
+                      min_index * stride,
+                      (max_index - min_index) * stride + component.element_size});
+  }
+
+  const std::optional<u64> hash = HashVertices(src, count * vertex_size, arrays);
+  if (!hash)
+    return;
+
+  const size_t size = static_cast<size_t>(loaded_count) * loader->m_native_vtx_decl.stride;
+  if (m_cached_bytes + size > MAX_CACHED_BYTES)
+    Clear();
+
+  Entry& entry = m_entries[address];
+  m_cached_bytes -= entry.vertices.size();
+  if (entry.loader != nullptr && ++entry.times_changed >= MAX_TIMES_CHANGED)
+  {
+    // The entry stays, to remember not to cache these vertices again.
+    entry.arrays = {};
+    entry.vertices = {};
+    return;
+  }
+
+  entry.loader = loader;
+  entry.count = count;
+  entry.hash = *hash;
+  entry.arrays = std::move(arrays);
+  entry.vertices.assign(dst, dst + size);
+  entry.loaded_count = loaded_count;
+  entry.position_cache = VertexLoaderManager::position_cache;
+  entry.position_matrix_index_cache = VertexLoaderManager::position_matrix_index_cache;
+  entry.tangent_cache = VertexLoaderManager::tangent_cache;
+  entry.binormal_cache = VertexLoaderManager::binormal_cache;
+  m_cached_bytes += size;
+}
+
+void DisplayListVertexCache::Clear()
+{
+  m_entries.clear();
+  m_cached_bytes = 0;
+}
+
+std::optional<u64> DisplayListVertexCache::HashVertices(const u8* src, u32 size,
+                                                        const std::vector<ArrayRange>& arrays)
+{
+  Common::StreamingHash64 hash;
+  hash.Update(src, size);
+  for (const ArrayRange& range : arrays)
+  {
+    const u8* base = VertexLoaderManager::cached_arraybases[range.array];
+    if (base == nullptr || g_main_cp_state.array_bases[range.array] != range.base ||
+        g_main_cp_state.array_strides[range.array] != range.stride)
+    {
+      return std::nullopt;
+    }
+
+    hash.Update(base + range.offset, range.size);
+  }
+  return hash.Digest();
+}
@@ -0,0 +1,74 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/CPMemory.h"
+
+class VertexLoaderBase;
+
+// Keeps what the vertex loaders produced for the primitives in display lists, so that calling a
+// display list again doesn't convert the same vertices again.
+// Display lists are in emulated memory, and both they and the arrays their vertices index can be
+// changed by the game at any time. So every lookup hashes the raw vertices and the parts of the
+// arrays they use, and the converted vertices are only reused if none of that changed. Vertices
+// that keep changing stop being cached, so that they don't have to be hashed every time.
+class DisplayListVertexCache final
+{
+public:
+  // If the count vertices at address in emulated memory, of which src is the data, were converted
+  // by the same loader before and nothing they depend on changed since, writes the converted
+  // vertices to dst, restores the state the loader leaves behind, and returns how many vertices
+  // were written.
+  std::optional<int> Load(u32 address, VertexLoaderBase* loader, const u8* src, int count,
+                          u8* dst);
+
+  // Remembers the vertices that a loader just converted from src to dst, in the vertex format
+  // given by vtx_desc and vtx_attr.
+  void Store(u32 address, VertexLoaderBase* loader, const TVtxDesc& vtx_desc, const VAT& vtx_attr,
+             const u8* src, int count, const u8* dst, int loaded_count);
+
+  void Clear();
+
+private:
+  // The part of an array that the vertices read.
+  struct ArrayRange
+  {
+    CPArray array;
+    u32 base;
+    u32 stride;
+    u32 offset;
+    u32 size;
+  };
+
+  struct Entry
+  {
+    VertexLoaderBase* loader = nullptr;
+    int count = 0;
+    u64 hash = 0;
+    std::vector<ArrayRange> arrays;
+
+    std::vector<u8> vertices;
+    int loaded_count = 0;
+
+    // What the loader left in the zfreeze and emboss caches.
+    std::array<std::array<float, 4>, 3> position_cache;
+    std::array<u32, 3> position_matrix_index_cache;
+    std::array<float, 4> tangent_cache;
+    std::array<float, 4> binormal_cache;
+
+    u32 times_changed = 0;
+  };
+
+  static std::optional<u64> HashVertices(const u8* src, u32 size,
+                                         const std::vector<ArrayRange>& arrays);
+
+  std::unordered_map<u32, Entry> m_entries;
+  size_t m_cached_bytes = 0;
+};
@@ -260,6 +260,8 @@ static void ReadDataFromFifo(u32 readPtr)
                     GPFifo::GATHER_PIPE_SIZE, FIFO_SIZE);
       return;
     }
+    // Vertices in the buffer may not have been converted yet.
+    VertexLoaderManager::WaitForVertexLoaderThread();
     memmove(s_video_buffer, s_video_buffer_read_ptr, existing_len);
     s_video_buffer_write_ptr = s_video_buffer + existing_len;
     s_video_buffer_read_ptr = s_video_buffer;
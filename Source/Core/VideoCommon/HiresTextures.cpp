@@ -4,17 +4,23 @@
 #include "VideoCommon/HiresTextures.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <xxhash.h>
 
 #include <fmt/format.h>
+#include <zstd.h>
 
 #include "Common/CommonPaths.h"
 #include "Common/FileSearch.h"
@@ -27,6 +33,7 @@
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
 #include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 #include "Common/Timer.h"
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
@@ -42,12 +49,265 @@ struct DiskTexture
 constexpr std::string_view s_format_prefix{"tex1_"};
 
 static std::unordered_map<std::string, DiskTexture> s_textureMap;
-static std::unordered_map<std::string, std::shared_ptr<HiresTexture>> s_textureCache;
-static std::mutex s_textureCacheMutex;
 static Common::Flag s_textureCacheAbortLoading;
 
+// The loaded textures are split into shards with a lock each, so that the prefetch workers and
+// Search rarely have to wait for each other.
+struct TextureCacheShard
+{
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<HiresTexture>> textures;
+};
+static std::array<TextureCacheShard, 16> s_textureCacheShards;
+
+static TextureCacheShard& GetTextureCacheShard(const std::string& base_filename)
+{
+  return s_textureCacheShards[std::hash<std::string>{}(base_filename) %
+                              s_textureCacheShards.size()];
+}
+
+static void ClearTextureCache()
+{
+  for (TextureCacheShard& shard : s_textureCacheShards)
+    shard.textures.clear();
+}
+
 static std::thread s_prefetcher;
 
+// Decoded PNG levels from earlier runs, keyed by a hash of the PNG file, so that they don't have to
+// be decoded again. The pixels are compressed with zstd, which is much faster to undo.
+//
+// On disk format:
+// u32 DECODED_CACHE_HEADER[2];
+// Followed by any number of:
+// DecodedLevelHeader header;
+// u8 compressed_data[header.compressed_size];
+struct DecodedLevelHeader
+{
+  u64 png_hash;
+  // A changed PNG file gets a new entry, which replaces the ones with the same path the next time
+  // the cache is opened.
+  u64 path_hash;
+  u32 width;
+  u32 height;
+  u32 data_size;
+  u32 compressed_size;
+};
+
+struct DecodedLevel
+{
+  DecodedLevelHeader header;
+  // Where the compressed data starts in the file.
+  u64 offset;
+};
+
+// "DHTC" and a version number.
+constexpr std::array<u32, 2> DECODED_CACHE_HEADER{0x43544844, 1};
+constexpr int DECODED_LEVEL_COMPRESSION_LEVEL = 1;
+
+static std::mutex s_decodedCacheMutex;
+static File::IOFile s_decodedCache;
+// Only the headers are kept in memory. The pixels are read from the file when they are needed.
+static std::unordered_map<u64, DecodedLevel> s_decodedLevels;
+static bool s_decodedCacheOpen = false;
+
+static u64 GetPathHash(const std::string& path)
+{
+  return XXH64(path.data(), path.size(), 0);
+}
+
+// Returns the latest entry for each path that is still in the pack. dropped_entries is set if the
+// file holds anything else.
+static std::unordered_map<u64, DecodedLevel> ReadDecodedCacheIndex(File::IOFile& file,
+                                                                   bool* dropped_entries)
+{
+  std::unordered_set<u64> paths;
+  for (const auto& entry : s_textureMap)
+    paths.insert(GetPathHash(entry.second.path));
+
+  std::unordered_map<u64, DecodedLevel> levels;
+  std::array<u32, 2> file_header;
+  if (!file.ReadArray(&file_header) || file_header != DECODED_CACHE_HEADER)
+  {
+    *dropped_entries = true;
+    return levels;
+  }
+
+  const u64 file_size = file.GetSize();
+  *dropped_entries = false;
+  DecodedLevel level;
+  while (file.Tell() < file_size)
+  {
+    if (!file.ReadArray(&level.header, 1) ||
+        file_size - file.Tell() < level.header.compressed_size)
+    {
+      // Left behind by a write that didn't finish.
+      *dropped_entries = true;
+      break;
+    }
+
+    level.offset = file.Tell();
+    file.Seek(level.header.compressed_size, File::SeekOrigin::Current);
+
+    if (paths.find(level.header.path_hash) == paths.end())
+    {
+      *dropped_entries = true;
+      continue;
+    }
+
+    const auto [it, inserted] = levels.try_emplace(level.header.path_hash, level);
+    if (!inserted)
+    {
+      it->second = level;
+      *dropped_entries = true;
+    }
+  }
+
+  return levels;
+}
+
+// Writes the given levels to a new file, which then replaces the old one.
+static bool CompactDecodedCache(File::IOFile& file, const std::string& filename,
+                                std::unordered_map<u64, DecodedLevel>* levels)
+{
+  const std::string temp_filename = filename + ".tmp";
+  File::IOFile temp_file(temp_filename, "wb");
+  bool success = temp_file.WriteArray(DECODED_CACHE_HEADER);
+
+  std::vector<u8> data;
+  for (auto& [path_hash, level] : *levels)
+  {
+    data.resize(level.header.compressed_size);
+    success = success && file.Seek(level.offset, File::SeekOrigin::Begin) &&
+              file.ReadBytes(data.data(), data.size()) && temp_file.WriteArray(&level.header, 1);
+    level.offset = temp_file.Tell();
+    success = success && temp_file.WriteBytes(data.data(), data.size());
+  }
+
+  file.Close();
+  success = temp_file.Close() && success;
+  if (!success)
+  {
+    File::Delete(temp_filename);
+    return false;
+  }
+
+  return File::Rename(temp_filename, filename);
+}
+
+static void OpenDecodedCache(const std::string& game_id)
+{
+  const std::string directory = File::GetUserPath(D_CACHE_IDX) + "HiresTextures" DIR_SEP;
+  if (!File::IsDirectory(directory))
+    File::CreateDir(directory);
+
+  const std::string filename = fmt::format("{}{}.cache", directory, game_id);
+  File::IOFile file(filename, "rb");
+  bool dropped_entries = true;
+  std::unordered_map<u64, DecodedLevel> levels;
+  if (file.IsOpen())
+    levels = ReadDecodedCacheIndex(file, &dropped_entries);
+
+  // Without this, every edit to the pack would leave entries behind that are never used again.
+  const bool compacted = !dropped_entries || CompactDecodedCache(file, filename, &levels);
+  file.Close();
+
+  if (!s_decodedCache.Open(filename, compacted ? "r+b" : "w+b"))
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to open decoded custom texture cache {}", filename);
+    return;
+  }
+
+  if (!compacted)
+  {
+    levels.clear();
+    s_decodedCache.WriteArray(DECODED_CACHE_HEADER);
+  }
+
+  for (const auto& [path_hash, level] : levels)
+    s_decodedLevels.try_emplace(level.header.png_hash, level);
+
+  INFO_LOG_FMT(VIDEO, "Found {} decoded custom texture levels in {}", s_decodedLevels.size(),
+               filename);
+  s_decodedCacheOpen = true;
+}
+
+static void CloseDecodedCache()
+{
+  if (!s_decodedCacheOpen)
+    return;
+
+  s_decodedCache.Close();
+  s_decodedLevels.clear();
+  s_decodedCacheOpen = false;
+}
+
+static bool LoadDecodedLevel(u64 hash, std::vector<u8>* data, u32* width, u32* height)
+{
+  DecodedLevelHeader header;
+  std::vector<u8> compressed_data;
+  {
+    std::lock_guard lk(s_decodedCacheMutex);
+    const auto it = s_decodedLevels.find(hash);
+    if (it == s_decodedLevels.end())
+      return false;
+
+    header = it->second.header;
+    compressed_data.resize(header.compressed_size);
+    if (!s_decodedCache.Seek(it->second.offset, File::SeekOrigin::Begin) ||
+        !s_decodedCache.ReadBytes(compressed_data.data(), compressed_data.size()))
+    {
+      s_decodedCache.ClearError();
+      return false;
+    }
+  }
+
+  data->resize(header.data_size);
+  const size_t size = ZSTD_decompress(data->data(), data->size(), compressed_data.data(),
+                                      compressed_data.size());
+  if (ZSTD_isError(size) || size != header.data_size ||
+      size != size_t{header.width} * header.height * 4)
+  {
+    return false;
+  }
+
+  *width = header.width;
+  *height = header.height;
+  return true;
+}
+
+static void StoreDecodedLevel(u64 hash, const std::string& path, const std::vector<u8>& data,
+                              u32 width, u32 height)
+{
+  std::vector<u8> compressed_data(ZSTD_compressBound(data.size()));
+  const size_t size = ZSTD_compress(compressed_data.data(), compressed_data.size(), data.data(),
+                                    data.size(), DECODED_LEVEL_COMPRESSION_LEVEL);
+  if (ZSTD_isError(size))
+    return;
+
+  const DecodedLevelHeader header{hash, GetPathHash(path), width, height,
+                                  static_cast<u32>(data.size()), static_cast<u32>(size)};
+
+  std::lock_guard lk(s_decodedCacheMutex);
+  if (s_decodedLevels.find(hash) != s_decodedLevels.end())
+    return;
+
+  if (!s_decodedCache.Seek(0, File::SeekOrigin::End))
+    return;
+
+  const u64 start = s_decodedCache.Tell();
+  if (!s_decodedCache.WriteArray(&header, 1) ||
+      !s_decodedCache.WriteBytes(compressed_data.data(), size))
+  {
+    // Don't leave a partial entry behind for the next one to be appended to.
+    s_decodedCache.ClearError();
+    s_decodedCache.Resize(start);
+    return;
+  }
+
+  s_decodedLevels.emplace(hash, DecodedLevel{header, start + sizeof(header)});
+}
+
 void HiresTexture::Init()
 {
   // Note: Update is not called here so that we handle dynamic textures on startup more gracefully
@@ -74,10 +334,11 @@ void HiresTexture::Update()
 
   if (!g_ActiveConfig.bCacheHiresTextures)
   {
-    s_textureCache.clear();
+    ClearTextureCache();
   }
 
   const std::string& game_id = SConfig::GetInstance().GetGameID();
+
   const std::set<std::string> texture_directories =
       GetTextureDirectoriesWithGameId(File::GetUserPath(D_HIRESTEXTURES_IDX), game_id);
   const std::vector<std::string> extensions{".png", ".dds"};
@@ -116,19 +377,27 @@ void HiresTexture::Update()
     }
   }
 
+  // The texture map has to be complete before the decoded levels of removed textures are dropped.
+  CloseDecodedCache();
+  if (g_ActiveConfig.bCacheDecodedHiresTextures && !game_id.empty())
+    OpenDecodedCache(game_id);
+
   if (g_ActiveConfig.bCacheHiresTextures)
   {
     // remove cached but deleted textures
-    auto iter = s_textureCache.begin();
-    while (iter != s_textureCache.end())
+    for (TextureCacheShard& shard : s_textureCacheShards)
     {
-      if (s_textureMap.find(iter->first) == s_textureMap.end())
-      {
-        iter = s_textureCache.erase(iter);
-      }
-      else
+      auto iter = shard.textures.begin();
+      while (iter != shard.textures.end())
       {
-        iter++;
+        if (s_textureMap.find(iter->first) == s_textureMap.end())
+        {
+          iter = shard.textures.erase(iter);
+        }
+        else
+        {
+          iter++;
+        }
       }
     }
 
@@ -145,71 +414,86 @@ void HiresTexture::Clear()
     s_prefetcher.join();
   }
   s_textureMap.clear();
-  s_textureCache.clear();
+  ClearTextureCache();
+  CloseDecodedCache();
 }
 
 void HiresTexture::Prefetch()
 {
   Common::SetCurrentThreadName("Prefetcher");
 
-  size_t size_sum = 0;
   const size_t sys_mem = Common::MemPhysical();
   const size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
   // keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other cases
   const size_t max_mem =
       (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
 
-  const u32 start_time = Common::Timer::GetTimeMs();
+  std::vector<const std::string*> base_filenames;
   for (const auto& entry : s_textureMap)
   {
-    const std::string& base_filename = entry.first;
+    if (entry.first.find("_mip") == std::string::npos)
+      base_filenames.push_back(&entry.first);
+  }
 
-    if (base_filename.find("_mip") == std::string::npos)
-    {
-      std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+  std::atomic<size_t> size_sum = 0;
+  std::atomic<bool> out_of_memory = false;
 
-      auto iter = s_textureCache.find(base_filename);
-      if (iter == s_textureCache.end())
-      {
-        // unlock while loading a texture. This may result in a race condition where
-        // we'll load a texture twice, but it reduces the stuttering a lot.
-        lk.unlock();
-        std::unique_ptr<HiresTexture> texture = Load(base_filename, 0, 0);
-        lk.lock();
-        if (texture)
-        {
-          std::shared_ptr<HiresTexture> ptr(std::move(texture));
-          iter = s_textureCache.insert(iter, std::make_pair(base_filename, ptr));
-        }
-      }
-      if (iter != s_textureCache.end())
-      {
-        for (const Level& l : iter->second->m_levels)
-          size_sum += l.data.size();
-      }
-    }
+  const u32 start_time = Common::Timer::GetTimeMs();
+  Common::ThreadPool workers(0, "Prefetcher");
+  workers.ParallelFor(base_filenames.size(), [&](size_t i) {
+    if (s_textureCacheAbortLoading.IsSet() || out_of_memory)
+      return;
 
-    if (s_textureCacheAbortLoading.IsSet())
+    const std::string& base_filename = *base_filenames[i];
+    TextureCacheShard& shard = GetTextureCacheShard(base_filename);
+
+    std::shared_ptr<HiresTexture> texture;
     {
-      return;
+      std::lock_guard lk(shard.mutex);
+      const auto iter = shard.textures.find(base_filename);
+      if (iter != shard.textures.end())
+        texture = iter->second;
     }
 
-    if (size_sum > max_mem)
+    if (!texture)
     {
-      Config::SetCurrent(Config::GFX_HIRES_TEXTURES, false);
-
-      OSD::AddMessage(
-          fmt::format(
-              "Custom Textures prefetching after {:.1f} MB aborted, not enough RAM available",
-              size_sum / (1024.0 * 1024.0)),
-          10000);
-      return;
+      // Load without holding the lock. Search might load the same texture at the same time, which
+      // wastes a bit of work, but it never has to wait for a texture it doesn't need.
+      texture = Load(base_filename, 0, 0);
+      if (!texture)
+        return;
+
+      std::lock_guard lk(shard.mutex);
+      texture = shard.textures.try_emplace(base_filename, std::move(texture)).first->second;
     }
+
+    size_t size = 0;
+    for (const Level& l : texture->m_levels)
+      size += l.data.size();
+    if ((size_sum += size) > max_mem)
+      out_of_memory = true;
+  });
+
+  if (s_textureCacheAbortLoading.IsSet())
+  {
+    return;
+  }
+
+  if (out_of_memory)
+  {
+    Config::SetCurrent(Config::GFX_HIRES_TEXTURES, false);
+
+    OSD::AddMessage(
+        fmt::format("Custom Textures prefetching after {:.1f} MB aborted, not enough RAM available",
+                    size_sum.load() / (1024.0 * 1024.0)),
+        10000);
+    return;
   }
 
   const u32 stop_time = Common::Timer::GetTimeMs();
   OSD::AddMessage(fmt::format("Custom Textures loaded, {:.1f} MB in {:.1f}s",
-                              size_sum / (1024.0 * 1024.0), (stop_time - start_time) / 1000.0),
+                              size_sum.load() / (1024.0 * 1024.0),
+                              (stop_time - start_time) / 1000.0),
                   10000);
 }
 
@@ -264,21 +548,26 @@ u32 HiresTexture::CalculateMipCount(u32 width, u32 height)
 std::shared_ptr<HiresTexture> HiresTexture::Search(const TextureInfo& texture_info)
 {
   const std::string base_filename = GenBaseName(texture_info);
+  TextureCacheShard& shard = GetTextureCacheShard(base_filename);
 
-  std::lock_guard<std::mutex> lk(s_textureCacheMutex);
-
-  auto iter = s_textureCache.find(base_filename);
-  if (iter != s_textureCache.end())
   {
-    return iter->second;
+    std::lock_guard<std::mutex> lk(shard.mutex);
+    auto iter = shard.textures.find(base_filename);
+    if (iter != shard.textures.end())
+    {
+      return iter->second;
+    }
   }
 
+  // The texture is needed right now, so load it here instead of waiting for the prefetcher to get
+  // to it. No lock is held while loading, so this doesn't wait for the prefetcher either.
   std::shared_ptr<HiresTexture> ptr(
       Load(base_filename, texture_info.GetRawWidth(), texture_info.GetRawHeight()));
 
   if (ptr && g_ActiveConfig.bCacheHiresTextures)
   {
-    s_textureCache[base_filename] = ptr;
+    std::lock_guard<std::mutex> lk(shard.mutex);
+    ptr = shard.textures.try_emplace(base_filename, ptr).first->second;
   }
 
   return ptr;
@@ -321,7 +610,7 @@ std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filenam
       std::vector<u8> buffer(file.GetSize());
       file.ReadBytes(buffer.data(), file.GetSize());
 
-      if (!LoadTexture(level, buffer))
+      if (!LoadTexture(level, filename_iter->second.path, buffer))
       {
         ERROR_LOG_FMT(VIDEO, "Custom texture {} failed to load", filename);
         break;
@@ -398,13 +687,21 @@ std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filenam
   return ret;
 }
 
-bool HiresTexture::LoadTexture(Level& level, const std::vector<u8>& buffer)
+bool HiresTexture::LoadTexture(Level& level, const std::string& path,
+                               const std::vector<u8>& buffer)
 {
-  if (!Common::LoadPNG(buffer, &level.data, &level.width, &level.height))
-    return false;
+  const u64 hash = s_decodedCacheOpen ? XXH64(buffer.data(), buffer.size(), 0) : 0;
+  if (!s_decodedCacheOpen || !LoadDecodedLevel(hash, &level.data, &level.width, &level.height))
+  {
+    if (!Common::LoadPNG(buffer, &level.data, &level.width, &level.height))
+      return false;
 
-  if (level.data.empty())
-    return false;
+    if (level.data.empty())
+      return false;
+
+    if (s_decodedCacheOpen)
+      StoreDecodedLevel(hash, path, level.data, level.width, level.height);
+  }
 
   // Loaded PNG images are converted to RGBA.
   level.format = AbstractTextureFormat::RGBA8;
@@ -51,7 +51,7 @@ private:
                                             u32 height);
   static bool LoadDDSTexture(HiresTexture* tex, const std::string& filename);
   static bool LoadDDSTexture(Level& level, const std::string& filename, u32 mip_level);
-  static bool LoadTexture(Level& level, const std::vector<u8>& buffer);
+  static bool LoadTexture(Level& level, const std::string& path, const std::vector<u8>& buffer);
   static void Prefetch();
 
   HiresTexture() = default;
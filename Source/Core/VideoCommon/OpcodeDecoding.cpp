@@ -14,6 +14,8 @@
 
 #include "VideoCommon/OpcodeDecoding.h"
 
+#include <optional>
+
 #include "Common/Assert.h"
 #include "Common/Logging/Log.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
@@ -71,8 +73,14 @@ public:
       }
       else if (sub_command == ARRAY_BASE)
       {
+        // The vertex loaders read the array bases and strides while converting vertices.
+        VertexLoaderManager::WaitForVertexLoaderThread();
         VertexLoaderManager::g_bases_dirty = true;
       }
+      else if (sub_command == ARRAY_STRIDE)
+      {
+        VertexLoaderManager::WaitForVertexLoaderThread();
+      }
 
       INCSTAT(g_stats.this_frame.num_cp_loads);
     }
@@ -119,10 +127,15 @@ public:
     // load vertices
     const u32 size = vertex_size * num_vertices;
 
+    // Vertices in display lists have an address in emulated memory, under which they get cached.
+    std::optional<u32> src_address;
+    if (m_display_list_data != nullptr)
+      src_address = m_display_list_address + static_cast<u32>(vertex_data - m_display_list_data);
+
     // HACK
     DataReader src{const_cast<u8*>(vertex_data), const_cast<u8*>(vertex_data) + size};
-    const u32 bytes =
-        VertexLoaderManager::RunVertices(vat, primitive, num_vertices, src, is_preprocess);
+    const u32 bytes = VertexLoaderManager::RunVertices(vat, primitive, num_vertices, src,
+                                                       is_preprocess, src_address);
 
     ASSERT(bytes == size);
 
@@ -170,7 +183,10 @@ public:
           // temporarily swap dl and non-dl (small "hack" for the stats)
           g_stats.SwapDL();
 
+          m_display_list_address = address;
+          m_display_list_data = start_address;
           Run(start_address, size, *this);
+          m_display_list_data = nullptr;
           INCSTAT(g_stats.this_frame.num_dlists_called);
 
           // un-swap
@@ -230,11 +246,19 @@ public:
 
   u32 m_cycles = 0;
   bool m_in_display_list = false;
+  // The display list being run on the GPU thread, if any.
+  u32 m_display_list_address = 0;
+  const u8* m_display_list_data = nullptr;
 };
 
 template <bool is_preprocess>
 u8* RunFifo(DataReader src, u32* cycles)
 {
+  // Preprocessing only skims the commands on the CPU thread, so it isn't worth timing.
+  std::optional<ScopedStatTimer> timer;
+  if constexpr (!is_preprocess)
+    timer.emplace(g_stats.command_processing_ns);
+
   using CallbackT = RunCallback<is_preprocess>;
   auto callback = CallbackT{};
   u32 size = Run(src.GetPointer(), static_cast<u32>(src.size()), callback);
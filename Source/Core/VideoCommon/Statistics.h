@@ -4,8 +4,11 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <vector>
 
+#include "Common/CommonTypes.h"
 #include "VideoCommon/BPFunctions.h"
 
 struct Statistics
@@ -21,6 +24,13 @@ struct Statistics
 
   int num_vertex_loaders;
 
+  // Cumulative time spent decoding GPU commands (which includes loading their vertices) and
+  // loading vertices, in nanoseconds. Only measured while measure_timings is set, which
+  // dolphin-tool's benchmark does, as it isn't free.
+  std::atomic<bool> measure_timings{false};
+  std::atomic<u64> command_processing_ns{0};
+  std::atomic<u64> vertex_loading_ns{0};
+
   std::array<float, 6> proj;
   std::array<float, 16> gproj;
   std::array<float, 16> g2proj;
@@ -83,6 +93,36 @@ struct Statistics
 
 extern Statistics g_stats;
 
+// Adds the time until it goes out of scope to one of the timing counters above, if they are
+// being measured.
+class ScopedStatTimer
+{
+public:
+  explicit ScopedStatTimer(std::atomic<u64>& counter)
+      : m_counter(g_stats.measure_timings.load(std::memory_order_relaxed) ? &counter : nullptr)
+  {
+    if (m_counter)
+      m_start = std::chrono::steady_clock::now();
+  }
+
+  ~ScopedStatTimer()
+  {
+    if (!m_counter)
+      return;
+
+    const auto elapsed = std::chrono::steady_clock::now() - m_start;
+    m_counter->fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                         std::memory_order_relaxed);
+  }
+
+  ScopedStatTimer(const ScopedStatTimer&) = delete;
+  ScopedStatTimer& operator=(const ScopedStatTimer&) = delete;
+
+private:
+  std::atomic<u64>* m_counter;
+  std::chrono::steady_clock::time_point m_start;
+};
+
 #define STATISTICS
 
 #ifdef STATISTICS
@@ -25,6 +25,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
 #include "Common/MemoryUtil.h"
+#include "Common/ThreadPool.h"
 
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
@@ -47,6 +48,7 @@
 #include "VideoCommon/TextureConversionShader.h"
 #include "VideoCommon/TextureConverterShaderGen.h"
 #include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/TextureDumper.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
@@ -56,6 +58,12 @@ static const u64 TEXHASH_INVALID = 0;
 static const int TEXTURE_KILL_THRESHOLD = 64;
 static const int TEXTURE_POOL_KILL_THRESHOLD = 3;
 
+// Textures with fewer texels than this, counting all levels, are decoded on the GPU thread alone,
+// as handing them out to other threads would cost more than it saves.
+static const u32 MIN_TEXELS_FOR_PARALLEL_DECODE = 256 * 256;
+// How many texels are decoded at once by one thread.
+static const u32 DECODE_BAND_TEXELS = 64 * 1024;
+
 static int xfb_count = 0;
 
 std::unique_ptr<TextureCacheBase> g_texture_cache;
@@ -82,6 +90,86 @@ void TextureCacheBase::CheckTempSize(size_t required_size)
   temp = static_cast<u8*>(Common::AllocateAlignedMemory(temp_size, 16));
 }
 
+void TextureCacheBase::DecodeTextureOnCPU(u8* dst, const TextureInfo& texture_info,
+                                          u32 first_level)
+{
+  struct DecodeLevel
+  {
+    u8* dst;
+    const u8* src;
+    int width;
+    int height;
+  };
+  std::vector<DecodeLevel> levels;
+  u32 total_texels = 0;
+  for (u32 level = first_level; level < texture_info.GetLevelCount(); ++level)
+  {
+    DecodeLevel decode_level{dst, texture_info.GetData(),
+                             static_cast<int>(texture_info.GetExpandedWidth()),
+                             static_cast<int>(texture_info.GetExpandedHeight())};
+    if (level != 0)
+    {
+      const auto mip_level = texture_info.GetMipMapLevel(level - 1);
+      if (!mip_level)
+        continue;
+
+      decode_level = {dst, mip_level->GetData(), static_cast<int>(mip_level->GetExpandedWidth()),
+                      static_cast<int>(mip_level->GetExpandedHeight())};
+    }
+
+    levels.push_back(decode_level);
+    dst += decode_level.width * sizeof(u32) * decode_level.height;
+    total_texels += decode_level.width * decode_level.height;
+  }
+
+  const TextureFormat format = texture_info.GetTextureFormat();
+  const u8* tlut = texture_info.GetTlutAddress();
+  const TLUTFormat tlut_format = texture_info.GetTlutFormat();
+  if (total_texels < MIN_TEXELS_FOR_PARALLEL_DECODE ||
+      Common::ThreadPool::GetDefaultThreadCount() < 2)
+  {
+    for (const DecodeLevel& level : levels)
+      TexDecoder_Decode(level.dst, level.src, level.width, level.height, format, tlut, tlut_format);
+    return;
+  }
+
+  // The GPU thread decodes bands as well, so this leaves room for the CPU thread and the rest of
+  // the emulator.
+  if (!m_decode_thread_pool)
+  {
+    m_decode_thread_pool = std::make_unique<Common::ThreadPool>(
+        std::clamp<size_t>(Common::ThreadPool::GetDefaultThreadCount() / 2, 1, 4),
+        "TextureDecoder");
+  }
+
+  struct DecodeBand
+  {
+    const DecodeLevel* level;
+    int first_row;
+    int num_rows;
+  };
+  std::vector<DecodeBand> bands;
+  const int block_height = TexDecoder_GetBlockHeightInTexels(format);
+  for (const DecodeLevel& level : levels)
+  {
+    const int band_height =
+        std::max(static_cast<int>(DECODE_BAND_TEXELS) / level.width / block_height, 1) *
+        block_height;
+    for (int row = 0; row < level.height; row += band_height)
+      bands.push_back({&level, row, band_height});
+  }
+
+  m_decode_thread_pool->ParallelFor(bands.size(), [&](size_t i) {
+    const DecodeBand& band = bands[i];
+    TexDecoder_DecodeRows(band.level->dst, band.level->src, band.level->width,
+                          band.level->height, band.first_row, band.num_rows, format, tlut,
+                          tlut_format);
+  });
+
+  for (const DecodeLevel& level : levels)
+    TexDecoder_FinishDecode(level.dst, level.width, level.height, format);
+}
+
 TextureCacheBase::TextureCacheBase()
 {
   SetBackupConfig(g_ActiveConfig);
@@ -132,6 +220,7 @@ void TextureCacheBase::Invalidate()
     delete tex.second;
   }
   textures_by_address.clear();
+  textures_by_range.clear();
   textures_by_hash.clear();
 
   texture_pool.clear();
@@ -151,11 +240,17 @@ void TextureCacheBase::ForceReload()
 void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
 {
   if (config.bHiresTextures != backup_config.hires_textures ||
-      config.bCacheHiresTextures != backup_config.cache_hires_textures)
+      config.bCacheHiresTextures != backup_config.cache_hires_textures ||
+      config.bCacheDecodedHiresTextures != backup_config.cache_decoded_hires_textures)
   {
     HiresTexture::Update();
   }
 
+  // Finish saving the textures that are still queued, so that all of them are on disk once
+  // dumping has been turned off.
+  if (!config.bDumpTextures && backup_config.dump_textures && m_texture_dumper)
+    m_texture_dumper->Flush();
+
   const u32 change_count =
       config.graphics_mod_config ? config.graphics_mod_config->GetChangeCount() : 0;
 
@@ -258,6 +353,8 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
   backup_config.texfmt_overlay_center = config.bTexFmtOverlayCenter;
   backup_config.hires_textures = config.bHiresTextures;
   backup_config.cache_hires_textures = config.bCacheHiresTextures;
+  backup_config.cache_decoded_hires_textures = config.bCacheDecodedHiresTextures;
+  backup_config.dump_textures = config.bDumpTextures;
   backup_config.stereo_3d = config.stereo_mode != StereoMode::Off;
   backup_config.efb_mono_depth = config.bStereoEFBMonoDepth;
   backup_config.gpu_texture_decoding = config.bEnableGPUTextureDecoding;
@@ -333,7 +430,7 @@ TextureCacheBase::ApplyPaletteToEntry(TCacheEntry* entry, const u8* palette, TLU
     g_renderer->EndUtilityDrawing();
   }
 
-  textures_by_address.emplace(decoded_entry->addr, decoded_entry);
+  AddToTextureCache(decoded_entry);
 
   return decoded_entry;
 }
@@ -380,7 +477,7 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::ReinterpretEntry(const TCacheEn
   g_renderer->EndUtilityDrawing();
   reinterpreted_entry->texture->FinishedRendering();
 
-  textures_by_address.emplace(reinterpreted_entry->addr, reinterpreted_entry);
+  AddToTextureCache(reinterpreted_entry);
 
   return reinterpreted_entry;
 }
@@ -730,7 +827,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      textures_by_address.emplace(addr, entry);
+      AddToTextureCache(entry);
   }
 
   // Fill in hash map.
@@ -797,13 +894,12 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
 
   u32 numBlocksX = (entry_to_update->native_width + block_width - 1) / block_width;
 
-  auto iter = FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes);
-  while (iter.first != iter.second)
+  for (TexAddrCache::iterator iter :
+       FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes))
   {
-    TCacheEntry* entry = iter.first->second;
+    TCacheEntry* entry = iter->second;
     if (entry != entry_to_update && entry->IsCopy() && !entry->tmem_only &&
         entry->references.count(entry_to_update) == 0 &&
-        entry->OverlapsMemoryRange(entry_to_update->addr, entry_to_update->size_in_bytes) &&
         entry->memory_stride == numBlocksX * block_size)
     {
       if (entry->hash == entry->CalculateHash())
@@ -813,7 +909,6 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
         {
           if (!CanReinterpretTextureOnGPU(entry_to_update->format.texfmt, entry->format.texfmt))
           {
-            ++iter.first;
             continue;
           }
 
@@ -837,7 +932,6 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
           }
           else
           {
-            ++iter.first;
             continue;
           }
         }
@@ -899,7 +993,6 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
             static_cast<u32>(dst_x + copy_width) > entry_to_update->GetWidth() ||
             static_cast<u32>(dst_y + copy_height) > entry_to_update->GetHeight())
         {
-          ++iter.first;
           continue;
         }
 
@@ -925,7 +1018,7 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
         {
           // Remove the temporary converted texture, it won't be used anywhere else
           // TODO: It would be nice to convert and copy in one step, but this code path isn't common
-          iter.first = InvalidateTexture(iter.first);
+          InvalidateTexture(iter);
           continue;
         }
         else
@@ -939,25 +1032,19 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
-        continue;
+        InvalidateTexture(iter);
       }
     }
-    ++iter.first;
   }
 
   return entry_to_update;
 }
 
 void TextureCacheBase::DumpTexture(TCacheEntry* entry, std::string basename, unsigned int level,
-                                   bool is_arbitrary)
+                                   bool is_arbitrary, const u8* decoded_data, u32 decoded_stride)
 {
   std::string szDir = File::GetUserPath(D_DUMPTEXTURES_IDX) + SConfig::GetInstance().GetGameID();
 
-  // make sure that the directory exists
-  if (!File::IsDirectory(szDir))
-    File::CreateDir(szDir);
-
   if (is_arbitrary)
   {
     basename += "_arb";
@@ -975,11 +1062,32 @@ void TextureCacheBase::DumpTexture(TCacheEntry* entry, std::string basename, uns
       return;
   }
 
-  const std::string filename = fmt::format("{}/{}.png", szDir, basename);
-  if (File::Exists(filename))
+  if (!m_texture_dumper)
+    m_texture_dumper = std::make_unique<TextureDumper>();
+  if (!m_texture_dumper->IsDumpNeeded(szDir, basename))
     return;
 
-  entry->texture->Save(filename, level);
+  const MathUtil::Rectangle<int> rect = entry->texture->GetConfig().GetMipRect(level);
+  const u32 width = rect.GetWidth();
+  const u32 height = rect.GetHeight();
+
+  if (decoded_data)
+  {
+    m_texture_dumper->Dump(szDir, std::move(basename), width, height, [&](u8* pixels) {
+      for (u32 y = 0; y < height; ++y)
+        std::memcpy(pixels + y * width * 4, decoded_data + y * decoded_stride * 4, width * 4);
+    });
+    return;
+  }
+
+  // The level was decoded on the GPU, so it has to be read back.
+  if (!CheckReadbackTexture(width, height, AbstractTextureFormat::RGBA8))
+    return;
+
+  m_readback_texture->CopyFromTexture(entry->texture.get(), rect, 0, level, rect);
+  m_texture_dumper->Dump(szDir, std::move(basename), width, height, [&](u8* pixels) {
+    m_readback_texture->ReadTexels(rect, pixels, width * 4);
+  });
 }
 
 // Helper for checking if a BPMemory TexMode0 register is set to Point
@@ -1570,6 +1678,17 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize,
   // Initialized to null because only software loading uses this buffer
   u8* dst_buffer = nullptr;
 
+  // Where each level was decoded on the CPU, so that dumping can use it instead of reading the
+  // texture back from the GPU.
+  struct DecodedLevel
+  {
+    const u8* data = nullptr;
+    u32 stride = 0;
+  };
+  std::vector<DecodedLevel> decoded_levels;
+  if (g_ActiveConfig.bDumpTextures && !hires_tex)
+    decoded_levels.resize(texLevels);
+
   if (!hires_tex)
   {
     if (!decode_on_gpu ||
@@ -1599,37 +1718,49 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize,
 
       CheckTempSize(total_texture_size);
       dst_buffer = temp;
-      if (!(texture_info.GetTextureFormat() == TextureFormat::RGBA8 && texture_info.IsFromTmem()))
-      {
-        TexDecoder_Decode(dst_buffer, texture_info.GetData(), expanded_width, expanded_height,
-                          texture_info.GetTextureFormat(), texture_info.GetTlutAddress(),
-                          texture_info.GetTlutFormat());
-      }
-      else
+      const bool rgba8_from_tmem =
+          texture_info.GetTextureFormat() == TextureFormat::RGBA8 && texture_info.IsFromTmem();
+      if (rgba8_from_tmem)
       {
         TexDecoder_DecodeRGBA8FromTmem(dst_buffer, texture_info.GetData(),
                                        texture_info.GetTmemOddAddress(), expanded_width,
                                        expanded_height);
       }
 
+      // Without GPU decoding, all levels get decoded here at once, so that they can be spread over
+      // several threads. They are then uploaded one after another below.
+      if (!decode_on_gpu)
+      {
+        DecodeTextureOnCPU(rgba8_from_tmem ? dst_buffer + decoded_texture_size : dst_buffer,
+                           texture_info, rgba8_from_tmem ? 1 : 0);
+      }
+      else
+      {
+        TexDecoder_Decode(dst_buffer, texture_info.GetData(), expanded_width, expanded_height,
+                          texture_info.GetTextureFormat(), texture_info.GetTlutAddress(),
+                          texture_info.GetTlutFormat());
+      }
+
       entry->texture->Load(0, width, height, expanded_width, dst_buffer, decoded_texture_size);
 
       arbitrary_mip_detector.AddLevel(width, height, expanded_width, dst_buffer);
+      if (!decoded_levels.empty())
+        decoded_levels[0] = {dst_buffer, expanded_width};
 
       dst_buffer += decoded_texture_size;
     }
   }
 
-  iter = textures_by_address.emplace(texture_info.GetRawAddress(), entry);
+  entry->SetGeneralParameters(texture_info.GetRawAddress(), texture_info.GetTextureSize(),
+                              full_format, false);
+
+  iter = AddToTextureCache(entry);
   if (textureCacheSafetyColorSampleSize == 0 ||
       std::max(texture_info.GetTextureSize(), palette_size) <=
           (u32)textureCacheSafetyColorSampleSize * 8)
   {
     entry->textures_by_hash_iter = textures_by_hash.emplace(full_hash, entry);
   }
-
-  entry->SetGeneralParameters(texture_info.GetRawAddress(), texture_info.GetTextureSize(),
-                              full_format, false);
   entry->SetDimensions(texture_info.GetRawWidth(), texture_info.GetRawHeight(),
                        texture_info.GetLevelCount());
   entry->SetHashes(base_hash, full_hash);
@@ -1671,14 +1802,19 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize,
         // No need to call CheckTempSize here, as the whole buffer is preallocated at the beginning
         const u32 decoded_mip_size =
             mip_level->GetExpandedWidth() * sizeof(u32) * mip_level->GetExpandedHeight();
-        TexDecoder_Decode(dst_buffer, mip_level->GetData(), mip_level->GetExpandedWidth(),
-                          mip_level->GetExpandedHeight(), texture_info.GetTextureFormat(),
-                          texture_info.GetTlutAddress(), texture_info.GetTlutFormat());
+        if (decode_on_gpu)
+        {
+          TexDecoder_Decode(dst_buffer, mip_level->GetData(), mip_level->GetExpandedWidth(),
+                            mip_level->GetExpandedHeight(), texture_info.GetTextureFormat(),
+                            texture_info.GetTlutAddress(), texture_info.GetTlutFormat());
+        }
         entry->texture->Load(level, mip_level->GetRawWidth(), mip_level->GetRawHeight(),
                              mip_level->GetExpandedWidth(), dst_buffer, decoded_mip_size);
 
         arbitrary_mip_detector.AddLevel(mip_level->GetRawWidth(), mip_level->GetRawHeight(),
                                         mip_level->GetExpandedWidth(), dst_buffer);
+        if (!decoded_levels.empty())
+          decoded_levels[level] = {dst_buffer, mip_level->GetExpandedWidth()};
 
         dst_buffer += decoded_mip_size;
       }
@@ -1692,7 +1828,8 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize,
   {
     for (u32 level = 0; level < texLevels; ++level)
     {
-      DumpTexture(entry, basename, level, entry->has_arbitrary_mips);
+      DumpTexture(entry, basename, level, entry->has_arbitrary_mips, decoded_levels[level].data,
+                  decoded_levels[level].stride);
     }
   }
 
@@ -1774,7 +1911,7 @@ TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height, u32 stride,
   entry->texture->FinishedRendering();
 
   // Insert into the texture cache so we can re-use it next frame, if needed.
-  textures_by_address.emplace(entry->addr, entry);
+  AddToTextureCache(entry);
   SETSTAT(g_stats.num_textures_alive, static_cast<int>(textures_by_address.size()));
   INCSTAT(g_stats.num_textures_uploaded);
 
@@ -1844,17 +1981,16 @@ void TextureCacheBase::StitchXFBCopy(TCacheEntry* stitched_entry)
   std::vector<TCacheEntry*> candidates;
   bool create_upscaled_copy = false;
 
-  auto iter = FindOverlappingTextures(stitched_entry->addr, stitched_entry->size_in_bytes);
-  while (iter.first != iter.second)
+  for (TexAddrCache::iterator iter :
+       FindOverlappingTextures(stitched_entry->addr, stitched_entry->size_in_bytes))
   {
     // Currently, this checks the stride of the VRAM copy against the VI request. Therefore, for
     // interlaced modes, VRAM copies won't be considered candidates. This is okay for now, because
     // our force progressive hack means that an XFB copy should always have a matching stride. If
     // the hack is disabled, XFB2RAM should also be enabled. Should we wish to implement interlaced
     // stitching in the future, this would require a shader which grabs every second line.
-    TCacheEntry* entry = iter.first->second;
+    TCacheEntry* entry = iter->second;
     if (entry != stitched_entry && entry->IsCopy() && !entry->tmem_only &&
-        entry->OverlapsMemoryRange(stitched_entry->addr, stitched_entry->size_in_bytes) &&
         entry->memory_stride == stitched_entry->memory_stride)
     {
       if (entry->hash == entry->CalculateHash())
@@ -1868,11 +2004,9 @@ void TextureCacheBase::StitchXFBCopy(TCacheEntry* stitched_entry)
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
-        continue;
+        InvalidateTexture(iter);
       }
     }
-    ++iter.first;
   }
 
   if (candidates.empty())
@@ -2303,10 +2437,9 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   // as our efb copy are marked to check them for partial texture updates.
   // TODO: The logic to detect overlapping strided efb copies is not 100% accurate.
   bool strided_efb_copy = dstStride != bytes_per_row;
-  auto iter = FindOverlappingTextures(dstAddr, covered_range);
-  while (iter.first != iter.second)
+  for (TexAddrCache::iterator iter : FindOverlappingTextures(dstAddr, covered_range))
   {
-    TCacheEntry* overlapping_entry = iter.first->second;
+    TCacheEntry* overlapping_entry = iter->second;
 
     if (overlapping_entry->addr == dstAddr && overlapping_entry->is_xfb_copy)
     {
@@ -2316,49 +2449,45 @@ void TextureCacheBase::CopyRenderTargetToTexture(
       }
     }
 
-    if (overlapping_entry->OverlapsMemoryRange(dstAddr, covered_range))
+    u32 overlap_range = std::min(overlapping_entry->addr + overlapping_entry->size_in_bytes,
+                                 dstAddr + covered_range) -
+                        std::max(overlapping_entry->addr, dstAddr);
+    if (!copy_to_vram || overlapping_entry->memory_stride != dstStride ||
+        (!strided_efb_copy && overlapping_entry->size_in_bytes == overlap_range) ||
+        (strided_efb_copy && overlapping_entry->size_in_bytes == overlap_range &&
+         overlapping_entry->addr == dstAddr))
     {
-      u32 overlap_range = std::min(overlapping_entry->addr + overlapping_entry->size_in_bytes,
-                                   dstAddr + covered_range) -
-                          std::max(overlapping_entry->addr, dstAddr);
-      if (!copy_to_vram || overlapping_entry->memory_stride != dstStride ||
-          (!strided_efb_copy && overlapping_entry->size_in_bytes == overlap_range) ||
-          (strided_efb_copy && overlapping_entry->size_in_bytes == overlap_range &&
-           overlapping_entry->addr == dstAddr))
-      {
-        // Pending EFB copies which are completely covered by this new copy can simply be tossed,
-        // instead of having to flush them later on, since this copy will write over everything.
-        iter.first = InvalidateTexture(iter.first, true);
-        continue;
-      }
+      // Pending EFB copies which are completely covered by this new copy can simply be tossed,
+      // instead of having to flush them later on, since this copy will write over everything.
+      InvalidateTexture(iter, true);
+      continue;
+    }
 
-      // We don't want to change the may_have_overlapping_textures flag on XFB container entries
-      // because otherwise they can't be re-used/updated, leaking textures for several frames.
-      if (!overlapping_entry->is_xfb_container)
-        overlapping_entry->may_have_overlapping_textures = true;
-
-      // There are cases (Rogue Squadron 2 / Texas Holdem on Wiiware) where
-      // for xfb copies the textures overlap which causes the hash of the first copy
-      // to be different (from when it was originally created).  This has no implications
-      // for XFB2Tex because the underlying memory doesn't change (dummy values) but
-      // can affect XFB2Ram when we compare the texture cache copy hash with the
-      // newly computed hash
-      // By calculating the hash when we receive overlapping xfbs, we are able
-      // to mitigate this
-      if (overlapping_entry->is_xfb_copy && copy_to_ram)
-      {
-        overlapping_entry->hash = overlapping_entry->CalculateHash();
-      }
+    // We don't want to change the may_have_overlapping_textures flag on XFB container entries
+    // because otherwise they can't be re-used/updated, leaking textures for several frames.
+    if (!overlapping_entry->is_xfb_container)
+      overlapping_entry->may_have_overlapping_textures = true;
 
-      // Do not load textures by hash, if they were at least partly overwritten by an efb copy.
-      // In this case, comparing the hash is not enough to check, if two textures are identical.
-      if (overlapping_entry->textures_by_hash_iter != textures_by_hash.end())
-      {
-        textures_by_hash.erase(overlapping_entry->textures_by_hash_iter);
-        overlapping_entry->textures_by_hash_iter = textures_by_hash.end();
-      }
+    // There are cases (Rogue Squadron 2 / Texas Holdem on Wiiware) where
+    // for xfb copies the textures overlap which causes the hash of the first copy
+    // to be different (from when it was originally created).  This has no implications
+    // for XFB2Tex because the underlying memory doesn't change (dummy values) but
+    // can affect XFB2Ram when we compare the texture cache copy hash with the
+    // newly computed hash
+    // By calculating the hash when we receive overlapping xfbs, we are able
+    // to mitigate this
+    if (overlapping_entry->is_xfb_copy && copy_to_ram)
+    {
+      overlapping_entry->hash = overlapping_entry->CalculateHash();
+    }
+
+    // Do not load textures by hash, if they were at least partly overwritten by an efb copy.
+    // In this case, comparing the hash is not enough to check, if two textures are identical.
+    if (overlapping_entry->textures_by_hash_iter != textures_by_hash.end())
+    {
+      textures_by_hash.erase(overlapping_entry->textures_by_hash_iter);
+      overlapping_entry->textures_by_hash_iter = textures_by_hash.end();
     }
-    ++iter.first;
   }
 
   if (OpcodeDecoder::g_record_fifo_data)
@@ -2379,7 +2508,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   {
     const u64 hash = entry->CalculateHash();
     entry->SetHashes(hash, hash);
-    textures_by_address.emplace(dstAddr, entry);
+    AddToTextureCache(entry);
   }
 }
 
@@ -2427,12 +2556,10 @@ void TextureCacheBase::FlushEFBCopy(TCacheEntry* entry)
   if (entry->is_xfb_copy)
   {
     const u32 covered_range = entry->pending_efb_copy_height * entry->memory_stride;
-    auto range = FindOverlappingTextures(entry->addr, covered_range);
-    for (auto iter = range.first; iter != range.second; ++iter)
+    for (TexAddrCache::iterator iter : FindOverlappingTextures(entry->addr, covered_range))
     {
       TCacheEntry* overlapping_entry = iter->second;
-      if (overlapping_entry->may_have_overlapping_textures && overlapping_entry->is_xfb_copy &&
-          overlapping_entry->OverlapsMemoryRange(entry->addr, covered_range))
+      if (overlapping_entry->may_have_overlapping_textures && overlapping_entry->is_xfb_copy)
       {
         const u64 overlapping_hash = overlapping_entry->CalculateHash();
         entry->SetHashes(overlapping_hash, overlapping_hash);
@@ -2599,21 +2726,79 @@ TextureCacheBase::GetTexCacheIter(TextureCacheBase::TCacheEntry* entry)
   return textures_by_address.end();
 }
 
-std::pair<TextureCacheBase::TexAddrCache::iterator, TextureCacheBase::TexAddrCache::iterator>
+// The range index lists every texture under each of these blocks of memory it covers. They are
+// large enough that even big textures are only listed a few dozen times, and small enough that
+// textures in other parts of memory rarely share a block with the queried range.
+constexpr u32 RANGE_INDEX_BLOCK_SHIFT = 16;
+
+static std::pair<u32, u32> GetRangeIndexBlocks(u32 addr, u32 size_in_bytes)
+{
+  const u32 last_addr = addr + std::max<u32>(size_in_bytes, 1) - 1;
+  return {addr >> RANGE_INDEX_BLOCK_SHIFT, last_addr >> RANGE_INDEX_BLOCK_SHIFT};
+}
+
+TextureCacheBase::TexAddrCache::iterator TextureCacheBase::AddToTextureCache(TCacheEntry* entry)
+{
+  const auto iter = textures_by_address.emplace(entry->addr, entry);
+
+  const auto [first_block, last_block] = GetRangeIndexBlocks(entry->addr, entry->size_in_bytes);
+  for (u32 block = first_block; block <= last_block; ++block)
+    textures_by_range[block].push_back(iter);
+
+  return iter;
+}
+
+void TextureCacheBase::RemoveFromRangeIndex(TexAddrCache::iterator iter)
+{
+  const TCacheEntry* entry = iter->second;
+  const auto [first_block, last_block] = GetRangeIndexBlocks(entry->addr, entry->size_in_bytes);
+  for (u32 block = first_block; block <= last_block; ++block)
+  {
+    auto bucket = textures_by_range.find(block);
+    if (bucket == textures_by_range.end())
+      continue;
+
+    std::vector<TexAddrCache::iterator>& entries = bucket->second;
+    const auto found = std::find(entries.begin(), entries.end(), iter);
+    if (found != entries.end())
+    {
+      *found = entries.back();
+      entries.pop_back();
+    }
+    if (entries.empty())
+      textures_by_range.erase(bucket);
+  }
+}
+
+std::vector<TextureCacheBase::TexAddrCache::iterator>
 TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
 {
-  // We index by the starting address only, so there is no way to query all textures
-  // which end after the given addr. But the GC textures have a limited size, so we
-  // look for all textures which have a start address bigger than addr minus the maximal
-  // texture size. But this yields false-positives which must be checked later on.
+  std::vector<TexAddrCache::iterator> result;
 
-  // 1024 x 1024 texel times 8 nibbles per texel
-  constexpr u32 max_texture_size = 1024 * 1024 * 4;
-  u32 lower_addr = addr > max_texture_size ? addr - max_texture_size : 0;
-  auto begin = textures_by_address.lower_bound(lower_addr);
-  auto end = textures_by_address.upper_bound(addr + size_in_bytes);
+  const auto [first_block, last_block] = GetRangeIndexBlocks(addr, size_in_bytes);
+  for (u32 block = first_block; block <= last_block; ++block)
+  {
+    const auto bucket = textures_by_range.find(block);
+    if (bucket == textures_by_range.end())
+      continue;
 
-  return std::make_pair(begin, end);
+    for (const TexAddrCache::iterator& iter : bucket->second)
+    {
+      // A texture covering several of the queried blocks is only reported from the first one.
+      const u32 entry_first_block = iter->second->addr >> RANGE_INDEX_BLOCK_SHIFT;
+      if (std::max(entry_first_block, first_block) == block &&
+          iter->second->OverlapsMemoryRange(addr, size_in_bytes))
+      {
+        result.push_back(iter);
+      }
+    }
+  }
+
+  // The order textures_by_address would have listed them in.
+  std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+    return std::tie(a->first, a->second->id) < std::tie(b->first, b->second->id);
+  });
+  return result;
 }
 
 TextureCacheBase::TexAddrCache::iterator
@@ -2680,6 +2865,8 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
   texture_pool.emplace(config,
                        TexPoolEntry(std::move(entry->texture), std::move(entry->framebuffer)));
 
+  RemoveFromRangeIndex(iter);
+
   // Don't delete if there's a pending EFB copy, as we need the TCacheEntry alive.
   if (!entry->pending_efb_copy)
     delete entry;
@@ -3015,18 +3202,26 @@ u64 TextureCacheBase::TCacheEntry::CalculateHash() const
   {
     return Common::GetHash64(ptr, size_in_bytes, hash_sample_size);
   }
+  else if (hash_sample_size == 0)
+  {
+    // Hash the rows as if they were contiguous, which is as fast as hashing them in one go.
+    const u32 num_blocks_y = NumBlocksY();
+    Common::StreamingHash64 rows_hash;
+    for (u32 i = 0; i < num_blocks_y; i++)
+    {
+      rows_hash.Update(ptr, bytes_per_row);
+      ptr += memory_stride;
+    }
+    return rows_hash.Digest();
+  }
   else
   {
     const u32 num_blocks_y = NumBlocksY();
     u64 temp_hash = size_in_bytes;
 
-    u32 samples_per_row = 0;
-    if (hash_sample_size != 0)
-    {
-      // Hash at least 4 samples per row to avoid hashing in a bad pattern, like just on the left
-      // side of the efb copy
-      samples_per_row = std::max(hash_sample_size / num_blocks_y, 4u);
-    }
+    // Hash at least 4 samples per row to avoid hashing in a bad pattern, like just on the left
+    // side of the efb copy
+    const u32 samples_per_row = std::max(hash_sample_size / num_blocks_y, 4u);
 
     for (u32 i = 0; i < num_blocks_y; i++)
     {
@@ -28,8 +28,14 @@
 class AbstractFramebuffer;
 class AbstractStagingTexture;
 class PointerWrap;
+class TextureDumper;
 struct VideoConfig;
 
+namespace Common
+{
+class ThreadPool;
+}
+
 constexpr std::string_view EFB_DUMP_PREFIX = "efb1";
 constexpr std::string_view XFB_DUMP_PREFIX = "xfb1";
 
@@ -300,6 +306,8 @@ protected:
 
 private:
   using TexAddrCache = std::multimap<u32, TCacheEntry*>;
+  // The entries of textures_by_address, listed under every block of memory they cover.
+  using TexRangeIndex = std::unordered_map<u32, std::vector<TexAddrCache::iterator>>;
   using TexHashCache = std::multimap<u64, TCacheEntry*>;
   using TexPool = std::unordered_multimap<TextureConfig, TexPoolEntry>;
 
@@ -317,18 +325,27 @@ private:
                                        TLUTFormat tlutfmt);
   void StitchXFBCopy(TCacheEntry* entry_to_update);
 
-  void DumpTexture(TCacheEntry* entry, std::string basename, unsigned int level, bool is_arbitrary);
+  // decoded_data is the level as decoded on the CPU, or nullptr if it has to be read back from the
+  // GPU. Its stride is given in pixels.
+  void DumpTexture(TCacheEntry* entry, std::string basename, unsigned int level, bool is_arbitrary,
+                   const u8* decoded_data, u32 decoded_stride);
   void CheckTempSize(size_t required_size);
+  // Decodes the levels of a texture from first_level on, one after another into dst. Large
+  // textures are split into bands of block rows, which are decoded on several threads.
+  void DecodeTextureOnCPU(u8* dst, const TextureInfo& texture_info, u32 first_level);
 
   TCacheEntry* AllocateCacheEntry(const TextureConfig& config);
   std::optional<TexPoolEntry> AllocateTexture(const TextureConfig& config);
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
   TexAddrCache::iterator GetTexCacheIter(TCacheEntry* entry);
 
-  // Return all possible overlapping textures. As addr+size of the textures is not
-  // indexed, this may return false positives.
-  std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
-  FindOverlappingTextures(u32 addr, u32 size_in_bytes);
+  // Adds the entry to textures_by_address and the range index.
+  TexAddrCache::iterator AddToTextureCache(TCacheEntry* entry);
+  void RemoveFromRangeIndex(TexAddrCache::iterator iter);
+
+  // Returns exactly the textures which overlap the given range, ordered by address and then by
+  // creation. Invalidating one of them leaves the others valid.
+  std::vector<TexAddrCache::iterator> FindOverlappingTextures(u32 addr, u32 size_in_bytes);
 
   // Removes and unlinks texture from texture cache and returns it to the pool
   TexAddrCache::iterator InvalidateTexture(TexAddrCache::iterator t_iter,
@@ -359,6 +376,7 @@ private:
   void DoLoadState(PointerWrap& p);
 
   TexAddrCache textures_by_address;
+  TexRangeIndex textures_by_range;
   TexHashCache textures_by_hash;
   TexPool texture_pool;
   u64 last_entry_id = 0;
@@ -371,6 +389,8 @@ private:
     bool texfmt_overlay_center;
     bool hires_textures;
     bool cache_hires_textures;
+    bool cache_decoded_hires_textures;
+    bool dump_textures;
     bool copy_cache_enable;
     bool stereo_3d;
     bool efb_mono_depth;
@@ -400,6 +420,12 @@ private:
   // We store this in the class so that the same staging texture can be used for multiple
   // readbacks, saving the overhead of allocating a new buffer every time.
   std::unique_ptr<AbstractStagingTexture> m_readback_texture;
+
+  // Created when the first texture gets dumped.
+  std::unique_ptr<TextureDumper> m_texture_dumper;
+
+  // Created when the first large texture gets decoded on the CPU.
+  std::unique_ptr<Common::ThreadPool> m_decode_thread_pool;
 };
 
 extern std::unique_ptr<TextureCacheBase> g_texture_cache;
@@ -182,6 +182,13 @@ TextureFormat TexDecoder_GetEFBCopyBaseFormat(EFBCopyFormat format);
 
 void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFormat texformat,
                        const u8* tlut, TLUTFormat tlutfmt);
+// Decodes the texel rows [first_row, first_row + num_rows) of a texture, which lets a texture be
+// decoded in bands on several threads at once. first_row must be a multiple of the block height.
+// Once all bands are decoded, TexDecoder_FinishDecode has to be called on the whole texture.
+void TexDecoder_DecodeRows(u8* dst, const u8* src, int width, int height, int first_row,
+                           int num_rows, TextureFormat texformat, const u8* tlut,
+                           TLUTFormat tlutfmt);
+void TexDecoder_FinishDecode(u8* dst, int width, int height, TextureFormat texformat);
 void TexDecoder_DecodeRGBA8FromTmem(u8* dst, const u8* src_ar, const u8* src_gb, int width,
                                     int height);
 void TexDecoder_DecodeTexel(u8* dst, const u8* src, int s, int t, int imageWidth,
@@ -195,3 +202,17 @@ void TexDecoder_SetTexFmtOverlayOptions(bool enable, bool center);
 /* Internal method, implemented by TextureDecoder_Generic and TextureDecoder_x64. */
 void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
                             const u8* tlut, TLUTFormat tlutfmt);
+/* The reference implementation from TextureDecoder_Generic, which is built on every platform so
+   that the optimized decoders can be checked against it. */
+void _TexDecoder_DecodeImplGeneric(u32* dst, const u8* src, int width, int height,
+                                   TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt);
+#ifdef _M_X86
+/* The decoders of TextureDecoder_x64 limited to the given instruction set extensions.
+   _TexDecoder_DecodeImpl picks the best one the CPU supports. */
+void _TexDecoder_DecodeImplSSE2(u32* dst, const u8* src, int width, int height,
+                                TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt);
+void _TexDecoder_DecodeImplSSSE3(u32* dst, const u8* src, int width, int height,
+                                 TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt);
+void _TexDecoder_DecodeImplAVX2(u32* dst, const u8* src, int width, int height,
+                                TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt);
+#endif
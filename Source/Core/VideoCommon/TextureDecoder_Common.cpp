@@ -377,7 +377,22 @@ void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFor
                        const u8* tlut, TLUTFormat tlutfmt)
 {
   _TexDecoder_DecodeImpl((u32*)dst, src, width, height, texformat, tlut, tlutfmt);
+  TexDecoder_FinishDecode(dst, width, height, texformat);
+}
 
+void TexDecoder_DecodeRows(u8* dst, const u8* src, int width, int height, int first_row,
+                           int num_rows, TextureFormat texformat, const u8* tlut,
+                           TLUTFormat tlutfmt)
+{
+  // The blocks are stored row by row, so a band of block rows is laid out like a whole texture.
+  num_rows = std::min(num_rows, height - first_row);
+  _TexDecoder_DecodeImpl((u32*)dst + first_row * width,
+                         src + TexDecoder_GetTextureSizeInBytes(width, first_row, texformat), width,
+                         num_rows, texformat, tlut, tlutfmt);
+}
+
+void TexDecoder_FinishDecode(u8* dst, int width, int height, TextureFormat texformat)
+{
   if (TexFmt_Overlay_Enable)
     TexDecoder_DrawOverlay(dst, width, height, texformat);
 }
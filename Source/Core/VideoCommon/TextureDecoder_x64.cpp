@@ -165,6 +165,140 @@ static inline void DecodeBytes_IA4(u32* dst, const u8* src)
   }
 }
 
+// The AVX2 decoders below work on 8 texels at a time, one per 32-bit lane. The pixel decoders take
+// the 16-bit texel or palette entry in the low half of each lane.
+
+FUNCTION_TARGET_AVX2
+static inline __m256i Expand4To8_AVX2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(v, 4), v);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i Expand5To8_AVX2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(v, 3), _mm256_srli_epi32(v, 2));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i MakeRGBA_AVX2(__m256i r, __m256i g, __m256i b, __m256i a)
+{
+  return _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                         _mm256_or_si256(_mm256_slli_epi32(b, 16), _mm256_slli_epi32(a, 24)));
+}
+
+// Takes the 16-bit values as they are stored in memory.
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePixels_IA8_AVX2(__m256i val)
+{
+  // (0 0 i a) -> (a i i i)
+  const __m256i mask = _mm256_setr_epi8(1, 1, 1, 0, 5, 5, 5, 4, 9, 9, 9, 8, 13, 13, 13, 12, 1, 1, 1,
+                                        0, 5, 5, 5, 4, 9, 9, 9, 8, 13, 13, 13, 12);
+  return _mm256_shuffle_epi8(val, mask);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePixels_RGB565_AVX2(__m256i val)
+{
+  const __m256i mask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i g = _mm256_and_si256(_mm256_srli_epi32(val, 5), _mm256_set1_epi32(0x3f));
+  return MakeRGBA_AVX2(
+      Expand5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 11), mask_x1f)),
+      _mm256_or_si256(_mm256_slli_epi32(g, 2), _mm256_srli_epi32(g, 4)),
+      Expand5To8_AVX2(_mm256_and_si256(val, mask_x1f)), _mm256_set1_epi32(0xff));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePixels_RGB5A3_AVX2(__m256i val)
+{
+  // Decode every texel both ways, and pick the right one by the top bit.
+  const __m256i mask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i rgb555 =
+      MakeRGBA_AVX2(Expand5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 10), mask_x1f)),
+                    Expand5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 5), mask_x1f)),
+                    Expand5To8_AVX2(_mm256_and_si256(val, mask_x1f)), _mm256_set1_epi32(0xff));
+
+  const __m256i mask_x0f = _mm256_set1_epi32(0x0f);
+  const __m256i a = _mm256_and_si256(_mm256_srli_epi32(val, 12), _mm256_set1_epi32(0x07));
+  const __m256i rgb4443 = MakeRGBA_AVX2(
+      Expand4To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 8), mask_x0f)),
+      Expand4To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 4), mask_x0f)),
+      Expand4To8_AVX2(_mm256_and_si256(val, mask_x0f)),
+      _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(a, 5), _mm256_slli_epi32(a, 2)),
+                      _mm256_srli_epi32(a, 1)));
+
+  const __m256i is_rgb555 = _mm256_srai_epi32(_mm256_slli_epi32(val, 16), 31);
+  return _mm256_blendv_epi8(rgb4443, rgb555, is_rgb555);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i Swap16_AVX2(__m256i val)
+{
+  const __m256i mask = _mm256_setr_epi8(1, 0, -128, -128, 5, 4, -128, -128, 9, 8, -128, -128, 13,
+                                        12, -128, -128, 1, 0, -128, -128, 5, 4, -128, -128, 9, 8,
+                                        -128, -128, 13, 12, -128, -128);
+  return _mm256_shuffle_epi8(val, mask);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePaletteEntries_AVX2(const u8* tlut, __m256i indices,
+                                                TLUTFormat tlutfmt)
+{
+  // Gather the aligned pair of entries each index falls into and shift the right one down. That
+  // never reads past the last entry of a palette with an even number of entries, which they all
+  // have, while gathering 32 bits at the entry itself could.
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i pairs = _mm256_i32gather_epi32(reinterpret_cast<const int*>(tlut),
+                                               _mm256_andnot_si256(one, indices), 2);
+  const __m256i entries = _mm256_and_si256(
+      _mm256_srlv_epi32(pairs, _mm256_slli_epi32(_mm256_and_si256(indices, one), 4)),
+      _mm256_set1_epi32(0xffff));
+
+  switch (tlutfmt)
+  {
+  case TLUTFormat::IA8:
+    return DecodePixels_IA8_AVX2(entries);
+  case TLUTFormat::RGB565:
+    return DecodePixels_RGB565_AVX2(Swap16_AVX2(entries));
+  case TLUTFormat::RGB5A3:
+    return DecodePixels_RGB5A3_AVX2(Swap16_AVX2(entries));
+  default:
+    return _mm256_setzero_si256();
+  }
+}
+
+// For the formats with 4x4 blocks, the AVX2 decoders handle two horizontally adjacent blocks at
+// once, so that a row of texels from both can be written with one store. If the texture is an odd
+// number of blocks wide, the last one is decoded on its own and only half of each row is stored.
+FUNCTION_TARGET_AVX2
+static inline void StoreRow_AVX2(u32* dst, __m256i texels, bool both_blocks)
+{
+  if (both_blocks)
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), texels);
+  else
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(texels));
+}
+
+// Takes the big-endian 16-bit texels of the first or second row of a 4x4 block from each lane, and
+// puts them into the low halves of 32-bit lanes in native byte order.
+FUNCTION_TARGET_AVX2
+static inline __m256i SpreadRow16_AVX2(__m256i rows, bool second_row)
+{
+  const __m256i mask =
+      _mm256_setr_epi8(1, 0, -128, -128, 3, 2, -128, -128, 5, 4, -128, -128, 7, 6, -128, -128, 1,
+                       0, -128, -128, 3, 2, -128, -128, 5, 4, -128, -128, 7, 6, -128, -128);
+  return _mm256_shuffle_epi8(second_row ? _mm256_srli_si256(rows, 8) : rows, mask);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DXTBlend_AVX2(__m256i v1, __m256i v2)
+{
+  // 3/8 blend, which is close to 1/3
+  const __m256i v1_3 = _mm256_add_epi32(v1, _mm256_slli_epi32(v1, 1));
+  const __m256i v2_5 = _mm256_add_epi32(v2, _mm256_slli_epi32(v2, 2));
+  return _mm256_srli_epi32(_mm256_add_epi32(v1_3, v2_5), 3);
+}
+
 #ifdef CHECK
 static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
 {
@@ -525,6 +659,26 @@ static void TexDecoder_DecodeImpl_I8(u32* dst, const u8* src, int width, int hei
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C8_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
+      {
+        const __m256i indices =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + 8 * xStep)));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x),
+                            DecodePaletteEntries_AVX2(tlut, indices, tlutfmt));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_C8(u32* dst, const u8* src, int width, int height,
                                      TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                      int Wsteps4, int Wsteps8)
@@ -579,6 +733,36 @@ static void TexDecoder_DecodeImpl_IA4(u32* dst, const u8* src, int width, int he
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_IA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Expands the (a i) texels of the first row in each lane to (a i i i).
+  const __m256i mask = _mm256_setr_epi8(1, 1, 1, 0, 3, 3, 3, 2, 5, 5, 5, 4, 7, 7, 7, 6, 1, 1, 1, 0,
+                                        3, 3, 3, 2, 5, 5, 5, 4, 7, 7, 7, 6);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 8)
+    {
+      const bool both_blocks = x + 4 < width;
+      const u8* block = src + 32 * ((y / 4) * Wsteps4 + x / 4);
+      const __m256i left = _mm256_loadu_si256((const __m256i*)block);
+      const __m256i right = both_blocks ? _mm256_loadu_si256((const __m256i*)(block + 32)) : left;
+      const __m256i rows01 = _mm256_permute2x128_si256(left, right, 0x20);
+      const __m256i rows23 = _mm256_permute2x128_si256(left, right, 0x31);
+
+      u32* row = dst + y * width + x;
+      StoreRow_AVX2(row, _mm256_shuffle_epi8(rows01, mask), both_blocks);
+      StoreRow_AVX2(row + width, _mm256_shuffle_epi8(_mm256_srli_si256(rows01, 8), mask),
+                    both_blocks);
+      StoreRow_AVX2(row + 2 * width, _mm256_shuffle_epi8(rows23, mask), both_blocks);
+      StoreRow_AVX2(row + 3 * width, _mm256_shuffle_epi8(_mm256_srli_si256(rows23, 8), mask),
+                    both_blocks);
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_IA8_SSSE3(u32* dst, const u8* src, int width, int height,
                                             TextureFormat texformat, const u8* tlut,
@@ -665,6 +849,35 @@ static void TexDecoder_DecodeImpl_IA8(u32* dst, const u8* src, int width, int he
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C14X2_AVX2(u32* dst, const u8* src, int width, int height,
+                                             TextureFormat texformat, const u8* tlut,
+                                             TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m256i index_mask = _mm256_set1_epi32(0x3fff);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 8)
+    {
+      const bool both_blocks = x + 4 < width;
+      const u8* block = src + 32 * ((y / 4) * Wsteps4 + x / 4);
+      const __m256i left = _mm256_loadu_si256((const __m256i*)block);
+      const __m256i right = both_blocks ? _mm256_loadu_si256((const __m256i*)(block + 32)) : left;
+      const __m256i rows01 = _mm256_permute2x128_si256(left, right, 0x20);
+      const __m256i rows23 = _mm256_permute2x128_si256(left, right, 0x31);
+      const __m256i rows[4] = {SpreadRow16_AVX2(rows01, false), SpreadRow16_AVX2(rows01, true),
+                               SpreadRow16_AVX2(rows23, false), SpreadRow16_AVX2(rows23, true)};
+
+      for (int iy = 0; iy < 4; iy++)
+      {
+        const __m256i indices = _mm256_and_si256(rows[iy], index_mask);
+        StoreRow_AVX2(dst + (y + iy) * width + x,
+                      DecodePaletteEntries_AVX2(tlut, indices, tlutfmt), both_blocks);
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_C14X2(u32* dst, const u8* src, int width, int height,
                                         TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                         int Wsteps4, int Wsteps8)
@@ -774,6 +987,34 @@ static void TexDecoder_DecodeImpl_RGB565(u32* dst, const u8* src, int width, int
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB5A3_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 8)
+    {
+      const bool both_blocks = x + 4 < width;
+      const u8* block = src + 32 * ((y / 4) * Wsteps4 + x / 4);
+      const __m256i left = _mm256_loadu_si256((const __m256i*)block);
+      const __m256i right = both_blocks ? _mm256_loadu_si256((const __m256i*)(block + 32)) : left;
+      const __m256i rows01 = _mm256_permute2x128_si256(left, right, 0x20);
+      const __m256i rows23 = _mm256_permute2x128_si256(left, right, 0x31);
+
+      u32* row = dst + y * width + x;
+      StoreRow_AVX2(row, DecodePixels_RGB5A3_AVX2(SpreadRow16_AVX2(rows01, false)), both_blocks);
+      StoreRow_AVX2(row + width, DecodePixels_RGB5A3_AVX2(SpreadRow16_AVX2(rows01, true)),
+                    both_blocks);
+      StoreRow_AVX2(row + 2 * width, DecodePixels_RGB5A3_AVX2(SpreadRow16_AVX2(rows23, false)),
+                    both_blocks);
+      StoreRow_AVX2(row + 3 * width, DecodePixels_RGB5A3_AVX2(SpreadRow16_AVX2(rows23, true)),
+                    both_blocks);
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_RGB5A3_SSSE3(u32* dst, const u8* src, int width, int height,
                                                TextureFormat texformat, const u8* tlut,
@@ -1001,6 +1242,46 @@ static void TexDecoder_DecodeImpl_RGB5A3(u32* dst, const u8* src, int width, int
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGBA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                             TextureFormat texformat, const u8* tlut,
+                                             TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Like the SSSE3 version, but with both halves of a block in one register each. Interleaving
+  // them then gives rows 0 and 2 or rows 1 and 3 of the block.
+  const __m256i mask0312 = _mm256_setr_epi8(2, 1, 3, 0, 6, 5, 7, 4, 10, 9, 11, 8, 14, 13, 15, 12, 2,
+                                            1, 3, 0, 6, 5, 7, 4, 10, 9, 11, 8, 14, 13, 15, 12);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 8)
+    {
+      const bool both_blocks = x + 4 < width;
+      const u8* block = src + 64 * ((y / 4) * Wsteps4 + x / 4);
+      const __m256i left_ar = _mm256_loadu_si256((const __m256i*)block);
+      const __m256i left_gb = _mm256_loadu_si256((const __m256i*)block + 1);
+      const __m256i right_ar =
+          both_blocks ? _mm256_loadu_si256((const __m256i*)block + 2) : left_ar;
+      const __m256i right_gb =
+          both_blocks ? _mm256_loadu_si256((const __m256i*)block + 3) : left_gb;
+
+      const __m256i left02 = _mm256_shuffle_epi8(_mm256_unpacklo_epi8(left_ar, left_gb), mask0312);
+      const __m256i left13 = _mm256_shuffle_epi8(_mm256_unpackhi_epi8(left_ar, left_gb), mask0312);
+      const __m256i right02 =
+          _mm256_shuffle_epi8(_mm256_unpacklo_epi8(right_ar, right_gb), mask0312);
+      const __m256i right13 =
+          _mm256_shuffle_epi8(_mm256_unpackhi_epi8(right_ar, right_gb), mask0312);
+
+      u32* row = dst + y * width + x;
+      StoreRow_AVX2(row, _mm256_permute2x128_si256(left02, right02, 0x20), both_blocks);
+      StoreRow_AVX2(row + width, _mm256_permute2x128_si256(left13, right13, 0x20), both_blocks);
+      StoreRow_AVX2(row + 2 * width, _mm256_permute2x128_si256(left02, right02, 0x31),
+                    both_blocks);
+      StoreRow_AVX2(row + 3 * width, _mm256_permute2x128_si256(left13, right13, 0x31),
+                    both_blocks);
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_RGBA8_SSSE3(u32* dst, const u8* src, int width, int height,
                                               TextureFormat texformat, const u8* tlut,
@@ -1157,6 +1438,84 @@ static void TexDecoder_DecodeImpl_RGBA8(u32* dst, const u8* src, int width, int
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_CMPR_AVX2(u32* dst, const u8* src, int width, int height,
+                                            TextureFormat texformat, const u8* tlut,
+                                            TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Decodes all four DXT blocks of an 8x8 tile at once. The colors are worked out with the two
+  // colors of each block in neighbouring lanes, in the order the blocks are stored: top left, top
+  // right, bottom left, bottom right. Each row of texels is then looked up from the palettes of
+  // the left and right block with one permute.
+  const __m256i colors_mask =
+      _mm256_setr_epi8(1, 0, -128, -128, 3, 2, -128, -128, 9, 8, -128, -128, 11, 10, -128, -128,
+                       1, 0, -128, -128, 3, 2, -128, -128, 9, 8, -128, -128, 11, 10, -128, -128);
+  const __m256i mask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i opaque = _mm256_set1_epi32(0xff);
+  // The average of both colors is used for the third color as is, and for the fourth transparent.
+  const __m256i average_alpha = _mm256_setr_epi32(0xff, 0, 0xff, 0, 0xff, 0, 0xff, 0);
+  const __m256i top_lines = _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3);
+  const __m256i bottom_lines = _mm256_setr_epi32(5, 5, 5, 5, 7, 7, 7, 7);
+  const __m256i texel_shifts = _mm256_setr_epi32(6, 4, 2, 0, 6, 4, 2, 0);
+  const __m256i right_palette = _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4);
+
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      const __m256i tile = _mm256_loadu_si256((const __m256i*)(src + 32 * yStep));
+
+      const __m256i c = _mm256_shuffle_epi8(tile, colors_mask);
+      const __m256i g6 = _mm256_and_si256(_mm256_srli_epi32(c, 5), _mm256_set1_epi32(0x3f));
+      const __m256i r = Expand5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(c, 11), mask_x1f));
+      const __m256i g = _mm256_or_si256(_mm256_slli_epi32(g6, 2), _mm256_srli_epi32(g6, 4));
+      const __m256i b = Expand5To8_AVX2(_mm256_and_si256(c, mask_x1f));
+      const __m256i colors01 = MakeRGBA_AVX2(r, g, b, opaque);
+
+      // With the other color of the same block in each lane, blending towards the other color
+      // gives the third color in the lanes of the first color, and the fourth in the others.
+      const __m256i other_r = _mm256_shuffle_epi32(r, _MM_SHUFFLE(2, 3, 0, 1));
+      const __m256i other_g = _mm256_shuffle_epi32(g, _MM_SHUFFLE(2, 3, 0, 1));
+      const __m256i other_b = _mm256_shuffle_epi32(b, _MM_SHUFFLE(2, 3, 0, 1));
+      const __m256i blended = MakeRGBA_AVX2(DXTBlend_AVX2(other_r, r), DXTBlend_AVX2(other_g, g),
+                                            DXTBlend_AVX2(other_b, b), opaque);
+      const __m256i averaged = MakeRGBA_AVX2(_mm256_srli_epi32(_mm256_add_epi32(r, other_r), 1),
+                                             _mm256_srli_epi32(_mm256_add_epi32(g, other_g), 1),
+                                             _mm256_srli_epi32(_mm256_add_epi32(b, other_b), 1),
+                                             average_alpha);
+      const __m256i first_greater = _mm256_shuffle_epi32(
+          _mm256_cmpgt_epi32(c, _mm256_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1))),
+          _MM_SHUFFLE(2, 2, 0, 0));
+      const __m256i colors23 = _mm256_blendv_epi8(averaged, blended, first_greater);
+
+      // (bottom left, top left) and (bottom right, top right) palettes
+      const __m256i left_palettes = _mm256_unpacklo_epi64(colors01, colors23);
+      const __m256i right_palettes = _mm256_unpackhi_epi64(colors01, colors23);
+      const __m256i top_palettes = _mm256_permute2x128_si256(left_palettes, right_palettes, 0x20);
+      const __m256i bottom_palettes =
+          _mm256_permute2x128_si256(left_palettes, right_palettes, 0x31);
+
+      const __m256i top_selectors = _mm256_permutevar8x32_epi32(tile, top_lines);
+      const __m256i bottom_selectors = _mm256_permutevar8x32_epi32(tile, bottom_lines);
+      for (int iy = 0; iy < 4; iy++)
+      {
+        const __m256i shifts = _mm256_add_epi32(texel_shifts, _mm256_set1_epi32(8 * iy));
+        const __m256i top_indices = _mm256_or_si256(
+            _mm256_and_si256(_mm256_srlv_epi32(top_selectors, shifts), _mm256_set1_epi32(3)),
+            right_palette);
+        const __m256i bottom_indices = _mm256_or_si256(
+            _mm256_and_si256(_mm256_srlv_epi32(bottom_selectors, shifts), _mm256_set1_epi32(3)),
+            right_palette);
+
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x),
+                            _mm256_permutevar8x32_epi32(top_palettes, top_indices));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy + 4) * width + x),
+                            _mm256_permutevar8x32_epi32(bottom_palettes, bottom_indices));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int height,
                                        TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                        int Wsteps4, int Wsteps8)
@@ -1413,8 +1772,10 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
   }
 }
 
-void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
-                            const u8* tlut, TLUTFormat tlutfmt)
+// Only uses SSSE3 and AVX2 if told to, so that the tests can check every path on any CPU that
+// supports it.
+static void DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
+                       const u8* tlut, TLUTFormat tlutfmt, bool ssse3, bool avx2)
 {
   int Wsteps4 = (width + 3) / 4;
   int Wsteps8 = (width + 7) / 8;
@@ -1426,7 +1787,7 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::I4:
-    if (cpu_info.bSSSE3)
+    if (ssse3)
       TexDecoder_DecodeImpl_I4_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                      Wsteps8);
     else
@@ -1434,7 +1795,7 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::I8:
-    if (cpu_info.bSSSE3)
+    if (ssse3)
       TexDecoder_DecodeImpl_I8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                      Wsteps8);
     else
@@ -1442,7 +1803,11 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C8:
-    TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (avx2)
+      TexDecoder_DecodeImpl_C8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::IA4:
@@ -1450,7 +1815,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::IA8:
-    if (cpu_info.bSSSE3)
+    if (avx2)
+      TexDecoder_DecodeImpl_IA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else if (ssse3)
       TexDecoder_DecodeImpl_IA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                       Wsteps8);
     else
@@ -1459,8 +1827,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C14X2:
-    TexDecoder_DecodeImpl_C14X2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
-                                Wsteps8);
+    if (avx2)
+      TexDecoder_DecodeImpl_C14X2_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                       Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C14X2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                  Wsteps8);
     break;
 
   case TextureFormat::RGB565:
@@ -1469,7 +1841,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGB5A3:
-    if (cpu_info.bSSSE3)
+    if (avx2)
+      TexDecoder_DecodeImpl_RGB5A3_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else if (ssse3)
       TexDecoder_DecodeImpl_RGB5A3_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                          Wsteps8);
     else
@@ -1478,7 +1853,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGBA8:
-    if (cpu_info.bSSSE3)
+    if (avx2)
+      TexDecoder_DecodeImpl_RGBA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                       Wsteps8);
+    else if (ssse3)
       TexDecoder_DecodeImpl_RGBA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                         Wsteps8);
     else
@@ -1487,7 +1865,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::CMPR:
-    TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (avx2)
+      TexDecoder_DecodeImpl_CMPR_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                      Wsteps8);
+    else
+      TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                 Wsteps8);
     break;
 
   case TextureFormat::XFB:
@@ -1500,3 +1883,27 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
   }
 }
+
+void _TexDecoder_DecodeImplSSE2(u32* dst, const u8* src, int width, int height,
+                                TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt)
+{
+  DecodeImpl(dst, src, width, height, texformat, tlut, tlutfmt, false, false);
+}
+
+void _TexDecoder_DecodeImplSSSE3(u32* dst, const u8* src, int width, int height,
+                                 TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt)
+{
+  DecodeImpl(dst, src, width, height, texformat, tlut, tlutfmt, true, false);
+}
+
+void _TexDecoder_DecodeImplAVX2(u32* dst, const u8* src, int width, int height,
+                                TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt)
+{
+  DecodeImpl(dst, src, width, height, texformat, tlut, tlutfmt, true, true);
+}
+
+void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
+                            const u8* tlut, TLUTFormat tlutfmt)
+{
+  DecodeImpl(dst, src, width, height, texformat, tlut, tlutfmt, cpu_info.bSSSE3, cpu_info.bAVX2);
+}
@@ -0,0 +1,120 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/TextureDumper.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "Common/FileSearch.h"
+#include "Common/FileUtil.h"
+#include "Common/Image.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/ThreadPool.h"
+
+// The amount of image data that can wait for encoding before Dump blocks.
+constexpr size_t MAX_QUEUED_BYTES = 128 * 1024 * 1024;
+// The number of buffers that are kept around for reuse once their images have been saved.
+constexpr size_t MAX_FREE_BUFFERS = 16;
+
+TextureDumper::TextureDumper()
+    : m_thread_pool(std::make_unique<Common::ThreadPool>(
+          std::max<size_t>(Common::ThreadPool::GetDefaultThreadCount() / 2, 1), "TextureDumper"))
+{
+}
+
+TextureDumper::~TextureDumper() = default;
+
+void TextureDumper::SetDirectory(const std::string& directory)
+{
+  if (directory == m_directory)
+    return;
+
+  m_directory = directory;
+  m_dumped_textures.clear();
+
+  if (!File::IsDirectory(directory))
+  {
+    File::CreateDir(directory);
+    return;
+  }
+
+  for (const std::string& path : Common::DoFileSearch({directory}, {".png"}))
+  {
+    std::string basename;
+    SplitPath(path, nullptr, &basename, nullptr);
+    m_dumped_textures.emplace(std::move(basename));
+  }
+
+  INFO_LOG_FMT(VIDEO, "Found {} textures that were dumped before in {}", m_dumped_textures.size(),
+               directory);
+}
+
+bool TextureDumper::IsDumpNeeded(const std::string& directory, const std::string& basename)
+{
+  SetDirectory(directory);
+  return m_dumped_textures.find(basename) == m_dumped_textures.end();
+}
+
+void TextureDumper::Dump(const std::string& directory, std::string basename, u32 width, u32 height,
+                         const std::function<void(u8* pixels)>& write_pixels)
+{
+  SetDirectory(directory);
+  if (!m_dumped_textures.emplace(basename).second)
+    return;
+
+  const size_t size = static_cast<size_t>(width) * height * 4;
+  std::vector<u8> buffer = AllocateBuffer(size);
+  write_pixels(buffer.data());
+
+  m_thread_pool->Submit([this, buffer = std::move(buffer), size, width, height,
+                         path = fmt::format("{}/{}.png", directory, basename)]() mutable {
+    if (!Common::SavePNG(path, buffer.data(), Common::ImageByteFormat::RGBA, width, height,
+                         static_cast<int>(width * 4)))
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to dump texture to {}", path);
+    }
+    ReleaseBuffer(std::move(buffer), size);
+  });
+}
+
+void TextureDumper::Flush()
+{
+  m_thread_pool->WaitForCompletion();
+}
+
+std::vector<u8> TextureDumper::AllocateBuffer(size_t size)
+{
+  std::unique_lock lk(m_buffers_lock);
+
+  // A single image that is larger than the limit still gets queued once nothing else is.
+  m_buffer_released.wait(lk, [this, size] {
+    return m_queued_bytes == 0 || m_queued_bytes + size <= MAX_QUEUED_BYTES;
+  });
+  m_queued_bytes += size;
+
+  std::vector<u8> buffer;
+  if (!m_free_buffers.empty())
+  {
+    buffer = std::move(m_free_buffers.back());
+    m_free_buffers.pop_back();
+  }
+  lk.unlock();
+
+  buffer.resize(size);
+  return buffer;
+}
+
+void TextureDumper::ReleaseBuffer(std::vector<u8> buffer, size_t size)
+{
+  {
+    std::lock_guard lk(m_buffers_lock);
+    m_queued_bytes -= size;
+    if (m_free_buffers.size() < MAX_FREE_BUFFERS)
+      m_free_buffers.push_back(std::move(buffer));
+  }
+  m_buffer_released.notify_one();
+}
@@ -0,0 +1,63 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+class ThreadPool;
+}
+
+// Saves dumped textures as PNG files. The images are copied into a bounded set of buffers and
+// encoded on worker threads, so that dumping barely slows down the video thread.
+// Which textures already have a file is looked up in a set that gets built by scanning the dump
+// directory once, instead of checking the disk for every texture.
+class TextureDumper final
+{
+public:
+  TextureDumper();
+  ~TextureDumper();
+
+  TextureDumper(const TextureDumper&) = delete;
+  TextureDumper& operator=(const TextureDumper&) = delete;
+
+  // Returns whether a texture with the given name (without the extension) has neither been dumped
+  // to the given directory before nor is queued to be.
+  bool IsDumpNeeded(const std::string& directory, const std::string& basename);
+
+  // Queues an RGBA8 image for saving. write_pixels is called before this returns, and has to fill
+  // in the pixels with a stride of width * 4 bytes. Blocks while too much data is queued already.
+  void Dump(const std::string& directory, std::string basename, u32 width, u32 height,
+            const std::function<void(u8* pixels)>& write_pixels);
+
+  // Blocks until every queued image has been saved.
+  void Flush();
+
+private:
+  void SetDirectory(const std::string& directory);
+
+  std::vector<u8> AllocateBuffer(size_t size);
+  void ReleaseBuffer(std::vector<u8> buffer, size_t size);
+
+  // Only accessed by the video thread.
+  std::string m_directory;
+  std::unordered_set<std::string> m_dumped_textures;
+
+  std::mutex m_buffers_lock;
+  std::condition_variable m_buffer_released;
+  std::vector<std::vector<u8>> m_free_buffers;
+  size_t m_queued_bytes = 0;
+
+  // Declared last, so that the queued images are saved before anything else is destroyed.
+  std::unique_ptr<Common::ThreadPool> m_thread_pool;
+};
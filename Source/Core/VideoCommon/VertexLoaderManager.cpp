@@ -4,24 +4,35 @@
 #include "VideoCommon/VertexLoaderManager.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/EnumMap.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Common/Logging/Log.h"
+#include "Common/SPSCQueue.h"
+#include "Common/Swap.h"
+#include "Common/Thread.h"
 
 #include "Core/DolphinAnalytics.h"
 #include "Core/HW/Memmap.h"
+#include "Core/System.h"
 
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/DisplayListVertexCache.h"
+#include "VideoCommon/Fifo.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
 #include "VideoCommon/RenderBase.h"
@@ -29,6 +40,7 @@
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
 namespace VertexLoaderManager
@@ -47,6 +59,8 @@ u32 g_current_components;
 typedef std::unordered_map<VertexLoaderUID, std::unique_ptr<VertexLoaderBase>> VertexLoaderMap;
 static std::mutex s_vertex_loader_map_lock;
 static VertexLoaderMap s_vertex_loader_map;
+// Refers to the loaders, so it has to be cleared along with them.
+static DisplayListVertexCache s_display_list_vertex_cache;
 // TODO - change into array of pointers. Keep a map of all seen so far.
 
 Common::EnumMap<u8*, CPArray::TexCoord7> cached_arraybases;
@@ -58,6 +72,133 @@ u8 g_current_vat;    // Main only
 std::array<VertexLoaderBase*, CP_NUM_VAT_REG> g_main_vertex_loaders;
 std::array<VertexLoaderBase*, CP_NUM_VAT_REG> g_preprocess_vertex_loaders;
 
+namespace
+{
+// Vertices that the video thread reserved space for, for the vertex loader thread to convert.
+struct VertexLoaderJob
+{
+  VertexLoaderBase* loader = nullptr;
+  DataReader src;
+  DataReader dst;
+  int count = 0;
+  int loaded_count = 0;
+  std::optional<u32> src_address;
+  // The queue needs to assign jobs, which TVtxDesc and VAT can't be.
+  std::array<u32, 2> vtx_desc;
+  std::array<u32, 3> vtx_attr;
+};
+}  // namespace
+
+static Common::SPSCQueue<VertexLoaderJob, false> s_vertex_loader_jobs;
+static std::atomic<u32> s_pending_vertex_loader_jobs{0};
+static Common::Event s_vertex_loader_jobs_pushed;
+static Common::Event s_vertex_loader_jobs_done;
+static Common::Flag s_vertex_loader_thread_exit;
+static std::thread s_vertex_loader_thread;
+
+static int LoadVertices(VertexLoaderBase* loader, DataReader src, DataReader dst, int count,
+                        std::optional<u32> src_address, const TVtxDesc& vtx_desc,
+                        const VAT& vtx_attr)
+{
+  ScopedStatTimer timer(g_stats.vertex_loading_ns);
+
+  if (src_address)
+  {
+    const std::optional<int> cached_count = s_display_list_vertex_cache.Load(
+        *src_address, loader, src.GetPointer(), count, dst.GetPointer());
+    if (cached_count)
+      return *cached_count;
+  }
+
+  const int loaded_count = loader->RunVertices(src, dst, count);
+  if (src_address)
+  {
+    s_display_list_vertex_cache.Store(*src_address, loader, vtx_desc, vtx_attr, src.GetPointer(),
+                                      count, dst.GetPointer(), loaded_count);
+  }
+  return loaded_count;
+}
+
+// The loaders skip vertices whose position index has all bits set. The indices for the vertices
+// are generated before the vertex loader thread converts them, so they have to be counted here.
+static int CountLoadedVertices(const u8* src, int count, u32 vertex_size)
+{
+  const TVtxDesc& vtx_desc = g_main_cp_state.vtx_desc;
+  if (!IsIndexed(vtx_desc.low.Position))
+    return count;
+
+  u32 offset = vtx_desc.low.PosMatIdx ? 1 : 0;
+  for (auto texmtxidx : vtx_desc.low.TexMatIdx)
+  {
+    if (texmtxidx)
+      offset++;
+  }
+
+  int loaded_count = count;
+  const bool index8 = vtx_desc.low.Position == VertexComponentFormat::Index8;
+  for (const u8* index = src + offset; index < src + count * vertex_size; index += vertex_size)
+  {
+    if (index8 ? *index == 0xff : Common::swap16(index) == 0xffff)
+      loaded_count--;
+  }
+  return loaded_count;
+}
+
+static void VertexLoaderThreadFunc()
+{
+  Common::SetCurrentThreadName("Vertex loader thread");
+
+  while (true)
+  {
+    s_vertex_loader_jobs_pushed.Wait();
+
+    VertexLoaderJob job;
+    while (s_vertex_loader_jobs.Pop(job))
+    {
+      TVtxDesc vtx_desc;
+      vtx_desc.low.Hex = job.vtx_desc[0];
+      vtx_desc.high.Hex = job.vtx_desc[1];
+      VAT vtx_attr;
+      vtx_attr.g0.Hex = job.vtx_attr[0];
+      vtx_attr.g1.Hex = job.vtx_attr[1];
+      vtx_attr.g2.Hex = job.vtx_attr[2];
+
+      const int loaded_count = LoadVertices(job.loader, job.src, job.dst, job.count,
+                                            job.src_address, vtx_desc, vtx_attr);
+      DEBUG_ASSERT(loaded_count == job.loaded_count);
+
+      if (s_pending_vertex_loader_jobs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        s_vertex_loader_jobs_done.Set();
+    }
+
+    if (s_vertex_loader_thread_exit.IsSet())
+      return;
+  }
+}
+
+static void StartVertexLoaderThread()
+{
+  s_vertex_loader_thread_exit.Clear();
+  s_vertex_loader_thread = std::thread(VertexLoaderThreadFunc);
+}
+
+static void StopVertexLoaderThread()
+{
+  if (!s_vertex_loader_thread.joinable())
+    return;
+
+  WaitForVertexLoaderThread();
+  s_vertex_loader_thread_exit.Set();
+  s_vertex_loader_jobs_pushed.Set();
+  s_vertex_loader_thread.join();
+}
+
+void WaitForVertexLoaderThread()
+{
+  while (s_pending_vertex_loader_jobs.load(std::memory_order_acquire) != 0)
+    s_vertex_loader_jobs_done.Wait();
+}
+
 void Init()
 {
   MarkAllDirty();
@@ -70,9 +211,12 @@ void Init()
 
 void Clear()
 {
+  StopVertexLoaderThread();
+
   std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
   s_vertex_loader_map.clear();
   s_native_vertex_map.clear();
+  s_display_list_vertex_cache.Clear();
 }
 
 void UpdateVertexArrayPointers()
@@ -87,26 +231,34 @@ void UpdateVertexArrayPointers()
   // Note: Only array bases 0 through 11 are used by the Vertex loaders.
   //       12 through 15 are used for loading data into xfmem.
   // We also only update the array base if the vertex description states we are going to use it.
+
+  // The vertex loader thread may still be reading the pointers, so it has to be waited for if
+  // any of them change.
+  const auto update_array_base = [](CPArray array) {
+    u8* const base = Memory::GetPointer(g_main_cp_state.array_bases[array]);
+    if (cached_arraybases[array] != base)
+    {
+      WaitForVertexLoaderThread();
+      cached_arraybases[array] = base;
+    }
+  };
+
   if (IsIndexed(g_main_cp_state.vtx_desc.low.Position))
-    cached_arraybases[CPArray::Position] =
-        Memory::GetPointer(g_main_cp_state.array_bases[CPArray::Position]);
+    update_array_base(CPArray::Position);
 
   if (IsIndexed(g_main_cp_state.vtx_desc.low.Normal))
-    cached_arraybases[CPArray::Normal] =
-        Memory::GetPointer(g_main_cp_state.array_bases[CPArray::Normal]);
+    update_array_base(CPArray::Normal);
 
   for (u8 i = 0; i < g_main_cp_state.vtx_desc.low.Color.Size(); i++)
   {
     if (IsIndexed(g_main_cp_state.vtx_desc.low.Color[i]))
-      cached_arraybases[CPArray::Color0 + i] =
-          Memory::GetPointer(g_main_cp_state.array_bases[CPArray::Color0 + i]);
+      update_array_base(CPArray::Color0 + i);
   }
 
   for (u8 i = 0; i < g_main_cp_state.vtx_desc.high.TexCoord.Size(); i++)
   {
     if (IsIndexed(g_main_cp_state.vtx_desc.high.TexCoord[i]))
-      cached_arraybases[CPArray::TexCoord0 + i] =
-          Memory::GetPointer(g_main_cp_state.array_bases[CPArray::TexCoord0 + i]);
+      update_array_base(CPArray::TexCoord0 + i);
   }
 
   g_bases_dirty = false;
@@ -336,7 +488,7 @@ static void CheckCPConfiguration(int vtx_attr_group)
 }
 
 int RunVertices(int vtx_attr_group, OpcodeDecoder::Primitive primitive, int count, DataReader src,
-                bool is_preprocess)
+                bool is_preprocess, std::optional<u32> src_address)
 {
   if (count == 0)
     return 0;
@@ -372,7 +524,34 @@ int RunVertices(int vtx_attr_group, OpcodeDecoder::Primitive primitive, int coun
   DataReader dst = g_vertex_manager->PrepareForAdditionalData(
       primitive, count, loader->m_native_vtx_decl.stride, cullall);
 
-  count = loader->RunVertices(src, dst, count);
+  // In single core and deterministic dual core, the CPU thread may overwrite the vertices as soon
+  // as the commands they are in are decoded, so they can't be left for another thread.
+  if (g_ActiveConfig.bThreadedVertexLoading && Core::System::GetInstance().IsDualCoreMode() &&
+      !Fifo::UseDeterministicGPUThread())
+  {
+    if (!s_vertex_loader_thread.joinable())
+      StartVertexLoaderThread();
+
+    const VAT& vtx_attr = g_main_cp_state.vtx_attr[vtx_attr_group];
+    VertexLoaderJob job{loader,
+                        src,
+                        dst,
+                        count,
+                        CountLoadedVertices(src.GetPointer(), count, loader->m_vertex_size),
+                        src_address,
+                        {g_main_cp_state.vtx_desc.low.Hex, g_main_cp_state.vtx_desc.high.Hex},
+                        {vtx_attr.g0.Hex, vtx_attr.g1.Hex, vtx_attr.g2.Hex}};
+    count = job.loaded_count;
+    s_pending_vertex_loader_jobs.fetch_add(1, std::memory_order_relaxed);
+    s_vertex_loader_jobs.Push(std::move(job));
+    s_vertex_loader_jobs_pushed.Set();
+  }
+  else
+  {
+    WaitForVertexLoaderThread();
+    count = LoadVertices(loader, src, dst, count, src_address, g_main_cp_state.vtx_desc,
+                         g_main_cp_state.vtx_attr[vtx_attr_group]);
+  }
 
   g_vertex_manager->AddIndices(primitive, count);
   g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
@@ -5,6 +5,7 @@
 
 #include <array>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
@@ -41,9 +42,17 @@ NativeVertexFormat* GetOrCreateMatchingFormat(const PortableVertexDeclaration& d
 // offsets set to the unused attributes.
 NativeVertexFormat* GetUberVertexFormat(const PortableVertexDeclaration& decl);
 
-// Returns -1 if buf_size is insufficient, else the amount of bytes consumed
+// Returns -1 if buf_size is insufficient, else the amount of bytes consumed.
+// src_address is where the vertices are in emulated memory if they are part of a display list,
+// in which case the converted vertices are cached.
 int RunVertices(int vtx_attr_group, OpcodeDecoder::Primitive primitive, int count, DataReader src,
-                bool is_preprocess);
+                bool is_preprocess, std::optional<u32> src_address = std::nullopt);
+
+// With threaded vertex loading, RunVertices only reserves space for the vertices and leaves
+// converting them to the vertex loader thread. This waits until all vertices passed to
+// RunVertices so far are converted. It must be called before anything reads the converted
+// vertices or the loader caches, and before anything the loaders read is changed.
+void WaitForVertexLoaderThread();
 
 NativeVertexFormat* GetCurrentVertexFormat();
 
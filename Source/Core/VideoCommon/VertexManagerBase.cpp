@@ -359,6 +359,9 @@ void VertexManagerBase::Flush()
 
   m_is_flushed = true;
 
+  // The vertices and the zfreeze and emboss caches may still be being written.
+  VertexLoaderManager::WaitForVertexLoaderThread();
+
   if (xfmem.numTexGen.numTexGens != bpmem.genMode.numtexgens ||
       xfmem.numChan.numColorChans != bpmem.genMode.numcolchans)
   {
@@ -100,6 +100,7 @@ struct VideoConfig final
   bool bDumpBaseTextures = false;
   bool bHiresTextures = false;
   bool bCacheHiresTextures = false;
+  bool bCacheDecodedHiresTextures = false;
   bool bDumpEFBTarget = false;
   bool bDumpXFBTarget = false;
   bool bDumpFramesAsImages = false;
@@ -161,6 +162,8 @@ struct VideoConfig final
   bool bDumpObjects = false;
   bool bDumpTevStages = false;
   bool bDumpTevTextureFetches = false;
+  // 0 picks a number based on the CPU, 1 draws on the video thread only.
+  int iSWRasterizerThreads = 0;
 
   // Enable API validation layers, currently only supported with Vulkan.
   bool bEnableValidationLayer = false;
@@ -176,6 +179,10 @@ struct VideoConfig final
   // Currently only supported with Vulkan.
   int iCommandBufferExecuteInterval = 0;
 
+  // Converts vertices on a thread of its own while the video thread decodes further commands.
+  // Only used with dual core and without deterministic dual core.
+  bool bThreadedVertexLoading = false;
+
   // Shader compilation settings.
   bool bWaitForShadersBeforeStarting = false;
   ShaderCompilationMode iShaderCompilationMode{};
@@ -18,12 +18,17 @@
 #include "VideoCommon/TMEM.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/XFMemory.h"
 
 void VideoCommon_DoState(PointerWrap& p)
 {
+  // Vertices still being converted are read from the FIFO buffer and RAM, which a loaded state
+  // overwrites.
+  VertexLoaderManager::WaitForVertexLoaderThread();
+
   bool software = false;
   p.Do(software);
 
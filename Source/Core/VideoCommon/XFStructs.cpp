@@ -14,14 +14,58 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/GeometryShaderManager.h"
+#include "VideoCommon/NativeVertexFormat.h"
 #include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/XFMemory.h"
 
+static bool RangesOverlap(u32 start, u32 end, u32 other_start, u32 other_size)
+{
+  return start < other_start + other_size && end > other_start;
+}
+
+// Whether the vertices that haven't been drawn yet read anything in [start, end) of XF memory.
+// Unless the vertices have matrix indices of their own, they only read the position, normal and
+// texture matrices that MATINDEX_A and MATINDEX_B select, so the rest of those can be changed
+// without drawing them first. Games often load the matrices for the next object before drawing
+// the current one.
+static bool IsUsedByPendingVertices(u32 start, u32 end)
+{
+  if (VertexLoaderManager::g_current_components & (VB_HAS_POSMTXIDX | VB_HAS_TEXMTXIDXALL))
+    return true;
+
+  const TMatrixIndexA& index_a = g_main_cp_state.matrix_index_a;
+  const TMatrixIndexB& index_b = g_main_cp_state.matrix_index_b;
+  if (end <= XFMEM_POSMATRICES_END)
+  {
+    for (const u32 index : {index_a.PosNormalMtxIdx.Value(), index_a.Tex0MtxIdx.Value(),
+                            index_a.Tex1MtxIdx.Value(), index_a.Tex2MtxIdx.Value(),
+                            index_a.Tex3MtxIdx.Value(), index_b.Tex4MtxIdx.Value(),
+                            index_b.Tex5MtxIdx.Value(), index_b.Tex6MtxIdx.Value(),
+                            index_b.Tex7MtxIdx.Value()})
+    {
+      if (RangesOverlap(start, end, XFMEM_POSMATRICES + index * 4, 12))
+        return true;
+    }
+    return false;
+  }
+
+  if (start >= XFMEM_NORMALMATRICES && end <= XFMEM_NORMALMATRICES_END)
+  {
+    return RangesOverlap(start, end,
+                         XFMEM_NORMALMATRICES + (index_a.PosNormalMtxIdx & 31) * 3, 9);
+  }
+
+  // The post-transform matrices and the lights aren't worth tracking.
+  return true;
+}
+
 static void XFMemWritten(u32 transferSize, u32 baseAddress)
 {
-  g_vertex_manager->Flush();
+  if (IsUsedByPendingVertices(baseAddress, baseAddress + transferSize))
+    g_vertex_manager->Flush();
   VertexShaderManager::InvalidateXFRange(baseAddress, baseAddress + transferSize);
 }
 
@@ -222,12 +266,19 @@ void LoadXFReg(u16 base_address, u8 transfer_size, const u8* data)
       base_address = XFMEM_REGISTERS_START;
     }
 
-    XFMemWritten(xf_mem_transfer_size, xf_mem_base);
+    // Games often load matrices again with the values they already have, which needs no flush.
+    u32* const xf_mem = (u32*)&xfmem + xf_mem_base;
     for (u32 i = 0; i < xf_mem_transfer_size; i++)
     {
-      ((u32*)&xfmem)[xf_mem_base + i] = Common::swap32(data);
-      data += 4;
+      if (xf_mem[i] != Common::swap32(data + i * 4))
+      {
+        XFMemWritten(xf_mem_transfer_size, xf_mem_base);
+        for (u32 j = i; j < xf_mem_transfer_size; j++)
+          xf_mem[j] = Common::swap32(data + j * 4);
+        break;
+      }
     }
+    data += xf_mem_transfer_size * 4;
   }
 
   // write to XF regs
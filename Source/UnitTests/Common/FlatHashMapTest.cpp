@@ -0,0 +1,77 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FlatHashMap.h"
+
+TEST(FlatHashMap, Simple)
+{
+  Common::FlatHashMap<u32, int> map;
+  EXPECT_TRUE(map.IsEmpty());
+  EXPECT_EQ(nullptr, map.Find(0));
+
+  map[0] = 1;
+  map[0x80000000] = 2;
+  map[0x80000020] = 3;
+  EXPECT_EQ(3u, map.Size());
+  ASSERT_NE(nullptr, map.Find(0));
+  EXPECT_EQ(1, *map.Find(0));
+  EXPECT_EQ(2, *map.Find(0x80000000));
+  EXPECT_EQ(3, *map.Find(0x80000020));
+  EXPECT_EQ(nullptr, map.Find(0x80000040));
+
+  EXPECT_TRUE(map.Erase(0x80000000));
+  EXPECT_FALSE(map.Erase(0x80000000));
+  EXPECT_EQ(nullptr, map.Find(0x80000000));
+  EXPECT_EQ(3, *map.Find(0x80000020));
+  EXPECT_EQ(2u, map.Size());
+
+  map.Clear();
+  EXPECT_TRUE(map.IsEmpty());
+  EXPECT_EQ(nullptr, map.Find(0));
+}
+
+// Compares a long series of random insertions and erasures against std::map. The keys are
+// restricted to a small range so that there are lots of collisions and entries to shift back.
+TEST(FlatHashMap, MatchesStdMap)
+{
+  Common::FlatHashMap<u32, std::vector<u32>> map;
+  std::map<u32, std::vector<u32>> reference;
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<u32> key_distribution(0, 2047);
+  for (u32 i = 0; i < 100000; ++i)
+  {
+    const u32 key = key_distribution(rng) * 32;
+    if (rng() % 3 == 0)
+    {
+      EXPECT_EQ(reference.erase(key) != 0, map.Erase(key));
+    }
+    else
+    {
+      map[key].push_back(i);
+      reference[key].push_back(i);
+    }
+  }
+
+  EXPECT_EQ(reference.size(), map.Size());
+  for (const auto& [key, value] : reference)
+  {
+    const std::vector<u32>* found = map.Find(key);
+    ASSERT_NE(nullptr, found);
+    EXPECT_EQ(value, *found);
+  }
+
+  size_t count = 0;
+  map.ForEach([&](u32 key, const std::vector<u32>& value) {
+    ++count;
+    EXPECT_EQ(reference[key], value);
+  });
+  EXPECT_EQ(reference.size(), count);
+}
@@ -0,0 +1,123 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+
+static std::vector<u8> RandomBytes(size_t size, u32 seed)
+{
+  std::mt19937 rng(seed);
+  std::vector<u8> data(size);
+  for (u8& byte : data)
+    byte = static_cast<u8>(rng());
+  return data;
+}
+
+// Covers short inputs, partial stripes and multiple scrambled blocks.
+static const size_t TEST_SIZES[] = {0, 1, 7, 63, 64, 65, 1023, 1024, 1025, 4096, 100000};
+
+static u64 HashInPieces(Common::AccumulateStripesFunction accumulate_stripes,
+                        const std::vector<u8>& data)
+{
+  Common::StreamingHash64 hash(accumulate_stripes);
+  std::mt19937 rng(static_cast<u32>(data.size()));
+  size_t offset = 0;
+  while (offset < data.size())
+  {
+    const size_t length = std::min<size_t>(rng() % 300, data.size() - offset);
+    hash.Update(data.data() + offset, length);
+    offset += length;
+  }
+  return hash.Digest();
+}
+
+// Each implementation is compared directly, so that the ones SetHash64Function doesn't pick on this
+// CPU are tested too.
+TEST(Hash, MatchesGeneric)
+{
+  for (size_t size : TEST_SIZES)
+  {
+    const std::vector<u8> data = RandomBytes(size, static_cast<u32>(size));
+    const u64 expected = HashInPieces(&Common::AccumulateStripesGeneric, data);
+
+#if defined(_M_X86_64)
+    EXPECT_EQ(expected, HashInPieces(&Common::AccumulateStripesSSE2, data)) << size;
+    if (cpu_info.bAVX2)
+    {
+      EXPECT_EQ(expected, HashInPieces(&Common::AccumulateStripesAVX2, data)) << size;
+    }
+#elif defined(_M_ARM_64)
+    EXPECT_EQ(expected, HashInPieces(&Common::AccumulateStripesNEON, data)) << size;
+#endif
+
+    Common::SetHash64Function();
+    EXPECT_EQ(expected, Common::GetFullHash64(data.data(), data.size())) << size;
+  }
+}
+
+TEST(Hash, StreamingMatchesOneShot)
+{
+  Common::SetHash64Function();
+
+  const std::vector<u8> data = RandomBytes(10000, 1);
+  const u64 expected = Common::GetFullHash64(data.data(), data.size());
+  EXPECT_EQ(expected, Common::GetHash64(data.data(), static_cast<u32>(data.size()), 0));
+
+  std::mt19937 rng(2);
+  for (int i = 0; i < 100; ++i)
+  {
+    Common::StreamingHash64 hash;
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+      const size_t length = std::min<size_t>(rng() % 300, data.size() - offset);
+      hash.Update(data.data() + offset, length);
+      offset += length;
+    }
+    EXPECT_EQ(expected, hash.Digest());
+  }
+}
+
+TEST(Hash, IndependentOfAlignment)
+{
+  Common::SetHash64Function();
+
+  const std::vector<u8> data = RandomBytes(3000, 3);
+  const u64 expected = Common::GetFullHash64(data.data(), data.size());
+  for (size_t misalignment = 1; misalignment < 32; ++misalignment)
+  {
+    std::vector<u8> shifted(misalignment);
+    shifted.insert(shifted.end(), data.begin(), data.end());
+    EXPECT_EQ(expected, Common::GetFullHash64(shifted.data() + misalignment, data.size()));
+  }
+}
+
+// Every byte must affect the hash, unlike with sampling.
+TEST(Hash, EveryBitChangesHash)
+{
+  Common::SetHash64Function();
+
+  std::vector<u8> data = RandomBytes(2048, 4);
+  std::set<u64> hashes{Common::GetFullHash64(data.data(), data.size())};
+  for (size_t bit = 0; bit < data.size() * 8; bit += 7)
+  {
+    data[bit / 8] ^= 1 << (bit % 8);
+    EXPECT_TRUE(hashes.insert(Common::GetFullHash64(data.data(), data.size())).second) << bit;
+    data[bit / 8] ^= 1 << (bit % 8);
+  }
+
+  // Zero padding of the last stripe must not make different lengths collide.
+  const std::vector<u8> zeroes(64);
+  std::set<u64> zero_hashes;
+  for (size_t size = 0; size <= zeroes.size(); ++size)
+    EXPECT_TRUE(zero_hashes.insert(Common::GetFullHash64(zeroes.data(), size)).second) << size;
+}
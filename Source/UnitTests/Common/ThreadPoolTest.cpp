@@ -0,0 +1,50 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/ThreadPool.h"
+
+TEST(ThreadPool, SubmitAndWait)
+{
+  Common::ThreadPool pool(4);
+  EXPECT_EQ(4u, pool.GetThreadCount());
+
+  std::atomic<u32> counter = 0;
+  for (u32 i = 0; i < 1000; ++i)
+    pool.Submit([&counter] { ++counter; });
+
+  pool.WaitForCompletion();
+  EXPECT_EQ(1000u, counter.load());
+}
+
+TEST(ThreadPool, ParallelForVisitsEveryIndexOnce)
+{
+  Common::ThreadPool pool(3);
+
+  std::vector<std::atomic<u32>> visits(10000);
+  pool.ParallelFor(visits.size(), [&visits](size_t i) { ++visits[i]; });
+
+  for (const std::atomic<u32>& count : visits)
+    EXPECT_EQ(1u, count.load());
+}
+
+TEST(ThreadPool, ParallelForFromWorker)
+{
+  Common::ThreadPool pool(2);
+
+  std::atomic<u32> counter = 0;
+  for (u32 i = 0; i < 8; ++i)
+  {
+    pool.Submit([&pool, &counter] {
+      pool.ParallelFor(100, [&counter](size_t) { ++counter; });
+    });
+  }
+
+  pool.WaitForCompletion();
+  EXPECT_EQ(800u, counter.load());
+}
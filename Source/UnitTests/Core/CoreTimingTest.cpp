@@ -5,8 +5,11 @@
 
 #include <array>
 #include <bitset>
+#include <chrono>
 #include <string>
 
+#include <fmt/format.h>
+
 #include "Common/Config/Config.h"
 #include "Common/FileUtil.h"
 #include "Core/Config/MainSettings.h"
@@ -362,3 +365,135 @@ TEST(CoreTiming, Overclocking)
   Config::SetCurrent(Config::MAIN_OVERCLOCK, 1.0f);
   AdvanceAndCheck(4, MAX_SLICE_LENGTH);
 }
+
+TEST(CoreTiming, RemoveByHandle)
+{
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", CallbackTemplate<0>);
+  CoreTiming::EventType* cb_b = CoreTiming::RegisterEvent("callbackB", CallbackTemplate<1>);
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  const CoreTiming::EventHandle removed = CoreTiming::ScheduleEvent(100, cb_a, CB_IDS[0]);
+  CoreTiming::ScheduleEvent(200, cb_b, CB_IDS[1]);
+  CoreTiming::RemoveEvent(removed);
+
+  // This event may reuse the storage of the removed one, which must not make the stale handle
+  // refer to it.
+  CoreTiming::ScheduleEvent(300, cb_a, CB_IDS[0]);
+  CoreTiming::RemoveEvent(removed);
+
+  s_callbacks_ran_flags = 0;
+  PowerPC::ppcState.downcount = 0;
+  CoreTiming::Advance();
+  EXPECT_EQ(0u, s_callbacks_ran_flags.to_ulong());
+  EXPECT_EQ(100, PowerPC::ppcState.downcount);
+
+  AdvanceAndCheck(1, 100);
+  AdvanceAndCheck(0, MAX_SLICE_LENGTH);
+}
+
+// Events that are far apart are stored in different levels of the timing wheel (or beyond it),
+// and have to be moved between them as time passes.
+TEST(CoreTiming, DistantEvents)
+{
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", CallbackTemplate<0>);
+  CoreTiming::EventType* cb_b = CoreTiming::RegisterEvent("callbackB", CallbackTemplate<1>);
+  CoreTiming::EventType* cb_c = CoreTiming::RegisterEvent("callbackC", CallbackTemplate<2>);
+  CoreTiming::EventType* cb_d = CoreTiming::RegisterEvent("callbackD", CallbackTemplate<3>);
+  CoreTiming::EventType* cb_e = CoreTiming::RegisterEvent("callbackE", CallbackTemplate<4>);
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  constexpr s64 TIME_C = s64{1} << 20;
+  constexpr s64 TIME_D = s64{1} << 28;
+  constexpr s64 TIME_E = s64{1} << 40;
+  CoreTiming::ScheduleEvent(TIME_E, cb_e, CB_IDS[4]);
+  CoreTiming::ScheduleEvent(TIME_D, cb_d, CB_IDS[3]);
+  CoreTiming::ScheduleEvent(TIME_C, cb_c, CB_IDS[2]);
+  CoreTiming::ScheduleEvent(5000, cb_b, CB_IDS[1]);
+  CoreTiming::ScheduleEvent(100, cb_a, CB_IDS[0]);
+  EXPECT_EQ(100, PowerPC::ppcState.downcount);
+
+  AdvanceAndCheck(0, 4900);
+  AdvanceAndCheck(1, MAX_SLICE_LENGTH);
+
+  // Skip ahead so that each event is due at the end of the next slice.
+  CoreTiming::g.global_timer = TIME_C - MAX_SLICE_LENGTH;
+  AdvanceAndCheck(2, MAX_SLICE_LENGTH);
+  CoreTiming::g.global_timer = TIME_D - MAX_SLICE_LENGTH;
+  AdvanceAndCheck(3, MAX_SLICE_LENGTH);
+  CoreTiming::g.global_timer = TIME_E - MAX_SLICE_LENGTH;
+  AdvanceAndCheck(4, MAX_SLICE_LENGTH);
+}
+
+namespace SchedulingThroughputTest
+{
+constexpr size_t NUM_DEVICES = 32;
+static std::array<CoreTiming::EventType*, NUM_DEVICES> s_periodic_events;
+static std::array<CoreTiming::EventType*, NUM_DEVICES> s_timeout_events;
+static u64 s_callback_count = 0;
+
+static void PeriodicCallback(u64 userdata, s64 lateness)
+{
+  ++s_callback_count;
+
+  // Like a device that restarts its timeout whenever it gets serviced.
+  CoreTiming::RemoveEvent(s_timeout_events[userdata]);
+  CoreTiming::ScheduleEvent(100000, s_timeout_events[userdata], userdata);
+
+  CoreTiming::ScheduleEvent(200 + 97 * userdata - lateness, s_periodic_events[userdata], userdata);
+}
+
+static void TimeoutCallback(u64 userdata, s64 lateness)
+{
+  ADD_FAILURE() << "Timeout " << userdata << " should always have been removed";
+}
+}  // namespace SchedulingThroughputTest
+
+// Not a correctness test as such: this keeps a few dozen periodic events and timeouts in the
+// queue, roughly like the hardware of a running game does, and reports how long it took.
+TEST(CoreTiming, SchedulingThroughput)
+{
+  using namespace SchedulingThroughputTest;
+
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  for (size_t i = 0; i < NUM_DEVICES; ++i)
+  {
+    s_periodic_events[i] =
+        CoreTiming::RegisterEvent("periodic" + std::to_string(i), PeriodicCallback);
+    s_timeout_events[i] = CoreTiming::RegisterEvent("timeout" + std::to_string(i), TimeoutCallback);
+  }
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  for (size_t i = 0; i < NUM_DEVICES; ++i)
+    CoreTiming::ScheduleEvent(10 * (i + 1), s_periodic_events[i], i);
+
+  constexpr int NUM_ADVANCES = 500000;
+  s_callback_count = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < NUM_ADVANCES; ++i)
+  {
+    PowerPC::ppcState.downcount = 0;
+    CoreTiming::Advance();
+  }
+  const auto duration = std::chrono::steady_clock::now() - start;
+
+  EXPECT_GE(s_callback_count, static_cast<u64>(NUM_ADVANCES));
+
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+  fmt::print("{} advances, {} events in {} ms ({:.1f} ns per event)\n", NUM_ADVANCES,
+             s_callback_count, ns / 1000000, static_cast<double>(ns) / s_callback_count);
+}
@@ -0,0 +1,137 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "Core/State.h"
+
+namespace
+{
+// Stands in for the emulated machine: memory that the chain tracks page by page, and a register
+// that is part of the rest of the state.
+struct Machine
+{
+  // Four full pages and a short one at the end, like a region whose size isn't page aligned.
+  std::vector<u8> memory = std::vector<u8>(4 * 4096 + 1000);
+  u32 reg = 0;
+
+  std::vector<State::DeltaChain::Page> GetPages()
+  {
+    std::vector<State::DeltaChain::Page> pages;
+    for (u32 offset = 0; offset < memory.size(); offset += 4096)
+    {
+      pages.push_back({memory.data() + offset,
+                       std::min<u32>(4096, static_cast<u32>(memory.size()) - offset)});
+    }
+    return pages;
+  }
+
+  State::DeltaChain::DoStateFunction GetDoState()
+  {
+    return [this](PointerWrap& p, bool include_ram) {
+      if (include_ram)
+        p.DoArray(memory.data(), static_cast<u32>(memory.size()));
+      p.Do(reg);
+    };
+  }
+};
+
+class DeltaChainTest : public testing::Test
+{
+protected:
+  void SetUp() override { State::Init(); }
+  void TearDown() override { State::Shutdown(); }
+};
+}  // namespace
+
+TEST_F(DeltaChainTest, SaveLoadRoundTrip)
+{
+  Machine machine;
+  State::DeltaChain chain;
+
+  std::vector<std::vector<u8>> memory_snapshots;
+  std::vector<u32> reg_snapshots;
+  for (u32 i = 0; i < 4; ++i)
+  {
+    machine.memory[i * 4096 + 100] = static_cast<u8>(i + 1);
+    machine.memory.back() = static_cast<u8>(i + 0x80);
+    machine.reg = i * 1000;
+
+    ASSERT_TRUE(chain.Save(machine.GetPages(), machine.GetDoState()));
+    memory_snapshots.push_back(machine.memory);
+    reg_snapshots.push_back(machine.reg);
+  }
+
+  ASSERT_EQ(4u, chain.GetStateCount());
+  // Each delta only changed one full page and the short one.
+  for (const std::vector<u8>& delta : chain.deltas)
+    EXPECT_LT(delta.size(), 4096u + 1000u + 256u);
+
+  for (size_t i = 4; i-- > 0;)
+  {
+    machine.memory.assign(machine.memory.size(), 0xff);
+    machine.reg = 0xffffffff;
+
+    ASSERT_TRUE(chain.Load(i, machine.GetPages(), machine.GetDoState()));
+    EXPECT_EQ(memory_snapshots[i], machine.memory);
+    EXPECT_EQ(reg_snapshots[i], machine.reg);
+    EXPECT_EQ(i + 1, chain.GetStateCount());
+  }
+}
+
+TEST_F(DeltaChainTest, SaveContinuesFromLoadedState)
+{
+  Machine machine;
+  State::DeltaChain chain;
+
+  ASSERT_TRUE(chain.Save(machine.GetPages(), machine.GetDoState()));
+  machine.memory[0] = 1;
+  ASSERT_TRUE(chain.Save(machine.GetPages(), machine.GetDoState()));
+  machine.memory[4096] = 2;
+  ASSERT_TRUE(chain.Save(machine.GetPages(), machine.GetDoState()));
+
+  // Going back to the first delta drops the second one.
+  ASSERT_TRUE(chain.Load(1, machine.GetPages(), machine.GetDoState()));
+  EXPECT_EQ(2u, chain.GetStateCount());
+  EXPECT_EQ(0, machine.memory[4096]);
+
+  // This page now differs from the loaded state but matches the dropped one, so it only ends up
+  // in the next delta if the page hashes were updated by loading.
+  machine.memory[4096] = 2;
+  ASSERT_TRUE(chain.Save(machine.GetPages(), machine.GetDoState()));
+  const std::vector<u8> expected = machine.memory;
+
+  machine.memory.assign(machine.memory.size(), 0);
+  ASSERT_TRUE(chain.Load(2, machine.GetPages(), machine.GetDoState()));
+  EXPECT_EQ(expected, machine.memory);
+}
+
+TEST_F(DeltaChainTest, ChangedLayoutStartsNewChain)
+{
+  Machine machine;
+  State::DeltaChain chain;
+
+  ASSERT_TRUE(chain.Save(machine.GetPages(), machine.GetDoState()));
+  ASSERT_TRUE(chain.Save(machine.GetPages(), machine.GetDoState()));
+  EXPECT_EQ(2u, chain.GetStateCount());
+
+  machine.memory.resize(machine.memory.size() + 4096);
+  ASSERT_TRUE(chain.Save(machine.GetPages(), machine.GetDoState()));
+  EXPECT_EQ(1u, chain.GetStateCount());
+  EXPECT_TRUE(chain.deltas.empty());
+}
+
+TEST_F(DeltaChainTest, LoadOutOfRange)
+{
+  Machine machine;
+  State::DeltaChain chain;
+
+  EXPECT_FALSE(chain.Load(0, machine.GetPages(), machine.GetDoState()));
+  ASSERT_TRUE(chain.Save(machine.GetPages(), machine.GetDoState()));
+  EXPECT_FALSE(chain.Load(1, machine.GetPages(), machine.GetDoState()));
+}
@@ -0,0 +1,154 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/FifoPlayer/FifoDataFile.h"
+#include "UICommon/UICommon.h"
+
+class FifoDataFileTest : public testing::Test
+{
+protected:
+  FifoDataFileTest() : m_profile_path{File::CreateTempDir()}
+  {
+    if (!m_profile_path.empty())
+      UICommon::SetUserDirectory(m_profile_path);
+  }
+
+  ~FifoDataFileTest() override
+  {
+    if (!m_profile_path.empty())
+      File::DeleteDirRecursively(m_profile_path);
+  }
+
+  void SetUp() override { ASSERT_FALSE(m_profile_path.empty()); }
+
+  std::string m_profile_path;
+};
+
+static std::vector<FifoFrameInfo> RandomFrames(u32 count)
+{
+  std::mt19937 rng(1234);
+  std::vector<FifoFrameInfo> frames(count);
+  for (FifoFrameInfo& frame : frames)
+  {
+    // Repetitive data, like real FIFO data, so that it actually gets compressed.
+    frame.fifoData.resize(rng() % 0x10000);
+    for (u8& byte : frame.fifoData)
+      byte = static_cast<u8>(rng() % 4);
+    frame.fifoStart = rng();
+    frame.fifoEnd = rng();
+
+    frame.memoryUpdates.resize(rng() % 16);
+    u32 position = 0;
+    for (MemoryUpdate& update : frame.memoryUpdates)
+    {
+      position += rng() % 0x1000;
+      update.fifoPosition = position;
+      update.address = rng();
+      update.type = MemoryUpdate::TEXTURE_MAP;
+      update.data.resize(rng() % 0x1000);
+      for (u8& byte : update.data)
+        byte = static_cast<u8>(rng());
+    }
+  }
+  return frames;
+}
+
+static void ExpectSameFrame(const FifoFrameInfo& expected, const FifoFrameInfo& actual)
+{
+  EXPECT_EQ(expected.fifoData, actual.fifoData);
+  EXPECT_EQ(expected.fifoStart, actual.fifoStart);
+  EXPECT_EQ(expected.fifoEnd, actual.fifoEnd);
+  ASSERT_EQ(expected.memoryUpdates.size(), actual.memoryUpdates.size());
+  for (size_t i = 0; i < expected.memoryUpdates.size(); ++i)
+  {
+    EXPECT_EQ(expected.memoryUpdates[i].fifoPosition, actual.memoryUpdates[i].fifoPosition);
+    EXPECT_EQ(expected.memoryUpdates[i].address, actual.memoryUpdates[i].address);
+    EXPECT_EQ(expected.memoryUpdates[i].type, actual.memoryUpdates[i].type);
+    EXPECT_EQ(expected.memoryUpdates[i].data, actual.memoryUpdates[i].data);
+  }
+}
+
+TEST_F(FifoDataFileTest, SaveAndLoad)
+{
+  const std::vector<FifoFrameInfo> frames = RandomFrames(40);
+  const std::string path = m_profile_path + "/test.dff";
+
+  {
+    FifoDataFile recording;
+    recording.GetBPMem()[1] = 0x12345678;
+    recording.GetTexMem()[2] = 0x9a;
+    for (const FifoFrameInfo& frame : frames)
+      ASSERT_TRUE(recording.AddFrame(frame));
+
+    ASSERT_EQ(frames.size(), recording.GetFrameCount());
+    ExpectSameFrame(frames[3], *recording.GetFrame(3));
+
+    u64 fifo_bytes = 0;
+    u64 mem_bytes = 0;
+    for (const FifoFrameInfo& frame : frames)
+    {
+      fifo_bytes += frame.fifoData.size();
+      for (const MemoryUpdate& update : frame.memoryUpdates)
+        mem_bytes += update.data.size();
+    }
+    EXPECT_EQ(fifo_bytes, recording.GetFifoDataSize());
+    EXPECT_EQ(mem_bytes, recording.GetMemoryUpdateDataSize());
+
+    ASSERT_TRUE(recording.Save(path));
+  }
+
+  const std::unique_ptr<FifoDataFile> loaded = FifoDataFile::Load(path, false);
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_EQ(0x12345678u, loaded->GetBPMem()[1]);
+  EXPECT_EQ(0x9a, loaded->GetTexMem()[2]);
+  ASSERT_EQ(frames.size(), loaded->GetFrameCount());
+
+  // In order, which reads ahead, and then jumping around, which doesn't hit the cache much.
+  for (u32 i = 0; i < frames.size(); ++i)
+    ExpectSameFrame(frames[i], *loaded->GetFrame(i));
+  for (u32 i = 0; i < frames.size(); ++i)
+  {
+    const u32 frame = (i * 17) % frames.size();
+    ExpectSameFrame(frames[frame], *loaded->GetFrame(frame));
+  }
+
+  // Saving a loaded file copies the compressed frames.
+  const std::string copy_path = m_profile_path + "/copy.dff";
+  ASSERT_TRUE(loaded->Save(copy_path));
+  const std::unique_ptr<FifoDataFile> copy = FifoDataFile::Load(copy_path, false);
+  ASSERT_NE(nullptr, copy);
+  ASSERT_EQ(frames.size(), copy->GetFrameCount());
+  for (u32 i = 0; i < frames.size(); ++i)
+    ExpectSameFrame(frames[i], *copy->GetFrame(i));
+}
+
+// Recordings that are made at the same time keep their frames apart.
+TEST_F(FifoDataFileTest, ConcurrentRecordings)
+{
+  const std::vector<FifoFrameInfo> frames = RandomFrames(8);
+
+  FifoDataFile first;
+  FifoDataFile second;
+  for (size_t i = 0; i < frames.size(); ++i)
+  {
+    ASSERT_TRUE(first.AddFrame(frames[i]));
+    ASSERT_TRUE(second.AddFrame(frames[frames.size() - 1 - i]));
+  }
+
+  ASSERT_EQ(frames.size(), first.GetFrameCount());
+  ASSERT_EQ(frames.size(), second.GetFrameCount());
+  for (u32 i = 0; i < frames.size(); ++i)
+  {
+    ExpectSameFrame(frames[i], *first.GetFrame(i));
+    ExpectSameFrame(frames[frames.size() - 1 - i], *second.GetFrame(i));
+  }
+}
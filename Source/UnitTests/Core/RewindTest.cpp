@@ -0,0 +1,115 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/Rewind.h"
+#include "Core/State.h"
+
+namespace
+{
+constexpr size_t STATE_SIZE = 64 * 1024;
+
+// Random contents, so that compression can't shrink the chains much and the budget gets hit.
+State::DeltaChain MakeChain(u8 id, size_t delta_count)
+{
+  std::mt19937 rng(id);
+  const auto make_state = [&rng, id] {
+    std::vector<u8> state(STATE_SIZE);
+    for (u8& byte : state)
+      byte = static_cast<u8>(rng());
+    state[0] = id;
+    return state;
+  };
+
+  State::DeltaChain chain;
+  chain.base = make_state();
+  for (size_t i = 0; i < delta_count; ++i)
+    chain.deltas.push_back(make_state());
+  return chain;
+}
+}  // namespace
+
+TEST(RewindHistory, RoundTripThroughCompression)
+{
+  Rewind::History history(100 * STATE_SIZE);
+
+  const State::DeltaChain chain = MakeChain(1, 3);
+  history.Add(chain);
+  history.WaitForCompression();
+  EXPECT_EQ(4u, history.GetSnapshotCount());
+
+  const std::optional<State::DeltaChain> result = history.TakeNewest();
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(chain.base, result->base);
+  EXPECT_EQ(chain.deltas, result->deltas);
+
+  EXPECT_EQ(0u, history.GetSnapshotCount());
+  EXPECT_EQ(0u, history.GetMemoryUsage());
+  EXPECT_FALSE(history.TakeNewest().has_value());
+}
+
+TEST(RewindHistory, TakeBeforeCompression)
+{
+  Rewind::History history(100 * STATE_SIZE);
+
+  // Whether or not the compression thread got to the chain first, it has to come back intact.
+  const State::DeltaChain chain = MakeChain(2, 1);
+  history.Add(chain);
+
+  const std::optional<State::DeltaChain> result = history.TakeNewest();
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(chain.base, result->base);
+  EXPECT_EQ(chain.deltas, result->deltas);
+}
+
+TEST(RewindHistory, BudgetEvictsOldestChains)
+{
+  // Room for about three chains of four states each.
+  constexpr size_t BUDGET = 13 * STATE_SIZE;
+  Rewind::History history(BUDGET);
+
+  constexpr u8 CHAIN_COUNT = 10;
+  for (u8 id = 0; id < CHAIN_COUNT; ++id)
+  {
+    history.Add(MakeChain(id, 3));
+    history.WaitForCompression();
+    history.EnforceMemoryBudget();
+    EXPECT_LE(history.GetMemoryUsage(), BUDGET);
+  }
+
+  EXPECT_LT(history.GetSnapshotCount(), CHAIN_COUNT * 4u);
+  EXPECT_GT(history.GetSnapshotCount(), 0u);
+
+  // Only the oldest chains were dropped, so the ones left are the newest, in order.
+  u8 expected_id = CHAIN_COUNT;
+  while (std::optional<State::DeltaChain> chain = history.TakeNewest())
+  {
+    --expected_id;
+    EXPECT_EQ(expected_id, chain->base[0]);
+    EXPECT_EQ(MakeChain(expected_id, 3).deltas, chain->deltas);
+  }
+  EXPECT_LT(0, expected_id);
+}
+
+TEST(RewindHistory, BudgetIncludesOtherMemoryUsage)
+{
+  Rewind::History history(100 * STATE_SIZE);
+
+  history.Add(MakeChain(3, 3));
+  history.Add(MakeChain(4, 3));
+  history.EnforceMemoryBudget();
+  EXPECT_EQ(8u, history.GetSnapshotCount());
+
+  // The chain that's still being recorded counts against the budget too.
+  history.EnforceMemoryBudget(94 * STATE_SIZE);
+  EXPECT_EQ(4u, history.GetSnapshotCount());
+
+  history.EnforceMemoryBudget(100 * STATE_SIZE + 1);
+  EXPECT_EQ(0u, history.GetSnapshotCount());
+}
@@ -0,0 +1,185 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/EfbInterface.h"
+#include "VideoBackends/Software/NativeVertexFormat.h"
+#include "VideoBackends/Software/Rasterizer.h"
+#include "VideoBackends/Software/SWBoundingBox.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PerfQueryBase.h"
+#include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace
+{
+using Triangle = std::array<OutputVertexData, 3>;
+
+// Everything the rasterizer writes, so that runs with different thread counts can be compared.
+struct RasterizerOutput
+{
+  std::vector<u8> color;
+  std::vector<u8> depth;
+  std::array<u32, PQ_NUM_MEMBERS> perf_queries;
+  std::array<u16, 4> bounding_box;
+};
+
+std::vector<Triangle> RandomTriangles(size_t count)
+{
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> x_distribution(-32.0f, EFB_WIDTH + 32.0f);
+  std::uniform_real_distribution<float> y_distribution(-32.0f, EFB_HEIGHT + 32.0f);
+  std::uniform_real_distribution<float> z_distribution(0.0f, 16777215.0f);
+  std::uniform_real_distribution<float> size_distribution(2.0f, 200.0f);
+
+  std::vector<Triangle> triangles(count);
+  for (Triangle& triangle : triangles)
+  {
+    // Mostly small triangles, which stay within a few tiles, but also some that cross many.
+    const float x = x_distribution(rng);
+    const float y = y_distribution(rng);
+    const float size = size_distribution(rng) * (rng() % 8 == 0 ? 4.0f : 1.0f);
+    for (OutputVertexData& vertex : triangle)
+    {
+      vertex.screenPosition.x = x + size * (static_cast<float>(rng() % 1000) / 1000.0f - 0.5f);
+      vertex.screenPosition.y = y + size * (static_cast<float>(rng() % 1000) / 1000.0f - 0.5f);
+      vertex.screenPosition.z = z_distribution(rng);
+      vertex.projectedPosition.w = 1.0f;
+      for (u8& component : vertex.color[0])
+        component = static_cast<u8>(rng());
+    }
+
+    // The rasterizer only draws front faces, which are wound clockwise on screen.
+    const float dx1 = triangle[1].screenPosition.x - triangle[0].screenPosition.x;
+    const float dy1 = triangle[1].screenPosition.y - triangle[0].screenPosition.y;
+    const float dx2 = triangle[2].screenPosition.x - triangle[0].screenPosition.x;
+    const float dy2 = triangle[2].screenPosition.y - triangle[0].screenPosition.y;
+    if (dx1 * dy2 - dy1 * dx2 > 0.0f)
+      std::swap(triangle[1], triangle[2]);
+  }
+  return triangles;
+}
+
+void SetUpPixelPipeline()
+{
+  // BPMemory can't be assigned to, so value-initialize it in place.
+  new (&bpmem) BPMemory{};
+
+  bpmem.genMode.numcolchans = 1;
+  TevStageCombiner::ColorCombiner& cc = bpmem.combiners[0].colorC;
+  cc.a = TevColorArg::Zero;
+  cc.b = TevColorArg::Zero;
+  cc.c = TevColorArg::Zero;
+  cc.d = TevColorArg::RasColor;
+  cc.clamp = true;
+  TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[0].alphaC;
+  ac.a = TevAlphaArg::Zero;
+  ac.b = TevAlphaArg::Zero;
+  ac.c = TevAlphaArg::Zero;
+  ac.d = TevAlphaArg::RasAlpha;
+  ac.clamp = true;
+
+  bpmem.alpha_test.comp0 = CompareMode::Always;
+  bpmem.alpha_test.comp1 = CompareMode::Always;
+
+  // Depth testing and blending both depend on what was drawn to the same pixel before.
+  bpmem.zmode.testenable = true;
+  bpmem.zmode.func = CompareMode::LEqual;
+  bpmem.zmode.updateenable = true;
+  bpmem.zcontrol.pixel_format = PixelFormat::RGBA6_Z24;
+  bpmem.blendmode.blendenable = true;
+  bpmem.blendmode.dither = true;
+  bpmem.blendmode.colorupdate = true;
+  bpmem.blendmode.alphaupdate = true;
+  bpmem.blendmode.srcfactor = SrcBlendFactor::SrcAlpha;
+  bpmem.blendmode.dstfactor = DstBlendFactor::InvSrcAlpha;
+
+  // The whole EFB. The SDK adds 342 to the coordinates and offsets.
+  bpmem.scissorTL.x = 342;
+  bpmem.scissorTL.y = 342;
+  bpmem.scissorBR.x = 342 + EFB_WIDTH - 1;
+  bpmem.scissorBR.y = 342 + EFB_HEIGHT - 1;
+  bpmem.scissorOffset.x = 342 / 2;
+  bpmem.scissorOffset.y = 342 / 2;
+}
+
+RasterizerOutput Draw(int threads, const std::vector<Triangle>& triangles)
+{
+  constexpr size_t PLANE_SIZE = EFB_WIDTH * EFB_HEIGHT * 3;
+  std::memset(EfbInterface::GetPixelPointer(0, 0, false), 0, PLANE_SIZE);
+  std::memset(EfbInterface::GetPixelPointer(0, 0, true), 0xff, PLANE_SIZE);
+  EfbInterface::ResetPerfQuery();
+  BBoxManager::SetCoordinate(BBoxManager::Coordinate::Left, 0xffff);
+  BBoxManager::SetCoordinate(BBoxManager::Coordinate::Right, 0);
+  BBoxManager::SetCoordinate(BBoxManager::Coordinate::Top, 0xffff);
+  BBoxManager::SetCoordinate(BBoxManager::Coordinate::Bottom, 0);
+
+  g_ActiveConfig.iSWRasterizerThreads = threads;
+  SetUpPixelPipeline();
+  Rasterizer::Init();
+  Rasterizer::ScissorChanged();
+
+  // Batches of different sizes, some of which fill the triangle queue. In the last batch, zfreeze
+  // makes the triangles use the depth slope of the last one drawn before it was enabled.
+  size_t drawn = 0;
+  for (size_t batch = 0; drawn < triangles.size(); ++batch)
+  {
+    if (batch == 4)
+      bpmem.genMode.zfreeze = true;
+
+    const size_t end = std::min(triangles.size(), drawn + 100 + batch * 1500);
+    for (; drawn < end; ++drawn)
+    {
+      const Triangle& triangle = triangles[drawn];
+      Rasterizer::DrawTriangleFrontFace(&triangle[0], &triangle[1], &triangle[2]);
+    }
+    Rasterizer::Flush();
+  }
+
+  Rasterizer::Shutdown();
+
+  RasterizerOutput output;
+  const u8* color = EfbInterface::GetPixelPointer(0, 0, false);
+  output.color.assign(color, color + PLANE_SIZE);
+  const u8* depth = EfbInterface::GetPixelPointer(0, 0, true);
+  output.depth.assign(depth, depth + PLANE_SIZE);
+  for (u32 i = 0; i < PQ_NUM_MEMBERS; ++i)
+    output.perf_queries[i] = EfbInterface::GetPerfQueryResult(static_cast<PerfQueryType>(i));
+  for (u32 i = 0; i < output.bounding_box.size(); ++i)
+    output.bounding_box[i] = BBoxManager::GetCoordinate(static_cast<BBoxManager::Coordinate>(i));
+  return output;
+}
+}  // namespace
+
+// The software renderer is the reference for the other backends, so drawing the tiles on several
+// threads must give exactly the same result as drawing every triangle on one thread.
+TEST(SWRasterizer, ThreadCountDoesNotChangeOutput)
+{
+  const std::vector<Triangle> triangles = RandomTriangles(12000);
+  const RasterizerOutput expected = Draw(1, triangles);
+
+  // Make sure that the test draws something worth comparing.
+  const std::vector<u8> cleared(expected.color.size());
+  ASSERT_NE(cleared, expected.color);
+  ASSERT_NE(0u, expected.perf_queries[PQ_BLEND_INPUT]);
+
+  // 0 picks the thread count automatically.
+  for (int threads : {0, 2, 4, 7})
+  {
+    const RasterizerOutput actual = Draw(threads, triangles);
+    EXPECT_EQ(expected.color, actual.color) << threads << " threads";
+    EXPECT_EQ(expected.depth, actual.depth) << threads << " threads";
+    EXPECT_EQ(expected.perf_queries, actual.perf_queries) << threads << " threads";
+    EXPECT_EQ(expected.bounding_box, actual.bounding_box) << threads << " threads";
+  }
+}
@@ -0,0 +1,153 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+namespace
+{
+constexpr std::array<TextureFormat, 11> FORMATS = {
+    TextureFormat::I4,    TextureFormat::I8,     TextureFormat::IA4,    TextureFormat::IA8,
+    TextureFormat::RGB565, TextureFormat::RGB5A3, TextureFormat::RGBA8, TextureFormat::C4,
+    TextureFormat::C8,    TextureFormat::C14X2,  TextureFormat::CMPR};
+
+constexpr std::array<TLUTFormat, 3> TLUT_FORMATS = {TLUTFormat::IA8, TLUTFormat::RGB565,
+                                                    TLUTFormat::RGB5A3};
+
+bool IsPaletted(TextureFormat format)
+{
+  return format == TextureFormat::C4 || format == TextureFormat::C8 ||
+         format == TextureFormat::C14X2;
+}
+
+std::vector<u8> RandomBytes(std::mt19937& rng, size_t size)
+{
+  std::vector<u8> bytes(size);
+  for (u8& byte : bytes)
+    byte = static_cast<u8>(rng());
+  return bytes;
+}
+
+struct TestTexture
+{
+  TextureFormat format;
+  TLUTFormat tlut_format;
+  int width;
+  int height;
+};
+
+// Sizes in blocks, including odd numbers of block columns and rows, and the largest texture size.
+std::vector<TestTexture> TestTextures()
+{
+  constexpr std::array<std::array<int, 2>, 7> sizes = {
+      {{1, 1}, {2, 1}, {3, 5}, {5, 2}, {16, 16}, {33, 7}, {0, 0}}};
+
+  std::vector<TestTexture> textures;
+  for (TextureFormat format : FORMATS)
+  {
+    const int block_width = TexDecoder_GetBlockWidthInTexels(format);
+    const int block_height = TexDecoder_GetBlockHeightInTexels(format);
+    for (const auto& [blocks_x, blocks_y] : sizes)
+    {
+      const int width = blocks_x != 0 ? blocks_x * block_width : 1024;
+      const int height = blocks_y != 0 ? blocks_y * block_height : 1024;
+      if (IsPaletted(format))
+      {
+        for (TLUTFormat tlut_format : TLUT_FORMATS)
+          textures.push_back({format, tlut_format, width, height});
+      }
+      else
+      {
+        textures.push_back({format, TLUTFormat::IA8, width, height});
+      }
+    }
+  }
+  return textures;
+}
+}  // namespace
+
+using DecodeFunction = void (*)(u32* dst, const u8* src, int width, int height,
+                               TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt);
+
+// The optimized decoders must produce exactly what the reference decoders produce. Each one the CPU
+// running the test supports is called directly, not just the one it would be dispatched to.
+TEST(TextureDecoder, MatchesGeneric)
+{
+  std::vector<std::pair<const char*, DecodeFunction>> decoders{
+      {"dispatched", &_TexDecoder_DecodeImpl}};
+#ifdef _M_X86
+  decoders.emplace_back("SSE2", &_TexDecoder_DecodeImplSSE2);
+  if (cpu_info.bSSSE3)
+    decoders.emplace_back("SSSE3", &_TexDecoder_DecodeImplSSSE3);
+  if (cpu_info.bAVX2)
+    decoders.emplace_back("AVX2", &_TexDecoder_DecodeImplAVX2);
+#endif
+
+  std::mt19937 rng(1234);
+  // Large enough for any palette, which is indexed with up to 14 bits.
+  const std::vector<u8> tlut = RandomBytes(rng, 2 << 14);
+
+  for (const TestTexture& texture : TestTextures())
+  {
+    const std::vector<u8> src = RandomBytes(
+        rng, TexDecoder_GetTextureSizeInBytes(texture.width, texture.height, texture.format));
+    const size_t texels = static_cast<size_t>(texture.width) * texture.height;
+
+    std::vector<u32> expected(texels);
+    _TexDecoder_DecodeImplGeneric(expected.data(), src.data(), texture.width, texture.height,
+                                  texture.format, tlut.data(), texture.tlut_format);
+
+    for (const auto& [name, decode] : decoders)
+    {
+      std::vector<u32> actual(texels);
+      decode(actual.data(), src.data(), texture.width, texture.height, texture.format, tlut.data(),
+             texture.tlut_format);
+
+      EXPECT_EQ(expected, actual) << name << " decoder, format "
+                                  << static_cast<int>(texture.format) << ", TLUT format "
+                                  << static_cast<int>(texture.tlut_format) << ", "
+                                  << texture.width << "x" << texture.height;
+    }
+  }
+}
+
+// Decoding a texture in bands of block rows, in any order, gives the same result as decoding it
+// all at once.
+TEST(TextureDecoder, DecodeRowsInBands)
+{
+  std::mt19937 rng(5678);
+  const std::vector<u8> tlut = RandomBytes(rng, 2 << 14);
+
+  for (const TestTexture& texture : TestTextures())
+  {
+    const std::vector<u8> src = RandomBytes(
+        rng, TexDecoder_GetTextureSizeInBytes(texture.width, texture.height, texture.format));
+    const size_t size = static_cast<size_t>(texture.width) * texture.height * sizeof(u32);
+
+    std::vector<u8> expected(size);
+    TexDecoder_Decode(expected.data(), src.data(), texture.width, texture.height, texture.format,
+                      tlut.data(), texture.tlut_format);
+
+    // Three block rows per band, so that the last band is cut short for some of the sizes.
+    const int band_height = 3 * TexDecoder_GetBlockHeightInTexels(texture.format);
+    std::vector<u8> actual(size);
+    for (int row = (texture.height - 1) / band_height * band_height; row >= 0; row -= band_height)
+    {
+      TexDecoder_DecodeRows(actual.data(), src.data(), texture.width, texture.height, row,
+                            band_height, texture.format, tlut.data(), texture.tlut_format);
+    }
+    TexDecoder_FinishDecode(actual.data(), texture.width, texture.height, texture.format);
+
+    EXPECT_EQ(expected, actual) << "format " << static_cast<int>(texture.format) << ", TLUT format "
+                                << static_cast<int>(texture.tlut_format) << ", " << texture.width
+                                << "x" << texture.height;
+  }
+}
@@ -3,9 +3,11 @@
 
 #include <limits>
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 #include <gtest/gtest.h>  // NOLINT
 
@@ -14,6 +16,7 @@
 #include "Common/MathUtil.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/DisplayListVertexCache.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
@@ -255,6 +258,55 @@ TEST_F(VertexLoaderTest, PositionIndex16FloatXY)
   ExpectOut(2);
 }
 
+TEST_F(VertexLoaderTest, DisplayListVertexCache)
+{
+  m_vtx_desc.low.Position = VertexComponentFormat::Index8;
+  m_vtx_attr.g0.PosFormat = ComponentFormat::Float;
+  m_vtx_attr.g0.PosElements = CoordComponentCount::XYZ;
+  CreateAndCheckSizes(sizeof(u8), 3 * sizeof(float));
+
+  // Index 0xff skips a vertex.
+  Input<u8>(2);
+  Input<u8>(0xff);
+  Input<u8>(1);
+  u8* const array = m_src.GetPointer();
+  VertexLoaderManager::cached_arraybases[CPArray::Position] = array;
+  g_main_cp_state.array_bases[CPArray::Position] = 0x1000;
+  g_main_cp_state.array_strides[CPArray::Position] = 3 * sizeof(float);
+  for (int i = 0; i < 12; i++)
+    Input(static_cast<float>(i));
+
+  constexpr u32 ADDRESS = 0x80;
+  DisplayListVertexCache cache;
+  std::vector<u8> cached(3 * 3 * sizeof(float));
+  EXPECT_EQ(std::nullopt, cache.Load(ADDRESS, m_loader.get(), input_memory, 3, cached.data()));
+
+  RunVertices(3, 2);
+  cache.Store(ADDRESS, m_loader.get(), m_vtx_desc, m_vtx_attr, input_memory, 3, output_memory, 2);
+  EXPECT_EQ(2, cache.Load(ADDRESS, m_loader.get(), input_memory, 3, cached.data()));
+  EXPECT_EQ(0, memcmp(output_memory, cached.data(), 2 * 3 * sizeof(float)));
+
+  // Only the same vertices at the same address hit.
+  EXPECT_EQ(std::nullopt, cache.Load(ADDRESS + 3, m_loader.get(), input_memory, 3, cached.data()));
+  EXPECT_EQ(std::nullopt, cache.Load(ADDRESS, m_loader.get(), input_memory, 2, cached.data()));
+  input_memory[0] = 0;
+  EXPECT_EQ(std::nullopt, cache.Load(ADDRESS, m_loader.get(), input_memory, 3, cached.data()));
+  input_memory[0] = 2;
+
+  // Array elements that no vertex uses can change, ones that are used can't.
+  array[0] = 0xff;
+  EXPECT_EQ(2, cache.Load(ADDRESS, m_loader.get(), input_memory, 3, cached.data()));
+  array[3 * 3 * sizeof(float)] = 0xff;
+  EXPECT_EQ(2, cache.Load(ADDRESS, m_loader.get(), input_memory, 3, cached.data()));
+  array[2 * 3 * sizeof(float) + 11] = 0xff;
+  EXPECT_EQ(std::nullopt, cache.Load(ADDRESS, m_loader.get(), input_memory, 3, cached.data()));
+
+  // Nor can the place of the array.
+  array[2 * 3 * sizeof(float) + 11] = 0;
+  g_main_cp_state.array_bases[CPArray::Position] = 0x2000;
+  EXPECT_EQ(std::nullopt, cache.Load(ADDRESS, m_loader.get(), input_memory, 3, cached.data()));
+}
+
 class VertexLoaderSpeedTest : public VertexLoaderTest,
                               public ::testing::WithParamInterface<std::tuple<ComponentFormat, int>>
 {